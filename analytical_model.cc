@@ -0,0 +1,388 @@
+/*
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ *
+ * Copyright (c) 2026 ARM Limited
+ * All rights reserved
+ *  Created on: Oct 18, 2026
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <sstream>
+#include "analytical_model.hh"
+#include "logger.hh"
+#include "random_generator.hh"
+#include "types.hh"
+#include "utilities.hh"
+
+namespace TrafficProfiles {
+
+namespace {
+const double infinity = numeric_limits<double>::infinity();
+}
+
+AnalyticalModel::Estimate::Estimate():
+        bandwidth(0), latency(0), start(infinity), finish(infinity),
+        bound(NONE), estimated(true) {
+}
+
+AnalyticalModel::AnalyticalModel(const double f): frequency(f) {
+}
+
+void AnalyticalModel::addSlave(const uint64_t id, const double rate,
+                               const double latency, const uint64_t ot,
+                               const uint64_t granularity) {
+    Slave s { 0, latency, granularity };
+    // an OT limit of 0 leaves the slave unbounded, otherwise each
+    // accepted request holds its granules for the response latency
+    if (ot > 0) {
+        s.capacity = rate;
+        if (latency > 0) {
+            const double window = (double)ot * granularity / latency;
+            s.capacity = (rate > 0 ? min(rate, window) : window);
+        }
+    }
+    slaves[id] = s;
+    LOG("AnalyticalModel::addSlave", id, "capacity", s.capacity,
+        "latency", s.latency, "granularity", s.granularity);
+}
+
+void AnalyticalModel::addProfile(const Profile& p, const string& name,
+                                 const string& master, const uint64_t slave,
+                                 const double rate) {
+    Node n { name, "", slave, rate, 0, infinity, infinity, infinity, {},
+             false };
+
+    for (int i = 0; i < p.wait_for_size(); ++i) {
+        Event::Type type = Event::NONE;
+        string awaited;
+        Event::parse(type, awaited, p.wait_for(i));
+        n.waits.emplace_back(awaited, type);
+        n.sequenced |= (Event::category[type] == Event::SEND_STATUS);
+    }
+
+    auto time = [this](const string& t) {
+        const double hz = Utilities::timeToHz<double>(t);
+        return (hz > 0 ? frequency / hz : 0);
+    };
+
+    if (p.has_pattern() && p.has_fifo()) {
+        const PatternConfiguration& pattern = p.pattern();
+        const FifoConfiguration& fifo = p.fifo();
+        n.master = master;
+        if (pattern.has_size() || pattern.has_txnsize()) {
+            n.size = (pattern.has_size() ? pattern.size() : pattern.txnsize());
+        } else if (pattern.has_random_size()) {
+            Random::Generator g;
+            g.init(pattern.random_size());
+            n.size = g.mean();
+        } else {
+            n.size = 64;
+        }
+        // outstanding requests are bound by the OT limit, 0 if unbounded,
+        // and by the FIFO room for requested data, 0 if unbounded
+        const uint64_t ot = (fifo.has_ot_limit() ? fifo.ot_limit() :
+                             fifo.has_txnlimit() ? fifo.txnlimit() : 1);
+        const uint64_t full = (fifo.has_full_level() ? fifo.full_level() :
+                               fifo.full());
+        if (ot > 0) {
+            n.window = ot;
+        }
+        if (full > 0 && n.size > 0) {
+            n.window = min(n.window, max(1.0, floor(full / n.size)));
+        }
+        if (fifo.has_total_txn() && fifo.total_txn() > 0) {
+            n.data = fifo.total_txn() * n.size;
+        } else if (fifo.has_framesize()) {
+            n.data = floor(Utilities::toBytes<double>(fifo.framesize()) /
+                           n.size) * n.size;
+        } else if (fifo.has_frametime()) {
+            n.duration = time(fifo.frametime());
+        }
+    } else if (p.has_delay()) {
+        n.duration = time(p.delay().time());
+    } else {
+        return;
+    }
+
+    index[name] = nodes.size();
+    nodes.push_back(n);
+    LOG("AnalyticalModel::addProfile", name, "master", master, "rate",
+        n.rate, "size", n.size, "window", n.window, "data", n.data,
+        "duration", n.duration);
+}
+
+bool AnalyticalModel::ready(const Node& n, const vector<State>& states,
+                            const double t) const {
+    for (auto& w : n.waits) {
+        auto it = index.find(w.first);
+        if (it == index.end()) {
+            return false;
+        }
+        const State& s = states[it->second];
+        const double at = (w.second == Event::TERMINATION ? s.finish :
+                           s.start);
+        if (at < 0 || at > t) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void AnalyticalModel::share(const vector<uint64_t>& active,
+                            vector<State>& states, const Slave* s) const {
+    const double latency = (s != nullptr ? s->latency : 0);
+    const double capacity = (s != nullptr ? s->capacity : 0);
+
+    // requested bytes per transferred byte, as rounded to the granularity
+    auto overhead = [&](const Node& n) {
+        if (s == nullptr || s->granularity == 0 || n.size <= 0) {
+            return 1.0;
+        }
+        return ceil(n.size / s->granularity) * s->granularity / n.size;
+    };
+    // throughput a profile would achieve given the response latency
+    auto demand = [&](const Node& n, const double r) {
+        const double rate = (n.rate > 0 ? n.rate : infinity);
+        const double window = (r > 0 ? n.window * n.size / r : infinity);
+        return min(rate, window);
+    };
+    auto total = [&](const double r) {
+        double d = 0;
+        for (auto i : active) {
+            d += demand(nodes[i], r) * overhead(nodes[i]);
+        }
+        return d;
+    };
+
+    double r = latency;
+    bool saturated = (capacity > 0 && total(r) > capacity);
+    double scale = 1;
+    if (saturated) {
+        // Little's law: the latency grows until the outstanding windows
+        // fit the slave capacity, unless rate bound profiles alone
+        // overload it, in which case the demands are scaled down
+        double open = 0;
+        for (auto i : active) {
+            if (!isfinite(nodes[i].window)) {
+                open += demand(nodes[i], infinity) * overhead(nodes[i]);
+            }
+        }
+        if (open >= capacity) {
+            scale = capacity / total(r);
+        } else {
+            double lo = max(r, numeric_limits<double>::min());
+            double hi = lo;
+            while (total(hi) > capacity) {
+                lo = hi;
+                hi *= 2;
+            }
+            for (int k = 0; k < 64 && hi - lo > hi * 1e-12; ++k) {
+                const double mid = (lo + hi) / 2;
+                (total(mid) > capacity ? lo : hi) = mid;
+            }
+            r = hi;
+        }
+    }
+
+    for (auto i : active) {
+        const Node& n = nodes[i];
+        State& st = states[i];
+        st.throughput = demand(n, r) * scale;
+        st.latency = r;
+        st.bound = (saturated ? SLAVE :
+                    n.rate > 0 && (r <= 0 || n.rate <= n.window * n.size / r) ?
+                    RATE : OUTSTANDING);
+    }
+}
+
+map<string, AnalyticalModel::Estimate> AnalyticalModel::estimate() const {
+    vector<State> states(nodes.size());
+    for (uint64_t i = 0; i < nodes.size(); ++i) {
+        State& s = states[i];
+        s.start = s.issued = s.finish = -1;
+        s.remaining = nodes[i].data;
+        s.throughput = s.latency = 0;
+        s.bound = NONE;
+        s.moved = s.latencyData = 0;
+        s.dominant = make_pair(0.0, NONE);
+    }
+
+    auto issuing = [&](const uint64_t i) {
+        return !nodes[i].master.empty() && states[i].start >= 0 &&
+               states[i].issued < 0;
+    };
+    auto stopIssuing = [&](const uint64_t i, const double t) {
+        State& s = states[i];
+        s.issued = t;
+        s.finish = t + s.latency;
+    };
+
+    double t = 0;
+    bool open = false;
+    // each phase starts or terminates at least a profile
+    for (uint64_t phase = 0; phase <= 3 * nodes.size(); ++phase) {
+        // start the profiles whose awaited events occurred,
+        // which may in turn activate others
+        for (bool started = true; started;) {
+            started = false;
+            for (uint64_t i = 0; i < nodes.size(); ++i) {
+                if (states[i].start < 0 && ready(nodes[i], states, t)) {
+                    states[i].start = t;
+                    started = true;
+                    if (nodes[i].master.empty() && nodes[i].duration <= 0) {
+                        states[i].finish = t;
+                    }
+                }
+            }
+        }
+
+        // share the slaves among the issuing profiles
+        map<uint64_t, vector<uint64_t>> groups;
+        for (uint64_t i = 0; i < nodes.size(); ++i) {
+            if (issuing(i)) {
+                groups[nodes[i].slave].push_back(i);
+            }
+        }
+        for (auto& g : groups) {
+            auto s = slaves.find(g.first);
+            share(g.second, states,
+                  (s != slaves.end() ? &s->second : nullptr));
+        }
+
+        // next profile termination
+        double next = infinity;
+        for (uint64_t i = 0; i < nodes.size(); ++i) {
+            const State& s = states[i];
+            if (s.start < 0) {
+                continue;
+            }
+            if (issuing(i)) {
+                const double rate = s.throughput;
+                next = min(next, (rate > 0 ? t + s.remaining / rate :
+                                  infinity));
+                next = min(next, s.start + nodes[i].duration);
+            } else if (nodes[i].master.empty() && s.finish < 0) {
+                next = min(next, s.start + nodes[i].duration);
+            } else if (s.finish > t) {
+                next = min(next, s.finish);
+            }
+        }
+        if (!isfinite(next)) {
+            open = true;
+            break;
+        }
+
+        // move the data of the phase
+        const double dt = next - t;
+        for (uint64_t i = 0; i < nodes.size(); ++i) {
+            if (!issuing(i)) {
+                continue;
+            }
+            State& s = states[i];
+            const double moved = (dt > 0 ? min(s.remaining,
+                                               s.throughput * dt) :
+                                  s.remaining);
+            s.remaining -= moved;
+            s.moved += moved;
+            s.latencyData += moved * s.latency;
+            if (moved > s.dominant.first) {
+                s.dominant = make_pair(moved, s.bound);
+            }
+            if (s.remaining <= nodes[i].data * 1e-12 ||
+                next >= s.start + nodes[i].duration) {
+                stopIssuing(i, next);
+            }
+        }
+        t = next;
+        for (uint64_t i = 0; i < nodes.size(); ++i) {
+            State& s = states[i];
+            if (nodes[i].master.empty() && s.start >= 0 && s.finish < 0 &&
+                t >= s.start + nodes[i].duration) {
+                s.finish = t;
+            }
+        }
+    }
+
+    // aggregate the profiles per master: open-ended masters
+    // achieve their last phase throughput
+    struct Totals { double moved, latencyData, rate, rateLatency, best;
+                    bool open; Estimate e; };
+    map<string, Totals> totals;
+    for (uint64_t i = 0; i < nodes.size(); ++i) {
+        const Node& n = nodes[i];
+        if (n.master.empty()) {
+            continue;
+        }
+        Totals& m = totals.emplace(n.master,
+                Totals { 0, 0, 0, 0, -1, false, Estimate() }).first->second;
+        m.e.estimated &= !n.sequenced;
+        const State& s = states[i];
+        if (s.start < 0) {
+            continue;
+        }
+        m.e.start = min(m.e.start, s.start / frequency);
+        m.moved += s.moved;
+        m.latencyData += s.latencyData;
+        if (open && issuing(i)) {
+            m.open = true;
+            m.rate += s.throughput;
+            m.rateLatency += s.throughput * s.latency;
+            m.e.bound = s.bound;
+            m.best = infinity;
+        } else {
+            m.e.finish = (isfinite(m.e.finish) ?
+                          max(m.e.finish, s.finish / frequency) :
+                          s.finish / frequency);
+            if (s.dominant.first > m.best) {
+                m.best = s.dominant.first;
+                m.e.bound = s.dominant.second;
+            }
+        }
+    }
+
+    map<string, Estimate> ret;
+    for (auto& it : totals) {
+        Totals& m = it.second;
+        Estimate& e = m.e;
+        if (m.open) {
+            e.finish = infinity;
+            e.bandwidth = m.rate * frequency;
+            e.latency = (m.rate > 0 ? m.rateLatency / m.rate : 0) / frequency;
+        } else if (isfinite(e.start)) {
+            e.bandwidth = (e.finish > e.start ?
+                           m.moved / (e.finish - e.start) : 0);
+            e.latency = (m.moved > 0 ? m.latencyData / m.moved : 0) /
+                        frequency;
+        }
+        ret[it.first] = e;
+    }
+    return ret;
+}
+
+const string AnalyticalModel::dump(const map<string, Estimate>& estimates) {
+    static const char* bounds[] = { "none", "rate", "OT", "slave" };
+    stringstream ss;
+    for (auto& it : estimates) {
+        const Estimate& e = it.second;
+        ss << it.first << " ";
+        if (!e.estimated) {
+            ss << "not estimated: sequenced by lock events" << endl;
+            continue;
+        }
+        if (!isfinite(e.start)) {
+            ss << "never starts" << endl;
+            continue;
+        }
+        ss << "bandwidth: " << Utilities::toByteString(e.bandwidth) << "ps"
+           << " avg latency: " << Utilities::toTimeString(e.latency)
+           << " start: " << Utilities::toTimeString(e.start)
+           << " finish: " << (isfinite(e.finish) ?
+                              Utilities::toTimeString(e.finish) : "never")
+           << " bound by: " << bounds[e.bound] << endl;
+    }
+    return ss.str();
+}
+
+} // end of namespace
@@ -0,0 +1,213 @@
+/*
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ *
+ * Copyright (c) 2026 ARM Limited
+ * All rights reserved
+ *  Created on: Oct 18, 2026
+ */
+
+#ifndef __AMBA_TRAFFIC_PROFILE_ANALYTICAL_MODEL_HH__
+#define __AMBA_TRAFFIC_PROFILE_ANALYTICAL_MODEL_HH__
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "event.hh"
+#include "proto/tp_config.pb.h"
+
+using namespace std;
+
+namespace TrafficProfiles {
+
+/*!
+ *\brief ATP Engine analytical performance model
+ *
+ * Estimates the bandwidth and average latency each ATP Master achieves
+ * without simulating its packets. Each Master profile moves data at the
+ * lowest of its FIFO rate and of its outstanding window (the OT limit,
+ * further bounded by the FIFO full level) over the response latency,
+ * as by Little's law. Profiles sharing a slave are bound by the slave
+ * capacity (its rate, or its OT limit over its latency): a saturated
+ * slave queues the requests until the common response latency brings
+ * the aggregate demand down to its capacity.
+ *
+ * The profile graph is evaluated as a fluid model: the throughputs are
+ * constant between profiles starts and terminations, which follow the
+ * wait_for dependencies. Termination events resolve when the awaited
+ * profile completes, any other event as soon as it starts. Profiles
+ * sequenced by the awaited profile lock events alternate with it packet
+ * by packet, which the fluid model doesn't capture: their masters are
+ * reported as not estimated.
+ *
+ * Times are expressed in ATP time units, rates in bytes per ATP time
+ * unit, with 0 standing for unbounded.
+ */
+class AnalyticalModel {
+
+public:
+
+    //! Factor limiting the throughput of a master
+    enum Bound { NONE, RATE, OUTSTANDING, SLAVE };
+
+    //! Estimated performance of an ATP Master
+    struct Estimate {
+        //! bandwidth, in bytes per second
+        double bandwidth;
+        //! average request to response latency, in seconds
+        double latency;
+        //! time the master starts, in seconds
+        double start;
+        //! time the master completes, in seconds, infinite if it never does
+        double finish;
+        //! factor limiting the master throughput
+        Bound bound;
+        //! false if the master is sequenced by lock events
+        bool estimated;
+
+        //! Default constructor
+        Estimate();
+    };
+
+    //! Modelled slave
+    struct Slave {
+        //! capacity, in requested bytes per ATP time unit
+        double capacity;
+        //! average response latency
+        double latency;
+        //! request granularity, in bytes
+        uint64_t granularity;
+    };
+
+    //! Modelled traffic profile
+    struct Node {
+        //! profile name
+        string name;
+        //! master name, empty for profiles not issuing requests
+        string master;
+        //! slave ID, invalid if unassigned
+        uint64_t slave;
+        //! FIFO rate
+        double rate;
+        //! average packet size, in bytes
+        double size;
+        //! outstanding window, in packets
+        double window;
+        //! data to transfer, in bytes
+        double data;
+        //! time limit since the profile start
+        double duration;
+        //! awaited profiles and events
+        vector<pair<string, Event::Type>> waits;
+        //! whether the profile awaits lock events
+        bool sequenced;
+    };
+
+protected:
+
+    //! ATP time units per second
+    const double frequency;
+
+    //! slaves, indexed by ID
+    unordered_map<uint64_t, Slave> slaves;
+
+    //! profiles, in configuration order
+    vector<Node> nodes;
+
+    //! profile name -> node index
+    unordered_map<string, uint64_t> index;
+
+    //! Profile evaluation state
+    struct State {
+        //! start time, negative until started
+        double start;
+        //! time requests end, negative until known
+        double issued;
+        //! termination time, negative until terminated
+        double finish;
+        //! bytes still to request
+        double remaining;
+        //! current throughput
+        double throughput;
+        //! current response latency
+        double latency;
+        //! current bound
+        Bound bound;
+        //! bytes requested
+        double moved;
+        //! latency weighted by the bytes requested
+        double latencyData;
+        //! largest bytes requested within a phase, with its bound
+        pair<double, Bound> dominant;
+    };
+
+    /*!
+     * Computes the throughput of the profiles sharing a slave
+     *\param active indices of the active profiles of the slave
+     *\param states the profiles states
+     *\param s the slave, or nullptr for unassigned profiles
+     */
+    void share(const vector<uint64_t>&, vector<State>&,
+               const Slave*) const;
+
+    /*!
+     * Checks whether a profile awaited events have all occurred
+     *\param n the node
+     *\param states the profiles states
+     *\param t the current time
+     *\return true if the profile can start
+     */
+    bool ready(const Node&, const vector<State>&, const double) const;
+
+public:
+
+    /*!
+     * Constructor
+     *\param f ATP time units per second
+     */
+    AnalyticalModel(const double);
+
+    //! Default destructor
+    virtual ~AnalyticalModel() = default;
+
+    /*!
+     * Adds a slave
+     *\param id slave ID
+     *\param rate the slave rate, 0 if unbounded
+     *\param latency the slave average latency
+     *\param ot the slave OT limit, 0 if unbounded
+     *\param granularity the slave request granularity, in bytes
+     */
+    void addSlave(const uint64_t, const double, const double,
+                  const uint64_t, const uint64_t);
+
+    /*!
+     * Adds a profile
+     *\param p the profile configuration
+     *\param name the profile name
+     *\param master the master name
+     *\param slave the slave ID, invalid if unassigned
+     *\param rate the FIFO rate, 0 if unbounded
+     */
+    void addProfile(const Profile&, const string&, const string&,
+                    const uint64_t, const double);
+
+    /*!
+     * Evaluates the profile graph
+     *\return master name -> estimated performance
+     */
+    map<string, Estimate> estimate() const;
+
+    /*!
+     * Dumps estimates
+     *\param e the estimates
+     *\return a formatted string with one line per master
+     */
+    static const string dump(const map<string, Estimate>&);
+};
+
+} // end of namespace
+
+#endif /* __AMBA_TRAFFIC_PROFILE_ANALYTICAL_MODEL_HH__ */
@@ -0,0 +1,455 @@
+/*
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ *
+ * Copyright (c) 2026 ARM Limited
+ * All rights reserved
+ *  Created on: Oct 18, 2026
+ */
+
+// standard library includes
+#include <getopt.h>
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <list>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// ATP includes
+#include "event.hh"
+#include "fifo.hh"
+#include "kronos.hh"
+#include "logger.hh"
+#include "packet_desc.hh"
+#include "packet_tagger.hh"
+#include "traffic_profile_manager.hh"
+#include "utilities.hh"
+
+using namespace TrafficProfiles;
+using namespace std;
+
+/*
+ * ATP Engine micro-benchmarks
+ *
+ * Each benchmark measures one engine hot path and
+ * reports the average wall-clock cost of one operation.
+ * Benchmarks are repeated and the fastest repetition is
+ * reported together with the mean, either as a console
+ * table or in a machine-readable format (CSV or JSON)
+ */
+
+namespace {
+
+//! Benchmark result: number of operations, elapsed nanoseconds
+struct Result {
+    uint64_t ops;
+    double ns;
+};
+
+//! Benchmark descriptor
+struct Benchmark {
+    const string name;
+    const string unit;
+    const function<Result()> run;
+};
+
+//! Benchmark summary over all repetitions
+struct Summary {
+    string name;
+    string unit;
+    uint64_t ops;
+    //! fastest and mean cost of one operation, nanoseconds
+    double best, mean;
+};
+
+//! times a function, returning the elapsed nanoseconds
+template <typename F>
+double timed(F&& f) {
+    const auto start = chrono::steady_clock::now();
+    f();
+    const chrono::duration<double, nano> elapsed {
+        chrono::steady_clock::now() - start };
+    return elapsed.count();
+}
+
+} // end of anonymous namespace
+
+namespace TrafficProfiles {
+
+/*!
+ *\brief ATP Engine micro-benchmarks
+ *
+ * Declared as friend by the benchmarked classes,
+ * to reach their internal hot paths
+ */
+class Bench {
+
+public:
+
+    /*
+     * Builds a read master profile generating
+     * requests at a high rate
+     */
+    static void makeMaster(Profile* p, const string& name,
+                           const uint64_t i, const uint64_t ot,
+                           const uint64_t txn) {
+        p->set_name(name);
+        p->set_master_id(name);
+        p->set_type(Profile::READ);
+        auto* fifo = p->mutable_fifo();
+        fifo->set_full_level(4096);
+        fifo->set_start_fifo_level(FifoConfiguration::EMPTY);
+        fifo->set_ot_limit(ot);
+        fifo->set_total_txn(txn);
+        fifo->set_rate("64 GBps");
+        auto* pattern = p->mutable_pattern();
+        pattern->set_cmd(Command::READ_REQ);
+        pattern->set_wait_for(Command::READ_RESP);
+        pattern->set_size(64);
+        pattern->mutable_address()->set_base(i << 32);
+        pattern->mutable_address()->set_increment(64);
+    }
+
+    /*
+     * Builds a configuration with a number of independent masters
+     */
+    static Configuration makeMasters(const uint64_t masters,
+                                     const uint64_t txn) {
+        Configuration c;
+        for (uint64_t i = 0; i < masters; ++i) {
+            makeMaster(c.add_profile(), "bench_master_" + to_string(i),
+                       i, 16, txn);
+        }
+        return c;
+    }
+
+    /*
+     * Assigns all masters not bound to a slave to
+     * a slave with the atpeng default parameters
+     */
+    static void addSlave(TrafficProfileManager& tpm) {
+        Profile slave;
+        slave.set_name("bench_slave");
+        slave.set_type(Profile::READ);
+        auto* s = slave.mutable_slave();
+        s->set_latency("80ns");
+        s->set_rate("32GB/s");
+        s->set_granularity(64);
+        s->set_ot_limit(0);
+        const auto masterSlaves = tpm.getMasterSlaves();
+        for (auto& m : tpm.getMasters()) {
+            if (masterSlaves.find(m) == masterSlaves.end()) {
+                s->add_master(m);
+            }
+        }
+        tpm.configureProfile(slave, make_pair(1, 1), true);
+    }
+
+    /*
+     * Engine send loop: every send call visits all active profiles,
+     * responses are returned immediately
+     */
+    static Result profileVisit() {
+        const uint64_t masters = 64, txn = 4096;
+        TrafficProfileManager tpm;
+        tpm.configure(makeMasters(masters, txn));
+
+        bool locked = false;
+        uint64_t next = 0, time = 0, visits = 0;
+        const double ns = timed([&]() {
+            while (true) {
+                auto packets = tpm.send(locked, next, time);
+                visits += masters;
+                if (packets.empty()) {
+                    if (next <= time) break;
+                    time = next;
+                }
+                for (auto& p : packets) {
+                    p.second->set_cmd(Command::READ_RESP);
+                    tpm.receive(time, p.second);
+                }
+            }
+        });
+        return Result { visits, ns };
+    }
+
+    /*
+     * Packet generation: PacketDesc::send with an incrementing
+     * address pattern
+     */
+    static Result packetDescSend() {
+        const uint64_t n = 1000000;
+        PatternConfiguration conf;
+        conf.set_cmd(Command::READ_REQ);
+        conf.set_wait_for(Command::READ_RESP);
+        conf.set_size(64);
+        conf.mutable_address()->set_base(0);
+        conf.mutable_address()->set_increment(64);
+        PacketTagger tagger;
+        PacketDesc pd;
+        pd.init(0, conf, &tagger);
+
+        const double ns = timed([&]() {
+            for (uint64_t i = 0; i < n; ++i) {
+                Packet* p = nullptr;
+                pd.send(p, i);
+                delete p;
+            }
+        });
+        return Result { n, ns };
+    }
+
+    /*
+     * FIFO level update at the configured fill rate
+     */
+    static Result fifoUpdate() {
+        const uint64_t n = 10000000;
+        Fifo fifo;
+        // an empty FIFO, which fills every time unit by 1000
+        fifo.init(nullptr, Profile::READ, 1000, 1, 0, 2000, false);
+        bool underrun = false, overrun = false;
+        const double ns = timed([&]() {
+            for (uint64_t t = 1; t <= n; ++t) {
+                fifo.update(underrun, overrun, t);
+            }
+        });
+        return Result { n, ns };
+    }
+
+    /*
+     * Kronos calendar queue: schedules batches of events spread
+     * over the calendar, then drains them advancing the TPM time
+     */
+    static Result kronosScheduleGet() {
+        const uint64_t batches = 1000, batch = 1000, width = 64,
+                       length = 80000;
+        TrafficProfileManager tpm;
+        tpm.setKronosConfiguration(to_string(width) + "ps",
+                                   to_string(length) + "ps");
+        Kronos kronos(&tpm);
+        kronos.init();
+
+        uint64_t ops = 0, time = 0;
+        list<Event> q;
+        const double ns = timed([&]() {
+            for (uint64_t b = 0; b < batches; ++b) {
+                for (uint64_t i = 0; i < batch; ++i) {
+                    kronos.schedule(Event(Event::TICK, Event::TRIGGERED, i,
+                            time + 1 + (i * 7919) % length));
+                }
+                while (kronos.getCounter() > 0) {
+                    time = kronos.next();
+                    tpm.setTime(time);
+                    kronos.get(q);
+                    ops += q.size();
+                    q.clear();
+                }
+            }
+        });
+        return Result { ops, ns };
+    }
+
+    /*
+     * Engine request/response path: TrafficProfileManager send and
+     * receive, per packet
+     */
+    static Result tpmSendReceive() {
+        const uint64_t masters = 4, txn = 250000;
+        TrafficProfileManager tpm;
+        tpm.configure(makeMasters(masters, txn));
+
+        bool locked = false;
+        uint64_t next = 0, time = 0, packets = 0;
+        const double ns = timed([&]() {
+            while (true) {
+                auto sent = tpm.send(locked, next, time);
+                if (sent.empty()) {
+                    if (next <= time) break;
+                    time = next;
+                }
+                for (auto& p : sent) {
+                    p.second->set_cmd(Command::READ_RESP);
+                    tpm.receive(time, p.second);
+                    packets++;
+                }
+            }
+        });
+        return Result { packets, ns };
+    }
+
+    /*
+     * Engine routing: requests of a single master routed to an
+     * internal slave and responses routed back, driven by the
+     * engine main loop
+     */
+    static Result tpmRoute() {
+        TrafficProfileManager tpm;
+        Configuration c;
+        makeMaster(c.add_profile(), "bench_master", 0, 64, 200000);
+        tpm.configure(c);
+        addSlave(tpm);
+        const double ns = timed([&]() { tpm.loop(); });
+        return Result { tpm.getStats().sent, ns };
+    }
+
+    /*
+     * Full engine run: loads an ATP file, binds its masters to a slave
+     * and runs the engine main loop to completion
+     */
+    static Result loop(const string& file) {
+        TrafficProfileManager tpm;
+        if (!tpm.load(file)) {
+            ERROR("bench unable to load", file);
+        }
+        addSlave(tpm);
+        const double ns = timed([&]() { tpm.loop(); });
+        return Result { tpm.getStats().sent, ns };
+    }
+};
+
+} // end of namespace
+
+namespace {
+
+//! bundled ATP files which run to completion within seconds
+const vector<string> defaultConfigs {
+    "configs/cpu_memcpy.atp",
+    "configs/cpu_pointer_chase.atp",
+    "configs/example.atp",
+    "configs/flowid_reads.atp",
+    "configs/gui_examples/cpu_pc_only.atp",
+    "configs/gui_examples/gpu.atp"
+};
+
+/*
+ * Prints the command line options and exits
+ */
+void usage() {
+    PRINT("\n Usage: atpbench <options>\n",
+          "\t -f (--filter) <value>: runs the benchmarks whose name contains value\n",
+          "\t -r (--repetitions) <value>: repetitions per benchmark (default 3)\n",
+          "\t -c (--configs) <list>: comma-separated ATP files for the loop benchmarks\n",
+          "\t -o (--format) <value>: output format, one of console, csv, json\n",
+          "\t -? or -h (--help): Prints usage and exits\n");
+    exit(0);
+}
+
+} // end of anonymous namespace
+
+int main(int argc, char* argv[]) {
+    string filter, format { "console" };
+    uint64_t repetitions = 3;
+    vector<string> configs { defaultConfigs };
+
+    option long_options[] = {
+            {"filter",      required_argument, 0, 'f'},
+            {"repetitions", required_argument, 0, 'r'},
+            {"configs",     required_argument, 0, 'c'},
+            {"format",      required_argument, 0, 'o'},
+            {"help",        no_argument,       0, 'h'},
+            {0, 0, 0, 0}
+    };
+    int opt = 0, option_index = 0;
+    while ((opt = getopt_long(argc, argv, "f:r:c:o:?h",
+                              long_options, &option_index)) != EOF) {
+        switch (opt) {
+        case 'f':
+            filter = optarg;
+            break;
+        case 'r':
+            repetitions = max<uint64_t>(1, strtoull(optarg, nullptr, 10));
+            break;
+        case 'c': {
+            configs.clear();
+            stringstream ss(optarg);
+            string file;
+            while (getline(ss, file, ',')) {
+                if (!file.empty()) {
+                    configs.push_back(file);
+                }
+            }
+            break;
+        }
+        case 'o':
+            format = optarg;
+            break;
+        default:
+            usage();
+        }
+    }
+    if (format != "console" && format != "csv" && format != "json") {
+        usage();
+    }
+
+    vector<Benchmark> benchmarks {
+        { "packet_desc_send", "packet", Bench::packetDescSend },
+        { "fifo_update", "update", Bench::fifoUpdate },
+        { "kronos_schedule_get", "event", Bench::kronosScheduleGet },
+        { "profile_visit", "profile visit", Bench::profileVisit },
+        { "tpm_send_receive", "packet", Bench::tpmSendReceive },
+        { "tpm_route", "packet", Bench::tpmRoute },
+    };
+    for (auto& c : configs) {
+        // name the loop benchmark after the ATP file
+        string name { c };
+        const size_t slash = name.find_last_of('/');
+        if (slash != string::npos) {
+            name = name.substr(slash + 1);
+        }
+        name = name.substr(0, name.find(".atp"));
+        benchmarks.push_back(Benchmark {
+            "loop/" + name, "packet", [c]() { return Bench::loop(c); } });
+    }
+
+    vector<Summary> summaries;
+    for (auto& b : benchmarks) {
+        if (!filter.empty() && b.name.find(filter) == string::npos) {
+            continue;
+        }
+        Summary s { b.name, b.unit, 0, 0, 0 };
+        for (uint64_t r = 0; r < repetitions; ++r) {
+            const Result res { b.run() };
+            const double cost = (res.ops > 0 ? res.ns / res.ops : 0);
+            s.ops = res.ops;
+            s.best = (r == 0 ? cost : min(s.best, cost));
+            s.mean += cost / repetitions;
+        }
+        if (format == "console") {
+            PRINT(b.name, ":", s.best, "ns per", b.unit, "( mean", s.mean,
+                  "ns,", s.ops, "operations,",
+                  (s.best > 0 ? 1e9 / s.best : 0), b.unit + "s/s )");
+        }
+        summaries.push_back(s);
+    }
+
+    // machine-readable output, one record per benchmark
+    cout << setprecision(9);
+    if (format == "csv") {
+        cout << "name,unit,operations,best_ns_per_op,mean_ns_per_op,"
+                "ops_per_second\n";
+        for (auto& s : summaries) {
+            cout << s.name << ",\"" << s.unit << "\"," << s.ops << ","
+                 << s.best << "," << s.mean << ","
+                 << (s.best > 0 ? 1e9 / s.best : 0) << "\n";
+        }
+    } else if (format == "json") {
+        cout << "{\n  \"repetitions\": " << repetitions
+             << ",\n  \"benchmarks\": [\n";
+        for (uint64_t i = 0; i < summaries.size(); ++i) {
+            const auto& s = summaries[i];
+            cout << "    {\"name\": \"" << s.name
+                 << "\", \"unit\": \"" << s.unit
+                 << "\", \"operations\": " << s.ops
+                 << ", \"best_ns_per_op\": " << s.best
+                 << ", \"mean_ns_per_op\": " << s.mean
+                 << ", \"ops_per_second\": "
+                 << (s.best > 0 ? 1e9 / s.best : 0) << "}"
+                 << (i + 1 < summaries.size() ? ",\n" : "\n");
+        }
+        cout << "  ]\n}\n";
+    }
+    return 0;
+}
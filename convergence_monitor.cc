@@ -0,0 +1,203 @@
+/*
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ *
+ * Copyright (c) 2026 ARM Limited
+ * All rights reserved
+ *  Created on: Oct 18, 2026
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include "convergence_monitor.hh"
+#include "traffic_profile_desc.hh"
+#include "logger.hh"
+#include "snapshot.hh"
+
+namespace TrafficProfiles {
+
+ConvergenceMonitor::Estimator::Estimator(): n(0), mean(0), m2(0) {
+}
+
+void ConvergenceMonitor::Estimator::add(const double x, const uint64_t k) {
+    if (k == 0) {
+        return;
+    }
+    // merges k identical samples at once, as for runs of empty windows
+    const double delta = x - mean;
+    const uint64_t total = n + k;
+    mean += delta * k / total;
+    m2 += delta * delta * ((double)n * k / total);
+    n = total;
+}
+
+double ConvergenceMonitor::Estimator::halfWidth(const double c) const {
+    if (n < 2) {
+        return numeric_limits<double>::infinity();
+    }
+    const double s = sqrt(m2 / (n - 1));
+    return studentQuantile(1 - (1 - c) / 2, n - 1) * s / sqrt((double)n);
+}
+
+ConvergenceMonitor::ConvergenceMonitor():
+        enabled(false), metric(ConvergenceConfiguration::ALL), window(0),
+        warmup(0), minWindows(0), precision(0), confidence(0),
+        terminate(false), started(false), windowStart(0), data(0),
+        latency(0), responses(0), windows(0), converged(false),
+        convergedAt(0) {
+}
+
+double ConvergenceMonitor::studentQuantile(const double p,
+                                           const uint64_t dof) {
+    // normal quantile, Abramowitz and Stegun 26.2.23
+    const double q = (p < .5 ? p : 1 - p);
+    const double w = sqrt(-2 * log(q));
+    double z = w - (2.515517 + 0.802853 * w + 0.010328 * w * w) /
+               (1 + 1.432788 * w + 0.189269 * w * w + 0.001308 * w * w * w);
+    if (p < .5) {
+        z = -z;
+    }
+    // Cornish-Fisher expansion of the Student-t quantile,
+    // accurate to a few percent from 3 degrees of freedom
+    const double v = dof, z2 = z * z;
+    const double g1 = (z2 + 1) * z / 4;
+    const double g2 = ((5 * z2 + 16) * z2 + 3) * z / 96;
+    const double g3 = (((3 * z2 + 19) * z2 + 17) * z2 - 15) * z / 384;
+    const double g4 = ((((79 * z2 + 776) * z2 + 1482) * z2 - 1920) * z2
+                       - 945) * z / 92160;
+    return z + g1 / v + g2 / (v * v) + g3 / (v * v * v) +
+           g4 / (v * v * v * v);
+}
+
+void ConvergenceMonitor::init(TrafficProfileDescriptor* d,
+                              const FifoConfiguration* fifo) {
+    const ConvergenceConfiguration& conf = fifo->convergence();
+
+    metric = conf.metric();
+    window = d->parseTime(conf.window());
+    warmup = conf.warmup_windows();
+    minWindows = conf.min_windows();
+    precision = conf.precision();
+    confidence = conf.confidence();
+    terminate = conf.terminate();
+
+    if (window == 0) {
+        ERROR("ConvergenceMonitor::init [", d->getName(), "] window",
+              conf.window(), "is below the ATP time resolution");
+    }
+    if (minWindows < 2) {
+        ERROR("ConvergenceMonitor::init [", d->getName(),
+              "] at least two windows are required, got", minWindows);
+    }
+    if (precision <= 0) {
+        ERROR("ConvergenceMonitor::init [", d->getName(),
+              "] precision", precision, "must be positive");
+    }
+    if (confidence <= 0 || confidence >= 1) {
+        ERROR("ConvergenceMonitor::init [", d->getName(),
+              "] confidence", confidence, "out of range (0,1)");
+    }
+    enabled = true;
+
+    LOG("ConvergenceMonitor::init [", d->getName(), "]",
+        ConvergenceConfiguration::Metric_Name(metric), "window", window,
+        "warm-up", warmup, "min windows", minWindows, "precision",
+        precision, "confidence", confidence,
+        (terminate ? "terminating" : "flagging only"));
+}
+
+bool ConvergenceMonitor::precise(const Estimator& e) const {
+    return e.n >= minWindows && e.mean > 0 &&
+           e.halfWidth(confidence) <= precision * e.mean;
+}
+
+void ConvergenceMonitor::update(const uint64_t t) {
+    if (!started) {
+        started = true;
+        windowStart = t;
+        return;
+    }
+    if (t < windowStart + window) {
+        return;
+    }
+
+    // close the current window
+    if (windows >= warmup) {
+        bandwidth.add((double)data / window);
+        if (responses > 0) {
+            latencies.add(latency / responses);
+        }
+    }
+    windows++;
+    windowStart += window;
+    data = responses = 0;
+    latency = 0;
+
+    // windows elapsed without responses, merged at once
+    const uint64_t empty = (t - windowStart) / window;
+    if (empty > 0) {
+        const uint64_t discarded =
+                min(empty, (warmup > windows ? warmup - windows : 0));
+        bandwidth.add(0, empty - discarded);
+        windows += empty;
+        windowStart += empty * window;
+    }
+
+    if (!converged) {
+        const bool bw = (metric == ConvergenceConfiguration::LATENCY ||
+                         precise(bandwidth));
+        const bool lat = (metric == ConvergenceConfiguration::BANDWIDTH ||
+                          precise(latencies));
+        if (bw && lat) {
+            converged = true;
+            convergedAt = t;
+            LOG("ConvergenceMonitor::update converged at", t, "after",
+                windows, "windows, bandwidth", bandwidth.mean, "+/-",
+                bandwidth.halfWidth(confidence), "latency",
+                latencies.mean, "+/-", latencies.halfWidth(confidence));
+        }
+    }
+}
+
+bool ConvergenceMonitor::receive(const uint64_t t, const uint64_t size,
+                                 const double delay) {
+    if (!enabled) {
+        return false;
+    }
+    const bool wasConverged = converged;
+    update(t);
+    data += size;
+    latency += delay;
+    responses++;
+    return converged && !wasConverged;
+}
+
+void ConvergenceMonitor::reset() {
+    started = false;
+    windowStart = 0;
+    data = responses = 0;
+    latency = 0;
+    windows = 0;
+    bandwidth = Estimator();
+    latencies = Estimator();
+    converged = false;
+    convergedAt = 0;
+}
+
+void ConvergenceMonitor::serialize(Snapshot& s) {
+    s(started);
+    s(windowStart);
+    s(data);
+    s(latency);
+    s(responses);
+    s(windows);
+    for (Estimator* e : { &bandwidth, &latencies }) {
+        s(e->n);
+        s(e->mean);
+        s(e->m2);
+    }
+    s(converged);
+    s(convergedAt);
+}
+
+} // end of namespace
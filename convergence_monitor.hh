@@ -0,0 +1,190 @@
+/*
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ *
+ * Copyright (c) 2026 ARM Limited
+ * All rights reserved
+ *  Created on: Oct 18, 2026
+ */
+
+#ifndef __AMBA_TRAFFIC_PROFILE_CONVERGENCE_MONITOR_HH__
+#define __AMBA_TRAFFIC_PROFILE_CONVERGENCE_MONITOR_HH__
+
+#include <cstdint>
+#include "proto/tp_config.pb.h"
+
+using namespace std;
+
+namespace TrafficProfiles {
+
+class TrafficProfileDescriptor;
+class Snapshot;
+
+/*!
+ *\brief ATP Master steady-state detector
+ *
+ * Groups the responses received by an ATP Master in fixed-length
+ * windows and treats the window bandwidth and average latency as
+ * batch means: after discarding the warm-up windows, the master has
+ * converged once, for every monitored metric, the Student-t confidence
+ * interval of the mean is narrower than the requested precision,
+ * relative to the mean.
+ *
+ * A converged master either terminates as soon as its outstanding
+ * transactions complete, or only flags its statistics as converged.
+ */
+class ConvergenceMonitor {
+
+public:
+
+    /*!
+     *\brief Running mean and variance of the batch means
+     * (Welford's algorithm)
+     */
+    struct Estimator {
+        //! number of samples
+        uint64_t n;
+        //! samples mean
+        double mean;
+        //! sum of squared differences from the mean
+        double m2;
+
+        //! Default constructor
+        Estimator();
+
+        /*!
+         * Adds a sample a number of times
+         *\param x the sample
+         *\param k the number of times
+         */
+        void add(const double, const uint64_t = 1);
+
+        /*!
+         * Computes the confidence interval half-width of the mean
+         *\param c the confidence level
+         *\return the half-width, infinite with less than two samples
+         */
+        double halfWidth(const double) const;
+    };
+
+protected:
+
+    //! whether a convergence configuration is loaded
+    bool enabled;
+    //! monitored metric
+    ConvergenceConfiguration::Metric metric;
+    //! window length, in ATP time units
+    uint64_t window;
+    //! windows discarded as warm-up
+    uint64_t warmup;
+    //! minimum number of windows to test convergence
+    uint64_t minWindows;
+    //! confidence interval relative half-width
+    double precision;
+    //! confidence level
+    double confidence;
+    //! whether the master terminates once converged
+    bool terminate;
+
+    //! whether the first window has started
+    bool started;
+    //! current window start time
+    uint64_t windowStart;
+    //! data received in the current window
+    uint64_t data;
+    //! cumulative latency in the current window
+    double latency;
+    //! responses received in the current window
+    uint64_t responses;
+    //! number of closed windows, including warm-up ones
+    uint64_t windows;
+
+    //! window bandwidth batch means, in bytes per ATP time unit
+    Estimator bandwidth;
+    //! window average latency batch means, in ATP time units
+    Estimator latencies;
+
+    //! whether the stopping rule was met
+    bool converged;
+    //! time the stopping rule was met
+    uint64_t convergedAt;
+
+    /*!
+     * Closes the windows ended before a given time
+     *\param t the current time
+     */
+    void update(const uint64_t);
+
+    /*!
+     * Checks whether an estimator mean is precise enough
+     *\param e the estimator
+     *\return true if converged
+     */
+    bool precise(const Estimator&) const;
+
+public:
+
+    //! Default constructor
+    ConvergenceMonitor();
+
+    //! Default destructor
+    virtual ~ConvergenceMonitor() = default;
+
+    /*!
+     * Student-t distribution quantile, from the normal quantile
+     * through its Cornish-Fisher expansion
+     *\param p the probability, in (0,1)
+     *\param dof the degrees of freedom
+     *\return the quantile
+     */
+    static double studentQuantile(const double, const uint64_t);
+
+    /*!
+     * Initialises the monitor
+     *\param d the master owning the monitor
+     *\param conf the master FIFO configuration
+     */
+    void init(TrafficProfileDescriptor*, const FifoConfiguration*);
+
+    //! returns whether a convergence configuration is loaded
+    inline bool isEnabled() const { return enabled; }
+
+    /*!
+     * Records a response
+     *\param t the response time
+     *\param size the response size
+     *\param delay the request to response delay
+     *\return true if the master has just converged
+     */
+    bool receive(const uint64_t, const uint64_t, const double);
+
+    //! Clears the monitor state
+    void reset();
+
+    /*!
+     * Saves or restores the monitor state
+     *\param s the snapshot
+     */
+    void serialize(Snapshot&);
+
+    //! returns whether the master has converged
+    inline bool isConverged() const { return converged; }
+
+    //! returns whether the master should stop, as converged
+    inline bool stop() const { return converged && terminate; }
+
+    //! returns the time the master converged at
+    inline uint64_t getConvergedAt() const { return convergedAt; }
+
+    //! returns the number of closed windows, including warm-up ones
+    inline uint64_t getWindows() const { return windows; }
+
+    //! returns the window bandwidth estimator
+    inline const Estimator& getBandwidth() const { return bandwidth; }
+
+    //! returns the window latency estimator
+    inline const Estimator& getLatency() const { return latencies; }
+};
+
+} // end of namespace
+
+#endif /* __AMBA_TRAFFIC_PROFILE_CONVERGENCE_MONITOR_HH__ */
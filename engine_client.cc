@@ -0,0 +1,156 @@
+/*
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ *
+ * Copyright (c) 2026 ARM Limited
+ * All rights reserved
+ *  Created on: Oct 18, 2026
+ */
+
+#include "engine_client.hh"
+#include "logger.hh"
+
+namespace TrafficProfiles {
+
+EngineClient::~EngineClient() {
+    detach();
+}
+
+bool EngineClient::attach(const string& server, const uint64_t engine) {
+    detach();
+    return channel.attach(ShmChannel::channelName(server, engine));
+}
+
+void EngineClient::detach() {
+    if (!channel.isOpen()) {
+        return;
+    }
+    ShmRing::Message* m = reserve();
+    if (m != nullptr) {
+        m->type = ShmChannel::DETACH;
+        m->length = 0;
+        m->time = 0;
+        m->value = 0;
+        channel.getRequests().publish();
+    }
+    channel.close();
+}
+
+ShmRing::Message* EngineClient::reserve() {
+    ShmRing& requests = channel.getRequests();
+    ShmRing::Message* m = nullptr;
+    uint64_t waits = 0;
+    while ((m = requests.reserve()) == nullptr) {
+        requests.publish();
+        if (!channel.getHeader()->serving.load(memory_order_acquire)) {
+            WARN("EngineClient::reserve the engine server stopped");
+            return nullptr;
+        }
+        ShmChannel::backoff(waits);
+    }
+    return m;
+}
+
+const ShmRing::Message* EngineClient::wait() {
+    ShmRing& responses = channel.getResponses();
+    channel.getRequests().publish();
+    const ShmRing::Message* m = nullptr;
+    uint64_t waits = 0;
+    while ((m = responses.peek()) == nullptr) {
+        // the server may be waiting for response slots
+        responses.release();
+        if (!channel.getHeader()->serving.load(memory_order_acquire)) {
+            ERROR("EngineClient::wait the engine server stopped");
+            return nullptr;
+        }
+        ShmChannel::backoff(waits);
+    }
+    return m;
+}
+
+void EngineClient::failed(const ShmRing::Message& m) {
+    const string error(m.payload(), m.length);
+    channel.getResponses().consume();
+    channel.getResponses().release();
+    ERROR("EngineClient hosted engine failed at time", m.time, "-", error);
+}
+
+multimap<string, Packet*> EngineClient::send(bool& locked,
+        uint64_t& nextTransmission, const uint64_t packetTime) {
+    multimap<string, Packet*> ret;
+    nextTransmission = 0;
+    locked = false;
+    ShmRing::Message* m = reserve();
+    if (m == nullptr) {
+        return ret;
+    }
+    m->type = ShmChannel::SEND;
+    m->length = 0;
+    m->time = packetTime;
+    m->value = 0;
+    ShmRing& responses = channel.getResponses();
+    // packets are decoded in place, as they are published
+    for (const ShmRing::Message* r = wait(); r != nullptr; r = wait()) {
+        if (r->type == ShmChannel::PACKET) {
+            Packet* p = new Packet();
+            if (!ShmChannel::decode(r, *p)) {
+                delete p;
+                ERROR("EngineClient::send malformed packet received");
+            } else {
+                ret.emplace(p->master_id(), p);
+            }
+            responses.consume();
+        } else if (r->type == ShmChannel::SENT) {
+            nextTransmission = r->time;
+            locked = (r->value != 0);
+            responses.consume();
+            break;
+        } else {
+            failed(*r);
+            break;
+        }
+    }
+    responses.release();
+    return ret;
+}
+
+bool EngineClient::receive(const uint64_t packetTime, Packet* packet) {
+    if (packet->ByteSizeLong() > channel.getRequests().capacity()) {
+        ERROR("EngineClient::receive packet exceeds the",
+              channel.getRequests().capacity(), "bytes slot payload");
+        return false;
+    }
+    ShmRing::Message* m = reserve();
+    if (m == nullptr) {
+        return false;
+    }
+    m->type = ShmChannel::RECEIVE;
+    m->time = packetTime;
+    m->value = 0;
+    ShmChannel::encode(channel.getRequests(), m, *packet);
+    bool accepted = false;
+    const ShmRing::Message* r = wait();
+    if (r != nullptr && r->type == ShmChannel::RECEIVED) {
+        accepted = (r->value != 0);
+        channel.getResponses().consume();
+        channel.getResponses().release();
+    } else if (r != nullptr) {
+        failed(*r);
+    }
+    if (accepted) {
+        delete packet;
+    }
+    return accepted;
+}
+
+void EngineClient::setTime(const uint64_t t) {
+    ShmRing::Message* m = reserve();
+    if (m != nullptr) {
+        m->type = ShmChannel::SET_TIME;
+        m->length = 0;
+        m->time = t;
+        m->value = 0;
+        // no response, handed over with the next request
+    }
+}
+
+} // end of namespace
@@ -0,0 +1,103 @@
+/*
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ *
+ * Copyright (c) 2026 ARM Limited
+ * All rights reserved
+ *  Created on: Oct 18, 2026
+ */
+
+#ifndef __AMBA_TRAFFIC_PROFILE_ENGINE_CLIENT_HH__
+#define __AMBA_TRAFFIC_PROFILE_ENGINE_CLIENT_HH__
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include "shm_channel.hh"
+
+using namespace std;
+
+namespace TrafficProfiles {
+
+/*!
+ *\brief ATP Engine shared memory client
+ *
+ * Drives an engine hosted by an EngineServer on the same host through
+ * its shared memory channel. The send, receive and setTime methods
+ * mirror the TrafficProfileManager ones, so that adaptors can use a
+ * hosted engine in place of a linked one.
+ */
+class EngineClient {
+
+protected:
+
+    //! the engine channel
+    ShmChannel channel;
+
+    /*!
+     * Reserves a request slot, waiting for the server to free one
+     *\return the request slot
+     */
+    ShmRing::Message* reserve();
+
+    /*!
+     * Waits for the next response, publishing pending requests
+     *\return the response, to be consumed by the caller
+     */
+    const ShmRing::Message* wait();
+
+    /*!
+     * Reports an engine error forwarded by the server
+     *\param m the FAILED response
+     */
+    void failed(const ShmRing::Message&);
+
+public:
+
+    //! Creates a detached client
+    EngineClient() = default;
+
+    //! Destructor, detaches from the engine
+    virtual ~EngineClient();
+
+    /*!
+     * Attaches to a hosted engine
+     *\param server the server name
+     *\param engine the engine index
+     *\return true if attached
+     */
+    bool attach(const string&, const uint64_t);
+
+    //! Detaches from the engine, which can then be attached to again
+    void detach();
+
+    //! returns true if attached to an engine
+    inline bool isAttached() const { return channel.isOpen(); }
+
+    /*!
+     * Returns packets generated by the hosted engine
+     *\param locked if the engine is locked on waiting for responses
+     *\param nextTransmission the next time a packet will be available
+     *\param packetTime the current time unit
+     *\return a list of ATP packets, ordered per master, owned by the
+     *        caller
+     */
+    multimap<string, Packet*> send(bool&, uint64_t&, const uint64_t);
+
+    /*!
+     * Delivers a packet to the hosted engine
+     *\param packetTime the time the packet was received
+     *\param packet the ATP packet, deleted if accepted
+     *\return true if the destination profile has accepted the packet
+     */
+    bool receive(const uint64_t, Packet*);
+
+    /*!
+     * Sets the hosted engine time
+     *\param t time to set - cannot be in the past
+     */
+    void setTime(const uint64_t);
+};
+
+} // end of namespace
+
+#endif /* __AMBA_TRAFFIC_PROFILE_ENGINE_CLIENT_HH__ */
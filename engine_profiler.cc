@@ -0,0 +1,172 @@
+/*
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ *
+ * Copyright (c) 2026 ARM Limited
+ * All rights reserved
+ *  Created on: Oct 18, 2026
+ */
+
+#include <chrono>
+#include <iomanip>
+#include <sstream>
+#include "engine_profiler.hh"
+#include "types.hh"
+
+namespace TrafficProfiles {
+
+const string EngineProfiler::sectionText[] = {
+        [SEND]        = "send",
+        [RECEIVE]     = "receive",
+        [ROUTE]       = "route",
+        [HANDLE]      = "handle",
+        [KRONOS_GET]  = "kronos_get",
+        [FIFO_UPDATE] = "fifo_update"
+};
+
+const string EngineProfiler::counterText[] = {
+        [PACKETS_SENT]     = "packets_sent",
+        [PACKETS_RECEIVED] = "packets_received",
+        [EVENTS]           = "events",
+        [WAKEUPS]          = "wakeups"
+};
+
+EngineProfiler EngineProfiler::inactive;
+
+EngineProfiler::Entry::Entry() {
+    timers.fill(Timer { 0, 0 });
+    counters.fill(0);
+}
+
+EngineProfiler::Entry&
+EngineProfiler::Entry::operator+=(const Entry& e) {
+    for (uint64_t i = 0; i < N_SECTIONS; ++i) {
+        timers[i].calls += e.timers[i].calls;
+        timers[i].ticks += e.timers[i].ticks;
+    }
+    for (uint64_t i = 0; i < N_COUNTERS; ++i) {
+        counters[i] += e.counters[i];
+    }
+    return *this;
+}
+
+bool EngineProfiler::Entry::empty() const {
+    for (auto& t : timers) {
+        if (t.calls > 0) {
+            return false;
+        }
+    }
+    for (auto c : counters) {
+        if (c > 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+const string EngineProfiler::Entry::dump(const double nsPerTick) const {
+    stringstream ss;
+    ss << fixed << setprecision(1);
+    for (uint64_t i = 0; i < N_SECTIONS; ++i) {
+        const auto& t = timers[i];
+        if (t.calls == 0) {
+            continue;
+        }
+        const double ns = t.ticks * nsPerTick;
+        ss << "  " << sectionText[i] << " calls: " << t.calls
+           << " time: " << ns << "ns avg: " << ns / t.calls << "ns\n";
+    }
+    for (uint64_t i = 0; i < N_COUNTERS; ++i) {
+        if (counters[i] > 0) {
+            ss << "  " << counterText[i] << ": " << counters[i] << "\n";
+        }
+    }
+    return ss.str();
+}
+
+EngineProfiler::Report::Report(): nsPerTick(0) {
+}
+
+const string EngineProfiler::Report::dump() const {
+    stringstream ss;
+    ss << "Engine total\n" << total.dump(nsPerTick);
+    for (auto& r : roles) {
+        ss << "Role " << r.first << "\n" << r.second.dump(nsPerTick);
+    }
+    for (auto& p : profiles) {
+        ss << "Profile " << p.first << "\n" << p.second.dump(nsPerTick);
+    }
+    return ss.str();
+}
+
+EngineProfiler::EngineProfiler():
+        enabled(false), origin(0, 0), elapsed(0, 0) {
+}
+
+uint64_t EngineProfiler::now() {
+    return chrono::duration_cast<chrono::nanoseconds>(
+            chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+EngineProfiler::Entry& EngineProfiler::entry(const uint64_t id) {
+    if (id >= perProfile.size()) {
+        perProfile.resize(id + 1);
+    }
+    return perProfile[id];
+}
+
+void EngineProfiler::record(const Section s, const uint64_t id,
+                            const uint64_t t) {
+    total.timers[s].calls++;
+    total.timers[s].ticks += t;
+    if (isValid(id)) {
+        auto& e = entry(id);
+        e.timers[s].calls++;
+        e.timers[s].ticks += t;
+    }
+}
+
+void EngineProfiler::increment(const Counter c, const uint64_t id,
+                               const uint64_t n) {
+    total.counters[c] += n;
+    if (isValid(id)) {
+        entry(id).counters[c] += n;
+    }
+}
+
+void EngineProfiler::enable() {
+    if (!enabled) {
+        enabled = true;
+        origin = make_pair(ticks(), now());
+    }
+}
+
+void EngineProfiler::disable() {
+    if (enabled) {
+        enabled = false;
+        elapsed.first += ticks() - origin.first;
+        elapsed.second += now() - origin.second;
+    }
+}
+
+void EngineProfiler::reset() {
+    total = Entry();
+    perProfile.clear();
+    elapsed = make_pair(0, 0);
+    origin = make_pair(ticks(), now());
+}
+
+const EngineProfiler::Entry* EngineProfiler::getEntry(const uint64_t id) const {
+    return (id < perProfile.size() ? &perProfile[id] : nullptr);
+}
+
+double EngineProfiler::nsPerTick() const {
+    uint64_t t = elapsed.first, ns = elapsed.second;
+    if (enabled) {
+        t += ticks() - origin.first;
+        ns += now() - origin.second;
+    }
+    // the steady clock is the tick source on unsupported architectures
+    return (t > 0 && ns > 0 ? (double)ns / t : 1.);
+}
+
+} // end of namespace
@@ -0,0 +1,270 @@
+/*
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ *
+ * Copyright (c) 2026 ARM Limited
+ * All rights reserved
+ *  Created on: Oct 18, 2026
+ */
+
+#ifndef __AMBA_TRAFFIC_PROFILE_ENGINE_PROFILER_HH__
+#define __AMBA_TRAFFIC_PROFILE_ENGINE_PROFILER_HH__
+
+#include <array>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+namespace TrafficProfiles {
+
+/*!
+ *\brief ATP Engine self-profiler
+ *
+ * Measures where the engine spends its own time: the engine hot
+ * paths (profiles send and receive, packet routing, Kronos events
+ * handling and retrieval, FIFO updates) are timed with the CPU
+ * cycle counter and counted, together with the number of packets,
+ * events and engine wakeups. Measurements are accumulated globally
+ * and per profile ID.
+ *
+ * Timers are inclusive: a profile send includes the FIFO updates
+ * it causes, a route includes the send and receive it performs.
+ *
+ * The profiler is disabled by default, in which case every measured
+ * section costs a single predictable branch.
+ */
+class EngineProfiler {
+
+public:
+
+    //! Measured engine sections
+    enum Section {
+        SEND, RECEIVE, ROUTE, HANDLE, KRONOS_GET, FIFO_UPDATE, N_SECTIONS
+    };
+
+    //! Engine counters
+    enum Counter {
+        PACKETS_SENT, PACKETS_RECEIVED, EVENTS, WAKEUPS, N_COUNTERS
+    };
+
+    //! Sections text description
+    static const string sectionText[N_SECTIONS];
+
+    //! Counters text description
+    static const string counterText[N_COUNTERS];
+
+    //! Section timer
+    struct Timer {
+        //! number of section executions
+        uint64_t calls;
+        //! cumulative section time, in CPU ticks
+        uint64_t ticks;
+    };
+
+    //! Timers and counters of a profile, role or of the whole engine
+    struct Entry {
+        //! section timers
+        array<Timer, N_SECTIONS> timers;
+        //! counters
+        array<uint64_t, N_COUNTERS> counters;
+
+        //! Default constructor
+        Entry();
+
+        /*!
+         * Accumulates another entry into this one
+         *\param e the entry to accumulate
+         *\return this entry
+         */
+        Entry& operator+=(const Entry&);
+
+        //! returns true if nothing was recorded
+        bool empty() const;
+
+        /*!
+         * Formats the entry
+         *\param nsPerTick CPU tick duration in nanoseconds
+         *\return the formatted entry
+         */
+        const string dump(const double) const;
+    };
+
+    //! Engine profile report, aggregated per role and per profile
+    struct Report {
+        //! CPU tick duration in nanoseconds
+        double nsPerTick;
+        //! whole engine measurements
+        Entry total;
+        //! role name -> measurements
+        map<string, Entry> roles;
+        //! profile name -> measurements
+        map<string, Entry> profiles;
+
+        //! Default constructor
+        Report();
+
+        /*!
+         * Converts CPU ticks to nanoseconds
+         *\param ticks the CPU ticks to convert
+         *\return the converted time in nanoseconds
+         */
+        inline double toNs(const uint64_t ticks) const {
+            return ticks * nsPerTick;
+        }
+
+        //! Formats the report
+        const string dump() const;
+    };
+
+protected:
+
+    //! whether measurements are being taken
+    bool enabled;
+
+    //! whole engine measurements
+    Entry total;
+
+    //! profile ID -> measurements
+    vector<Entry> perProfile;
+
+    //! CPU ticks and steady clock time when measurements were enabled
+    pair<uint64_t, uint64_t> origin;
+
+    //! CPU ticks and steady clock time accumulated while enabled
+    pair<uint64_t, uint64_t> elapsed;
+
+    //! reads the steady clock, in nanoseconds
+    static uint64_t now();
+
+    /*!
+     * Returns the measurements of a profile, allocating them if needed
+     *\param id the profile ID
+     *\return the profile measurements
+     */
+    Entry& entry(const uint64_t);
+
+    /*!
+     * Records a section execution
+     *\param s the measured section
+     *\param id the profile ID, or an invalid ID if not associated
+     *          to a profile
+     *\param t the section duration, in CPU ticks
+     */
+    void record(const Section, const uint64_t, const uint64_t);
+
+    /*!
+     * Increments a counter
+     *\param c the counter to be incremented
+     *\param id the profile ID, or an invalid ID if not associated
+     *          to a profile
+     *\param n the increment
+     */
+    void increment(const Counter, const uint64_t, const uint64_t);
+
+public:
+
+    //! Default constructor
+    EngineProfiler();
+
+    //! Default destructor
+    virtual ~EngineProfiler() = default;
+
+    //! Reads the CPU cycle counter
+    static inline uint64_t ticks() {
+#if defined(__x86_64__) || defined(__i386__)
+        return __builtin_ia32_rdtsc();
+#elif defined(__aarch64__)
+        uint64_t t;
+        asm volatile("mrs %0, cntvct_el0" : "=r"(t));
+        return t;
+#else
+        return now();
+#endif
+    }
+
+    //! Starts taking measurements
+    void enable();
+
+    //! Stops taking measurements
+    void disable();
+
+    //! returns whether measurements are being taken
+    inline bool isEnabled() const { return enabled; }
+
+    //! Clears all measurements
+    void reset();
+
+    /*!
+     * Executes an engine section, timing it if enabled
+     *\param s the measured section
+     *\param id the profile ID, or an invalid ID if not associated
+     *          to a profile
+     *\param f the section to be executed
+     *\param c optional counter incremented when the section returns true
+     *\return the section return value
+     */
+    template <typename F>
+    inline auto measure(const Section s, const uint64_t id, F&& f,
+                        const Counter c = N_COUNTERS) -> decltype(f()) {
+        if (__builtin_expect(!enabled, 1)) {
+            return f();
+        }
+        const uint64_t start = ticks();
+        if constexpr (is_void<decltype(f())>::value) {
+            f();
+            record(s, id, ticks() - start);
+        } else {
+            auto ret = f();
+            record(s, id, ticks() - start);
+            if (c != N_COUNTERS && ret) {
+                increment(c, id, 1);
+            }
+            return ret;
+        }
+    }
+
+    /*!
+     * Increments a counter if enabled
+     *\param c the counter to be incremented
+     *\param id the profile ID, or an invalid ID if not associated
+     *          to a profile
+     *\param n optional increment
+     */
+    inline void count(const Counter c, const uint64_t id,
+                      const uint64_t n = 1) {
+        if (__builtin_expect(enabled, 0)) {
+            increment(c, id, n);
+        }
+    }
+
+    //! returns the whole engine measurements
+    inline const Entry& getTotal() const { return total; }
+
+    /*!
+     * Returns the measurements of a profile
+     *\param id the profile ID
+     *\return the profile measurements, or nullptr if none was recorded
+     */
+    const Entry* getEntry(const uint64_t) const;
+
+    //! returns the number of profiles with recorded measurements
+    inline uint64_t size() const { return perProfile.size(); }
+
+    /*!
+     * Estimates the CPU tick duration against the steady clock,
+     * over the time measurements were enabled
+     *\return the CPU tick duration in nanoseconds
+     */
+    double nsPerTick() const;
+
+    //! Disabled profiler, for modules not owned by a TPM
+    static EngineProfiler inactive;
+};
+
+} // end of namespace
+
+#endif /* __AMBA_TRAFFIC_PROFILE_ENGINE_PROFILER_HH__ */
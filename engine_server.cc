@@ -0,0 +1,201 @@
+/*
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ *
+ * Copyright (c) 2026 ARM Limited
+ * All rights reserved
+ *  Created on: Oct 18, 2026
+ */
+
+#include <algorithm>
+#include "engine_server.hh"
+#include "logger.hh"
+
+namespace TrafficProfiles {
+
+const uint64_t EngineServer::defaultSlots;
+const uint64_t EngineServer::defaultSlotSize;
+
+EngineServer::EngineServer(const string& n, const uint64_t e,
+                           const uint64_t slots, const uint64_t slotSize):
+        name(n), running(false) {
+    for (uint64_t i = 0; i < e; ++i) {
+        const string channel = ShmChannel::channelName(name, i);
+        engines.emplace_back(new Engine());
+        if (!engines.back()->channel.create(channel, slots, slotSize)) {
+            ERROR("EngineServer unable to create channel", channel);
+        }
+    }
+}
+
+EngineServer::~EngineServer() {
+    stop();
+}
+
+bool EngineServer::load(const string& fileName) {
+    Configuration c;
+    if (!TrafficProfileManager::parse(fileName, c)) {
+        return false;
+    }
+    configure(c);
+    return true;
+}
+
+void EngineServer::configure(const Configuration& c) {
+    for (auto& e : engines) {
+        e->tpm.configure(c);
+    }
+}
+
+void EngineServer::start() {
+    if (running) {
+        return;
+    }
+    running = true;
+    for (auto& e : engines) {
+        e->channel.getHeader()->serving.store(true, memory_order_release);
+        e->worker = thread(&EngineServer::serve, this, ref(*e));
+    }
+    PRINT("EngineServer", name, "serving", engines.size(), "engines");
+}
+
+void EngineServer::stop() {
+    if (!running) {
+        return;
+    }
+    running = false;
+    for (auto& e : engines) {
+        e->worker.join();
+        e->channel.getHeader()->serving.store(false, memory_order_release);
+    }
+    LOG("EngineServer", name, "stopped");
+}
+
+ShmRing::Message* EngineServer::reserve(Engine& e) {
+    ShmRing& responses = e.channel.getResponses();
+    ShmRing::Message* m = nullptr;
+    uint64_t waits = 0;
+    while ((m = responses.reserve()) == nullptr) {
+        // the client frees slots once it sees the pending responses,
+        // and may be waiting for request slots to be released
+        responses.publish();
+        e.channel.getRequests().release();
+        if (!running) {
+            return nullptr;
+        }
+        ShmChannel::backoff(waits);
+    }
+    return m;
+}
+
+bool EngineServer::handle(Engine& e, const ShmRing::Message& m) {
+    TrafficProfileManager& tpm = e.tpm;
+    ShmRing& responses = e.channel.getResponses();
+    try {
+        switch (m.type) {
+        case ShmChannel::SEND: {
+            bool locked = false;
+            uint64_t next = 0;
+            auto packets = tpm.send(locked, next, m.time);
+            bool fits = true;
+            for (auto& p : packets) {
+                fits &= (p.second->ByteSizeLong() <= responses.capacity());
+            }
+            for (auto& p : packets) {
+                ShmRing::Message* r = (fits ? reserve(e) : nullptr);
+                if (r != nullptr) {
+                    r->type = ShmChannel::PACKET;
+                    r->time = m.time;
+                    r->value = 0;
+                    ShmChannel::encode(responses, r, *p.second);
+                }
+                delete p.second;
+            }
+            if (!fits) {
+                ERROR("EngineServer::handle packet exceeds the",
+                      responses.capacity(), "bytes slot payload");
+            }
+            ShmRing::Message* r = reserve(e);
+            if (r == nullptr) {
+                return false;
+            }
+            r->type = ShmChannel::SENT;
+            r->length = 0;
+            r->time = next;
+            r->value = locked;
+            break;
+        }
+        case ShmChannel::RECEIVE: {
+            Packet* p = new Packet();
+            if (!ShmChannel::decode(&m, *p)) {
+                delete p;
+                ERROR("EngineServer::handle malformed packet received");
+            }
+            // accepted packets are deleted by the TPM, rejected
+            // external ones are retained by the client
+            const bool accepted = tpm.receive(m.time, p);
+            if (!accepted) {
+                delete p;
+            }
+            ShmRing::Message* r = reserve(e);
+            if (r == nullptr) {
+                return false;
+            }
+            r->type = ShmChannel::RECEIVED;
+            r->length = 0;
+            r->time = m.time;
+            r->value = accepted;
+            break;
+        }
+        case ShmChannel::SET_TIME:
+            tpm.setTime(m.time);
+            break;
+        case ShmChannel::DETACH:
+            LOG("EngineServer::handle client detached from", name);
+            break;
+        default:
+            ERROR("EngineServer::handle unknown request type", m.type);
+        }
+    } catch (const EngineError& error) {
+        ShmRing::Message* r = reserve(e);
+        if (r == nullptr) {
+            return false;
+        }
+        r->type = ShmChannel::FAILED;
+        r->time = tpm.getTime();
+        r->value = 0;
+        ShmChannel::encode(responses, r, string(error.what()));
+    }
+    return true;
+}
+
+void EngineServer::serve(Engine& e) {
+    // engine errors are reported to the client instead of exiting
+    Logger logger(&cout, min(Logger::get()->getLevel(),
+                             Logger::ERROR_LEVEL));
+    logger.setThrowOnErrors(true);
+    Logger::setThreadLogger(&logger);
+
+    ShmRing& requests = e.channel.getRequests();
+    ShmRing& responses = e.channel.getResponses();
+    uint64_t waits = 0;
+    while (running) {
+        const ShmRing::Message* m = requests.peek();
+        if (m == nullptr) {
+            // hand over a whole batch of responses at once
+            requests.release();
+            responses.publish();
+            ShmChannel::backoff(waits);
+            continue;
+        }
+        waits = 0;
+        if (!handle(e, *m)) {
+            break;
+        }
+        requests.consume();
+    }
+    requests.release();
+    responses.publish();
+    Logger::setThreadLogger(nullptr);
+}
+
+} // end of namespace
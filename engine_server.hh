@@ -0,0 +1,135 @@
+/*
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ *
+ * Copyright (c) 2026 ARM Limited
+ * All rights reserved
+ *  Created on: Oct 18, 2026
+ */
+
+#ifndef __AMBA_TRAFFIC_PROFILE_ENGINE_SERVER_HH__
+#define __AMBA_TRAFFIC_PROFILE_ENGINE_SERVER_HH__
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "shm_channel.hh"
+#include "traffic_profile_manager.hh"
+
+using namespace std;
+
+namespace TrafficProfiles {
+
+/*!
+ *\brief ATP Engine shared memory server
+ *
+ * Hosts one or more TPM instances, loaded once with the same
+ * configuration, and serves each of them to a client on the same host
+ * through its own shared memory channel, named after the server and
+ * the engine index, e.g. /atp.0 and /atp.1 for server atp.
+ *
+ * Each engine is served by its own thread, which polls the channel
+ * requests ring and forwards send, receive and setTime requests to the
+ * TPM; engine errors are reported to the client instead of exiting.
+ */
+class EngineServer {
+
+public:
+
+    //! Default number of slots per ring
+    static const uint64_t defaultSlots = 1024;
+
+    //! Default slot size, in bytes
+    static const uint64_t defaultSlotSize = 256;
+
+protected:
+
+    //! Hosted engine
+    struct Engine {
+        //! the TPM
+        TrafficProfileManager tpm;
+        //! the engine channel
+        ShmChannel channel;
+        //! the serving thread
+        thread worker;
+    };
+
+    //! server name, prefix of the channel names
+    const string name;
+
+    //! hosted engines
+    vector<unique_ptr<Engine>> engines;
+
+    //! true while serving
+    atomic<bool> running;
+
+    /*!
+     * Serves an engine until the server is stopped
+     *\param e the engine
+     */
+    void serve(Engine&);
+
+    /*!
+     * Handles a client request
+     *\param e the engine
+     *\param m the request message
+     *\return false if the request couldn't be handled
+     */
+    bool handle(Engine&, const ShmRing::Message&);
+
+    /*!
+     * Reserves a response slot, waiting for the client to free one
+     *\param e the engine
+     *\return the response slot, nullptr if stopped while waiting
+     */
+    ShmRing::Message* reserve(Engine&);
+
+public:
+
+    /*!
+     * Constructor, creates the engines channels
+     *\param n the server name
+     *\param e the number of hosted engines
+     *\param slots number of slots per ring
+     *\param slotSize slot size, in bytes
+     */
+    EngineServer(const string&, const uint64_t,
+                 const uint64_t = defaultSlots,
+                 const uint64_t = defaultSlotSize);
+
+    //! Destructor, stops serving and removes the channels
+    virtual ~EngineServer();
+
+    /*!
+     * Parses a configuration file once and loads it into all engines
+     *\param fileName the configuration file name
+     *\return true if the file was loaded
+     */
+    bool load(const string&);
+
+    /*!
+     * Loads a configuration into all engines
+     *\param c the configuration
+     */
+    void configure(const Configuration&);
+
+    //! Starts serving, one thread per engine
+    void start();
+
+    //! Stops serving and joins the serving threads
+    void stop();
+
+    //! returns the number of hosted engines
+    inline uint64_t size() const { return engines.size(); }
+
+    //! returns a hosted engine TPM, to be accessed when not serving
+    inline TrafficProfileManager& getEngine(const uint64_t i) {
+        return engines.at(i)->tpm;
+    }
+};
+
+} // end of namespace
+
+#endif /* __AMBA_TRAFFIC_PROFILE_ENGINE_SERVER_HH__ */
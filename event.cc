@@ -28,7 +28,8 @@ const string Event::text[]= {
         [PROFILE_LOCKED] = "PROFILE_LOCKED",
         [PROFILE_UNLOCKED] = "PROFILE_UNLOCKED",
         [PACKET_REQUEST_RETRY] = "PACKET_REQUEST_RETRY",
-        [TICK] = "TICK"
+        [TICK] = "TICK",
+        [QOS_VIOLATION] = "QOS_VIOLATION"
 };
 
 const Event::Category Event::category[] = {
@@ -42,7 +43,8 @@ const Event::Category Event::category[] = {
         [PROFILE_LOCKED]        = SEND_STATUS,
         [PROFILE_UNLOCKED]      = SEND_STATUS,
         [PACKET_REQUEST_RETRY]  = PACKET,
-        [TICK]                  = CLOCK
+        [TICK]                  = CLOCK,
+        [QOS_VIOLATION]         = QOS
 };
 
 const bool Event::allowConcurrency[] = {
@@ -51,7 +53,19 @@ const bool Event::allowConcurrency[] = {
         [FIFO_LEVEL] = false,
         [SEND_STATUS] = false,
         [PACKET] = true,
-        [CLOCK] = false
+        [CLOCK] = false,
+        [QOS] = true
+};
+
+// each QoS envelope excursion fires its own violation event
+const bool Event::allowRepeat[] = {
+        [NO_CATEGORY] = false,
+        [PROFILE] = false,
+        [FIFO_LEVEL] = false,
+        [SEND_STATUS] = false,
+        [PACKET] = false,
+        [CLOCK] = false,
+        [QOS] = true
 };
 
 
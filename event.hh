@@ -40,7 +40,8 @@ public:
         SEND_STATUS = 3,
         PACKET = 4,
         CLOCK = 5,
-        N_CATEGORIES = 6
+        QOS = 6,
+        N_CATEGORIES = 7
     };
 
     /*!
@@ -56,6 +57,7 @@ public:
      * PROFILE_UNLOCKED: a profile is able to send data after being unable
      * PACKET_REQUEST_RETRY: a rejected request is due to be retried
      * TICK: special clock event, triggers TPM tick
+     * QOS_VIOLATION: a checked profile left its checker QoS envelope
      */
     const enum Type {
         NONE = 0,
@@ -69,7 +71,8 @@ public:
         PROFILE_UNLOCKED = 8,
         PACKET_REQUEST_RETRY = 9,
         TICK = 10,
-        N_EVENTS = 11
+        QOS_VIOLATION = 11,
+        N_EVENTS = 12
     } type;
 
     /*!
@@ -97,6 +100,11 @@ public:
      */
     static const bool allowConcurrency[];
 
+    /*!
+     * Event category to allow repeated events flag map
+     */
+    static const bool allowRepeat[];
+
     /*!
      *  Unique ID
      */
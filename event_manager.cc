@@ -7,8 +7,11 @@
  *      Author: Matteo Andreozzi
  */
 
+#include <algorithm>
 #include "event_manager.hh"
 #include "traffic_profile_manager.hh"
+#include "fast_forward.hh"
+#include "snapshot.hh"
 #include "logger.hh"
 
 namespace TrafficProfiles {
@@ -47,7 +50,10 @@ EventManager::waitEvent(const Event::Type type,
         const uint64_t id, const bool retain) {
     if (type!=Event::NONE) {
         Event ev(type, Event::AWAITED, id, tpm->getTime());
-        waited[ev.id].insert(ev);
+        if (find(waited.begin(), waited.end(), Waited(id, type))
+                == waited.end()) {
+            waited.emplace_back(id, type);
+        }
         waitedCount[Event::category[type]]++;
         if (tpm) tpm->subscribe(eventId, ev);
         if (retain) retainedEvents.push_back(ev);
@@ -64,14 +70,15 @@ void EventManager::emitEvent(const Event::Type type) {
         Event::Category cat = Event::category[type];
 
         // if the last sent event for its category is not
-        // the requested one, and if either event concurrency
+        // the requested one, or repeated events are allowed
+        // for this category, and if either event concurrency
         // for this category is allowed or the last sent event
         // was not sent at this current time, then send it
 
         auto& sentCat = sent[cat];
 
         if ((sentCat.first == Event::NONE) ||
-            (sentCat.first != type && (
+            ((sentCat.first != type || Event::allowRepeat[cat]) && (
             (sentCat.second < tpm->getTime()) ||
             Event::allowConcurrency[cat]))) {
             sentCat = make_pair(type,tpm->getTime());
@@ -97,14 +104,11 @@ EventManager::receiveEvent(const Event& ev) {
                 ,"] action is not TRIGGERED", ev);
     }
 
-    if ((waited.find(ev.id)!=waited.end()) &&
-            (waited.at(ev.id).find(ev)!=waited.at(ev.id).end())) {
+    auto it = find(waited.begin(), waited.end(), Waited(ev.id, ev.type));
+    if (it != waited.end()) {
 
-        waited[ev.id].erase(ev);
+        waited.erase(it);
         waitedCount[Event::category[ev.type]]--;
-        if (waited[ev.id].empty()) {
-            waited.erase(ev.id);
-        }
 
         ok=true;
         LOG("EventManager::receiveEvent this id [", eventId, "] event",ev,
@@ -115,11 +119,13 @@ EventManager::receiveEvent(const Event& ev) {
     if (ev.type==Event::TERMINATION) {
         // release any event this profile might be still waiting
         // for related to the terminated event
-        if (waited.count(ev.id) > 0) {
-            for (auto& e:waited[ev.id]) {
-                waitedCount[Event::category[e.type]]--;
+        auto related = partition(waited.begin(), waited.end(),
+                [&ev](const Waited& w) { return w.first != ev.id; });
+        if (related != waited.end()) {
+            for (auto e = related; e != waited.end(); ++e) {
+                waitedCount[Event::category[e->second]]--;
             }
-            waited.erase(ev.id);
+            waited.erase(related, waited.end());
             LOG("EventManager::receiveEvent this id [", eventId, "] event",ev,
                     "removed all waited events for id", ev.id);
         }
@@ -129,4 +135,29 @@ EventManager::receiveEvent(const Event& ev) {
     return ok;
 }
 
+void EventManager::walk(StateWalker& w) {
+    w(eventId);
+    for (auto& s : sent) {
+        w(s.first);
+        w(s.second, StateWalker::TIME);
+    }
+    w.size(waited);
+    for (auto& e : waited) {
+        w(e.first);
+        w(e.second);
+    }
+    for (auto c : waitedCount) {
+        w(c);
+    }
+    w.size(retainedEvents);
+}
+
+void EventManager::serialize(Snapshot& s) {
+    s(eventId);
+    s(sent);
+    s(waited);
+    s(waitedCount);
+    s(retainedEvents);
+}
+
 } /* namespace TrafficProfiles */
@@ -15,6 +15,7 @@
 #include <map>
 #include <set>
 #include <unordered_set>
+#include <vector>
 #include "event.hh"
 
 using namespace std;
@@ -22,6 +23,8 @@ using namespace std;
 namespace TrafficProfiles {
 
 class TrafficProfileManager;
+class StateWalker;
+class Snapshot;
 
 /*!
  *\brief ATP Event Manager
@@ -31,6 +34,11 @@ class TrafficProfileManager;
  */
 class EventManager {
 
+public:
+
+    //! Event waited for: event ID, event type
+    typedef pair<uint64_t, Event::Type> Waited;
+
 protected:
 
     /*!
@@ -49,10 +57,10 @@ protected:
     array<pair<Event::Type, uint64_t>, Event::N_CATEGORIES> sent;
 
     /*!
-     * Map: event ID, Events waited for with
-     * that ID
+     * Events waited for - a handful per profile,
+     * hence stored flat and scanned linearly
      */
-    map<uint64_t, unordered_set<Event>> waited;
+    vector<Waited> waited;
 
     /*!
      * Number of events waited for per category
@@ -134,7 +142,7 @@ public:
      * Returns a constant reference to the waited events set
      *\return constant reference to waited events set
      */
-    virtual const map<uint64_t, unordered_set<Event>>&
+    virtual const vector<Waited>&
         getWaited() const {return waited;}
 
     /*!
@@ -161,6 +169,18 @@ public:
     inline uint64_t getWaitedCount(const Event::Category c) {
         return waitedCount[c];
     }
+
+    /*!
+     * Walks the sent and waited for events for fast-forward
+     *\param w the state walker
+     */
+    void walk(StateWalker&);
+
+    /*!
+     * Saves or restores the sent and waited for events
+     *\param s the snapshot
+     */
+    void serialize(Snapshot&);
 };
 
 } /* namespace TrafficProfiles */
@@ -0,0 +1,274 @@
+/*
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ *
+ * Copyright (c) 2026 ARM Limited
+ * All rights reserved
+ *  Created on: Oct 18, 2026
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include "fast_forward.hh"
+#include "traffic_profile_manager.hh"
+#include "logger.hh"
+
+namespace TrafficProfiles {
+
+const uint64_t FastForward::maxPeriod;
+const uint64_t FastForward::minBackoff;
+const uint64_t FastForward::maxBackoff;
+const uint64_t FastForward::margin;
+
+StateWalker::Sample::Sample(): time(0), eligible(true) {
+}
+
+StateWalker::StateWalker(const bool e):
+        mode(SAMPLE), exact(e), steps(nullptr), accelerations(nullptr),
+        periods(0), index(0) {
+}
+
+StateWalker::StateWalker(const vector<uint64_t>& s,
+                         const vector<uint64_t>& a, const uint64_t n,
+                         const bool e):
+        mode(ADVANCE), exact(e), steps(&s), accelerations(&a), periods(n),
+        index(0) {
+}
+
+uint64_t StateWalker::visit(const uint64_t v, const Kind k) {
+    if (mode == SAMPLE) {
+        sample.values.push_back(v);
+        sample.kinds.push_back(k);
+        ++index;
+        return v;
+    }
+    // unsigned wrap-around handles decreasing values
+    const uint64_t i = index++;
+    return v + periods * (*steps)[i] +
+            (*accelerations)[i] * (periods * (periods + 1) / 2);
+}
+
+void StateWalker::operator()(double& v, const Kind k) {
+    if (k == VALUE) {
+        uint64_t bits;
+        memcpy(&bits, &v, sizeof(bits));
+        visit(bits, VALUE);
+        return;
+    }
+    // integers are represented exactly up to 2^53
+    const double limit = (double)(1ULL << 53);
+    if (k == TIME || fabs(v) >= limit || (exact && v != floor(v))) {
+        reject();
+    }
+    const int64_t i = (mode == SAMPLE && (k == TIME || fabs(v) >= limit)) ?
+            0 : (int64_t)v;
+    const int64_t w = (int64_t)visit((uint64_t)i, LINEAR);
+    if (advancing()) {
+        // keeps the fraction of inexactly advanced values
+        v += (double)(w - i);
+    }
+}
+
+void StateWalker::operator()(Packet& p) {
+    uint64_t cmd = p.cmd(), time = p.time(), addr = p.addr(),
+             size = p.size(), uid = p.uid();
+    size_t fields = ((p.has_id() ? 1 : 0) | (p.has_stream_id() ? 2 : 0) |
+                     (p.has_iommu_id() ? 4 : 0) | (p.has_flow_id() ? 8 : 0) |
+                     (p.has_master_ref() ? 16 : 0) |
+                     (p.has_master_id() ? 32 : 0));
+    (*this)(cmd);
+    (*this)(time, TIME);
+    (*this)(addr, IDENTITY);
+    (*this)(size);
+    (*this)(uid, IDENTITY);
+    (*this)(fields);
+    if (mode == SAMPLE) {
+        for (uint64_t f : { p.id(), p.stream_id(), (uint64_t)p.iommu_id(),
+                            p.flow_id(), p.master_ref() }) {
+            (*this)(f);
+        }
+    } else {
+        index += 5;
+        p.set_time(time);
+        p.set_addr(addr);
+        if (p.has_uid()) {
+            p.set_uid(uid);
+        }
+    }
+}
+
+void StateWalker::bound(const uint64_t lower, const uint64_t upper) {
+    if (mode == SAMPLE) {
+        sample.bounds.emplace_back(index - 1, make_pair(lower, upper));
+    }
+}
+
+void StateWalker::deadline(const uint64_t t) {
+    if (mode == SAMPLE) {
+        sample.deadlines.push_back(t);
+    }
+}
+
+void StateWalker::multipleOf(const uint64_t m) {
+    if (mode == SAMPLE && m > 1) {
+        sample.multiples.push_back(m);
+    }
+}
+
+void StateWalker::reject() {
+    sample.eligible = false;
+}
+
+FastForward::FastForward(TrafficProfileManager* t):
+        tpm(t), enabled(false), wakeups(0), nextAttempt(0),
+        backoff(minBackoff), skips(0), skippedPeriods(0), skippedTime(0) {
+}
+
+void FastForward::enable() {
+    enabled = true;
+}
+
+void FastForward::disable() {
+    enabled = false;
+    window.clear();
+}
+
+void FastForward::reset() {
+    window.clear();
+    wakeups = nextAttempt = 0;
+    backoff = minBackoff;
+    skips = skippedPeriods = skippedTime = 0;
+}
+
+bool FastForward::periodic(const StateWalker::Sample& z,
+                           const StateWalker::Sample& a,
+                           const StateWalker::Sample& b,
+                           const StateWalker::Sample& c) {
+    const uint64_t period = c.time - b.time;
+    if (period == 0 || b.time - a.time != period ||
+        a.time - z.time != period || z.values.size() != c.values.size() ||
+        a.values.size() != c.values.size() ||
+        b.values.size() != c.values.size() ||
+        z.kinds != c.kinds || a.kinds != c.kinds) {
+        return false;
+    }
+    for (auto m : c.multiples) {
+        if (period % m != 0) {
+            return false;
+        }
+    }
+    for (uint64_t i = 0; i < c.values.size(); ++i) {
+        const uint64_t step = c.values[i] - b.values[i];
+        const uint64_t prev = b.values[i] - a.values[i];
+        if (c.kinds[i] == StateWalker::QUADRATIC) {
+            if (step - prev != prev - (a.values[i] - z.values[i])) {
+                return false;
+            }
+            continue;
+        }
+        if (prev != step || a.values[i] - z.values[i] != step) {
+            return false;
+        }
+        switch (c.kinds[i]) {
+        case StateWalker::VALUE:
+            if (step != 0) {
+                return false;
+            }
+            break;
+        case StateWalker::TIME:
+            if (step != 0 && step != period) {
+                return false;
+            }
+            break;
+        default:
+            break;
+        }
+    }
+    return true;
+}
+
+uint64_t FastForward::periods(const StateWalker::Sample& b,
+                              const StateWalker::Sample& c) {
+    const uint64_t period = c.time - b.time;
+    uint64_t n = numeric_limits<uint64_t>::max() / 2 / period;
+    for (auto& l : c.bounds) {
+        const uint64_t v = c.values[l.first];
+        const uint64_t lower = l.second.first, upper = l.second.second;
+        const int64_t step = (int64_t)(v - b.values[l.first]);
+        if (v < lower || v >= upper) {
+            return 0;
+        } else if (step > 0) {
+            n = min<uint64_t>(n, (upper - 1 - v) / step);
+        } else if (step < 0) {
+            n = min<uint64_t>(n, (v - lower) / -step);
+        }
+    }
+    for (auto t : c.deadlines) {
+        n = min<uint64_t>(n, t > c.time ? (t - c.time) / period : 0);
+    }
+    // fixed future times, e.g. scheduled events, end the regime
+    for (uint64_t i = 0; i < c.values.size(); ++i) {
+        if (c.kinds[i] == StateWalker::TIME && c.values[i] > c.time &&
+            c.values[i] == b.values[i]) {
+            n = min<uint64_t>(n, (c.values[i] - c.time - 1) / period);
+        }
+    }
+    return (n > margin ? n - margin : 0);
+}
+
+void FastForward::retry(const bool success) {
+    window.clear();
+    backoff = (success ? minBackoff : min(backoff * 2, maxBackoff));
+    nextAttempt = wakeups + backoff;
+}
+
+bool FastForward::attempt() {
+    StateWalker sampler;
+    tpm->walk(sampler);
+    auto& sample = sampler.getSample();
+    if (!sample.eligible) {
+        retry(false);
+        return false;
+    }
+    sample.time = tpm->getTime();
+    window.push_back(move(sample));
+    if (window.size() < 3 * maxPeriod + 1) {
+        return false;
+    }
+
+    const auto& c = window.back();
+    for (uint64_t w = 1; w <= maxPeriod; ++w) {
+        const auto& b = window[window.size() - 1 - w];
+        const auto& a = window[window.size() - 1 - 2 * w];
+        const auto& z = window[window.size() - 1 - 3 * w];
+        if (!periodic(z, a, b, c)) {
+            continue;
+        }
+        const uint64_t n = periods(b, c);
+        if (n == 0) {
+            break;
+        }
+        vector<uint64_t> steps(c.values.size()), accelerations(steps.size());
+        for (uint64_t i = 0; i < steps.size(); ++i) {
+            steps[i] = c.values[i] - b.values[i];
+            if (c.kinds[i] == StateWalker::QUADRATIC) {
+                accelerations[i] = steps[i] - (b.values[i] - a.values[i]);
+            }
+        }
+        const uint64_t period = c.time - b.time;
+        StateWalker advancer(steps, accelerations, n);
+        tpm->walk(advancer);
+        LOG("FastForward::attempt period of", w, "wakeups",
+            "and", period, "time units, advanced by", n, "periods to",
+            tpm->getTime());
+        ++skips;
+        skippedPeriods += n;
+        skippedTime += n * period;
+        retry(true);
+        return true;
+    }
+    retry(false);
+    return false;
+}
+
+} // end of namespace
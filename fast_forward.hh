@@ -0,0 +1,365 @@
+/*
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ *
+ * Copyright (c) 2026 ARM Limited
+ * All rights reserved
+ *  Created on: Oct 18, 2026
+ */
+
+#ifndef __AMBA_TRAFFIC_PROFILE_FAST_FORWARD_HH__
+#define __AMBA_TRAFFIC_PROFILE_FAST_FORWARD_HH__
+
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "proto/tp_packet.pb.h"
+
+using namespace std;
+
+namespace TrafficProfiles {
+
+class TrafficProfileManager;
+
+/*!
+ *\brief Engine state walker
+ *
+ * Engine modules walk their whole dynamic state through a walker,
+ * declaring how each value evolves when the engine runs in a periodic
+ * regime. The same walk either samples the state, or advances it by a
+ * number of periods.
+ *
+ * Inexact walks advance the state approximately, for sampling: only
+ * the state which can't be extrapolated, e.g. when needed to observe
+ * every event, rejects them.
+ */
+class StateWalker {
+
+public:
+
+    //! How a state value evolves from a period to the next
+    enum Kind : uint8_t {
+        VALUE,  //!< the value repeats
+        TIME,   //!< ATP time, constant or advancing by the period duration
+        LINEAR, //!< advances by a constant step (counters, addresses, UIDs)
+        QUADRATIC, //!< accumulates a LINEAR value (cumulative statistics)
+        IDENTITY //!< identifies in-flight state (UIDs, packet addresses),
+                 //!< LINEAR if exact, constant otherwise
+    };
+
+    //! Walk mode
+    enum Mode { SAMPLE, ADVANCE };
+
+    //! Sampled engine state
+    struct Sample {
+        //! ATP time of the sample
+        uint64_t time;
+        //! sampled values, in walk order
+        vector<uint64_t> values;
+        //! kind of the sampled values
+        vector<uint8_t> kinds;
+        //! LINEAR value index -> [lower, upper) bounds of the regime
+        vector<pair<uint64_t, pair<uint64_t, uint64_t>>> bounds;
+        //! ATP times at which the regime ends
+        vector<uint64_t> deadlines;
+        //! the period duration must be a multiple of these
+        vector<uint64_t> multiples;
+        //! false if the state can't be fast-forwarded
+        bool eligible;
+
+        //! Default constructor
+        Sample();
+    };
+
+protected:
+
+    //! walk mode
+    const Mode mode;
+
+    //! whether the state must be advanced exactly
+    const bool exact;
+
+    //! sampled state, in SAMPLE mode
+    Sample sample;
+
+    //! per value step, in ADVANCE mode
+    const vector<uint64_t>* steps;
+
+    //! per value step increase, in ADVANCE mode
+    const vector<uint64_t>* accelerations;
+
+    //! number of periods to advance by, in ADVANCE mode
+    uint64_t periods;
+
+    //! index of the next visited value
+    uint64_t index;
+
+    /*!
+     * Visits a raw value
+     *\param v the value
+     *\param k the value kind
+     *\return the value, advanced if in ADVANCE mode
+     */
+    uint64_t visit(const uint64_t, const Kind);
+
+public:
+
+    /*!
+     * Creates a walker sampling the state
+     *\param e whether the state must be advanced exactly
+     */
+    StateWalker(const bool = true);
+
+    /*!
+     * Creates a walker advancing the state
+     *\param s per value step, as sampled over the last period
+     *\param a per value step increase from a period to the next
+     *\param n number of periods to advance by
+     *\param e whether the state must be advanced exactly
+     */
+    StateWalker(const vector<uint64_t>&, const vector<uint64_t>&,
+                const uint64_t, const bool = true);
+
+    //! Default destructor
+    virtual ~StateWalker() = default;
+
+    //! returns true if the walk advances the state
+    inline bool advancing() const { return mode == ADVANCE; }
+
+    //! returns true if the state must be advanced exactly
+    inline bool isExact() const { return exact; }
+
+    //! returns the sampled state
+    inline Sample& getSample() { return sample; }
+
+    /*!
+     * Walks an integral, boolean or enumeration value
+     *\param v the value
+     *\param k the value kind
+     */
+    template <typename T>
+    void operator()(T& v, const Kind k = VALUE) {
+        static_assert(is_integral<T>::value || is_enum<T>::value,
+                      "StateWalker walks integral values");
+        const uint64_t w = visit((uint64_t)v, k);
+        if (k != VALUE) {
+            v = (T)w;
+        }
+    }
+
+    /*!
+     * Walks a floating point value. LINEAR values must hold
+     * integers, so that they can be advanced exactly; inexact walks
+     * advance them by whole steps
+     *\param v the value
+     *\param k the value kind, TIME is not allowed
+     */
+    void operator()(double&, const Kind = VALUE);
+
+    /*!
+     * Walks the size of a container, which must repeat
+     *\param c the container
+     */
+    template <typename C>
+    inline void size(const C& c) {
+        visit(c.size(), VALUE);
+    }
+
+    /*!
+     * Walks a packet
+     *\param p the packet
+     */
+    void operator()(Packet&);
+
+    /*!
+     * Walks a map keyed by UIDs, rebuilding it in ADVANCE mode
+     *\param m the map
+     *\param f function walking a mapped value
+     */
+    template <typename V, typename F>
+    void uidMap(map<uint64_t, V>& m, F&& f) {
+        size(m);
+        map<uint64_t, V> advanced;
+        for (auto& e : m) {
+            uint64_t uid = e.first;
+            (*this)(uid, IDENTITY);
+            f(e.second);
+            if (advancing()) {
+                advanced.emplace(uid, e.second);
+            }
+        }
+        if (advancing()) {
+            m.swap(advanced);
+        }
+    }
+
+    /*!
+     * Bounds the regime: the last walked LINEAR value must stay within
+     * limits, e.g. a transactions counter and the configured total
+     *\param lower the value inclusive lower bound
+     *\param upper the value exclusive upper bound
+     */
+    void bound(const uint64_t, const uint64_t);
+
+    /*!
+     * Bounds the regime in time
+     *\param t the ATP time the regime ends at
+     */
+    void deadline(const uint64_t);
+
+    /*!
+     * Constrains the period duration, e.g. to keep rate update periods
+     * aligned
+     *\param m the period must be a multiple of this ATP time
+     */
+    void multipleOf(const uint64_t);
+
+    //! Marks the current state as not eligible for fast-forward
+    void reject();
+};
+
+/*!
+ *\brief ATP Engine time fast-forward
+ *
+ * Deterministic master/slave interactions (fixed latencies, fixed
+ * rates, linear addresses) settle into periodic regimes, where the
+ * engine repeats the same sequence of events every period, with times,
+ * addresses, UIDs and counters advancing by constant steps.
+ *
+ * When enabled, the engine state is sampled at every Kronos wakeup over
+ * a detection window: if the last four samples at a distance of one
+ * period are consistent with a periodic regime, the whole engine state
+ * and its statistics are advanced in bulk by as many periods as
+ * allowed before the regime ends (profile termination, address range
+ * wrap-around, frame time). Integer statistics advance exactly,
+ * floating point ones must either repeat or hold integer values, so
+ * that the fast-forwarded results are identical to a full run.
+ *
+ * States with random generators, checkers, rate controllers, packet
+ * tracing, timeline recording or engine self-profiling active are never
+ * fast-forwarded, as these need every event to be simulated.
+ */
+class FastForward {
+
+public:
+
+    //! Longest detected period, in wakeups
+    static const uint64_t maxPeriod = 32;
+
+    //! Wakeups between detection attempts, doubled on failures
+    static const uint64_t minBackoff = 256;
+
+    //! Maximum wakeups between detection attempts
+    static const uint64_t maxBackoff = 1 << 16;
+
+    //! Periods left to run before the regime ends
+    static const uint64_t margin = 2;
+
+protected:
+
+    //! Pointer to the TPM
+    TrafficProfileManager* const tpm;
+
+    //! whether fast-forward is enabled
+    bool enabled;
+
+    //! wakeups since enabled
+    uint64_t wakeups;
+
+    //! wakeup of the next detection attempt
+    uint64_t nextAttempt;
+
+    //! current wakeups between detection attempts
+    uint64_t backoff;
+
+    //! detection window samples
+    vector<StateWalker::Sample> window;
+
+    //! number of fast-forwards
+    uint64_t skips;
+
+    //! number of fast-forwarded periods
+    uint64_t skippedPeriods;
+
+    //! fast-forwarded ATP time
+    uint64_t skippedTime;
+
+    //! Samples the engine and fast-forwards it if periodic
+    bool attempt();
+
+    //! Schedules the next detection attempt
+    void retry(const bool);
+
+public:
+
+    /*!
+     * Checks whether four samples, one period apart, are consistent
+     * with a periodic regime
+     *\param z the first sample
+     *\param a the second sample
+     *\param b the third sample
+     *\param c the fourth sample
+     *\return true if the samples are periodic
+     */
+    static bool periodic(const StateWalker::Sample&,
+                         const StateWalker::Sample&,
+                         const StateWalker::Sample&,
+                         const StateWalker::Sample&);
+
+    /*!
+     * Computes how many periods can be fast-forwarded
+     *\param b the previous period sample
+     *\param c the current sample
+     *\return the number of periods
+     */
+    static uint64_t periods(const StateWalker::Sample&,
+                            const StateWalker::Sample&);
+
+    /*!
+     * Constructor
+     *\param t pointer to TPM
+     */
+    FastForward(TrafficProfileManager*);
+
+    //! Default destructor
+    virtual ~FastForward() = default;
+
+    //! Enables fast-forward
+    void enable();
+
+    //! Disables fast-forward
+    void disable();
+
+    //! Clears the detection window and the counters
+    void reset();
+
+    //! returns whether fast-forward is enabled
+    inline bool isEnabled() const { return enabled; }
+
+    /*!
+     * Attempts to fast-forward the engine, called by the TPM loop after
+     * each wakeup
+     *\return true if the engine time was advanced
+     */
+    inline bool step() {
+        if (__builtin_expect(enabled, 0) && ++wakeups >= nextAttempt) {
+            return attempt();
+        }
+        return false;
+    }
+
+    //! returns the number of fast-forwards
+    inline uint64_t getSkips() const { return skips; }
+
+    //! returns the number of fast-forwarded periods
+    inline uint64_t getSkippedPeriods() const { return skippedPeriods; }
+
+    //! returns the fast-forwarded ATP time
+    inline uint64_t getSkippedTime() const { return skippedTime; }
+};
+
+} // end of namespace
+
+#endif /* __AMBA_TRAFFIC_PROFILE_FAST_FORWARD_HH__ */
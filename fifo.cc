@@ -9,13 +9,18 @@
 #include "fifo.hh"
 #include "logger.hh"
 #include "traffic_profile_desc.hh"
+#include "traffic_profile_manager.hh"
+#include "fast_forward.hh"
+#include "snapshot.hh"
 #include <cmath>
+#include <limits>
 
 namespace TrafficProfiles {
 
 Fifo::Fifo():
         EventManager(),
-        profile(nullptr), type(Profile::READ),
+        profile(nullptr), profiler(&EngineProfiler::inactive),
+        profileId(InvalidId<uint64_t>()), type(Profile::READ),
         startupLevel(0), time(0), level(0), carry(0.),
         initialFillLevel(0), maxLevel(0), rate(0), period(0),
         inFlightData(0), firstActivation(false), firstActivationTime(0),
@@ -61,14 +66,18 @@ void Fifo::setup() {
     if (profile) {
         setTpm(profile->getTpm());
         setEventId(profile->getId());
+        // measure updates with the TPM engine self-profiler
+        if (profile->getTpm()) {
+            profiler = &profile->getTpm()->getEngineProfiler();
+            profileId = profile->getId();
+        }
         // import FIFO events from associated profile
-        for (auto& evMap : profile->getWaited()) {
-            for (auto& ev : evMap.second) {
-                if (Event::category[ev.type] == Event::FIFO_LEVEL) {
-                    LOG("Fifo::setup FIFO type", Profile::Type_Name(type),
-                            "importing profile event", ev);
-                    waitEvent(ev.type, ev.id);
-                }
+        for (auto& ev : profile->getWaited()) {
+            if (Event::category[ev.second] == Event::FIFO_LEVEL) {
+                LOG("Fifo::setup FIFO type", Profile::Type_Name(type),
+                        "importing profile event", Event::text[ev.second],
+                        "from", ev.first);
+                waitEvent(ev.second, ev.first);
             }
         }
     }
@@ -137,6 +146,18 @@ void Fifo::init(TrafficProfileDescriptor* d, const Profile::Type t,
 }
 
 
+void Fifo::setRate(const pair<uint64_t,uint64_t>& r) {
+    LOG("Fifo::setRate type",Profile::Type_Name(type),
+            "rate", rate, "period", period, "changed to",
+            r.first, "every", r.second, "at time", time);
+    tie(rate, period) = r;
+    // the level has been updated at the old rate till now:
+    // restart the update periods from the current time
+    if (firstActivation) {
+        firstActivationTime = time;
+    }
+}
+
 bool Fifo::receive(bool& underrun, bool& overrun, const uint64_t t, const uint64_t data) {
 
     bool ret = false;
@@ -178,7 +199,7 @@ bool Fifo::receive(bool& underrun, bool& overrun, const uint64_t t, const uint64
     }
 
     // update FIFO level
-    update(underrun, overrun, t);
+    profiledUpdate(underrun, overrun, t);
 
     // generate FIFO events if needed
     event();
@@ -336,7 +357,7 @@ Fifo::send(bool& underrun, bool& overrun, uint64_t& next,
     // set request originated time to now.
     request_time = t;
     // update FIFO level
-    update(underrun, overrun, t);
+    profiledUpdate(underrun, overrun, t);
 
     if (type == Profile::READ) {
         // if this is a READ traffic profile,
@@ -421,6 +442,19 @@ Fifo::send(bool& underrun, bool& overrun, uint64_t& next,
     return ok;
 }
 
+uint64_t Fifo::room(bool& underrun, bool& overrun, const uint64_t t) {
+    // update FIFO level
+    profiledUpdate(underrun, overrun, t);
+    if (maxLevel == 0) {
+        return numeric_limits<uint64_t>::max();
+    }
+    // mirrors the send conditions on the requested data
+    const uint64_t used = (type == Profile::READ ? level + inFlightData :
+                           inFlightData);
+    const uint64_t available = (type == Profile::READ ? maxLevel : level);
+    return (available > used ? available - used : 0);
+}
+
 bool Fifo::receiveEvent(const Event& e) {
     const string profileName =
                 profile ? profile->getName() : "UNINITIALIZED";
@@ -497,4 +531,57 @@ void Fifo::event() {
         emitEvent(Event::FIFO_FULL);
     }
 }
+
+void Fifo::walk(StateWalker& w) {
+    EventManager::walk(w);
+    w(type);
+    w(startupLevel);
+    w(time, StateWalker::TIME);
+    // unbounded READ FIFOs with no rate only accumulate data, which
+    // can't make them empty again: their level is a counter
+    const bool accumulating =
+            (type == Profile::READ && maxLevel == 0 && rate == 0);
+    w(level, accumulating ? StateWalker::LINEAR : StateWalker::VALUE);
+    w(carry);
+    w.size(tracker);
+    for (auto& t : tracker) {
+        w(t);
+    }
+    w(initialFillLevel);
+    w(maxLevel);
+    w(rate);
+    w(period);
+    w.size(ot);
+    for (auto& o : ot) {
+        w(o);
+    }
+    w(inFlightData);
+    w(firstActivation);
+    w(firstActivationTime);
+    w(linked);
+    w(active);
+    w(trackerEnabled);
+    // next transmission times are aligned to the update periods
+    if (rate > 0) {
+        w.multipleOf(period);
+    }
+}
+
+void Fifo::serialize(Snapshot& s) {
+    s(time);
+    s(level);    s(time);
+    // rate controllers change the rate at runtime
+    s(rate);
+    s(period);
+    s(level);
+    s(carry);
+    s(tracker);
+    s(initialFillLevel);
+    s(ot);
+    s(inFlightData);
+    s(firstActivation);
+    s(firstActivationTime);
+    s(active);
+}
+
 } /* namespace TrafficProfiles */
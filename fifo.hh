@@ -14,6 +14,7 @@
 #include <deque>
 #include <list>
 #include <set>
+#include "engine_profiler.hh"
 #include "event_manager.hh"
 #include "proto/tp_config.pb.h"
 
@@ -22,6 +23,8 @@ using namespace std;
 namespace TrafficProfiles {
 
 class TrafficProfileDescriptor;
+class StateWalker;
+class Snapshot;
 
 /*!
  *\brief Implements the ATP FIFO model
@@ -33,6 +36,9 @@ class TrafficProfileDescriptor;
  * and the data consumption rate the modelled device has
  */
 class Fifo: public EventManager {
+    // declare benchmark class as friend
+    friend class Bench;
+
   private:
 
     //! Error correction precision for the ATP FIFO (fraction of ATP time unit)
@@ -41,6 +47,12 @@ class Fifo: public EventManager {
     //! Pointer to parent TrafficProfileDescriptor object
     TrafficProfileDescriptor* profile;
 
+    //! Engine self-profiler, the TPM one if a parent profile is set
+    EngineProfiler* profiler;
+
+    //! Parent profile ID, for the engine self-profiler
+    uint64_t profileId;
+
     /*! FIFO type, can be either:
     *  - READ (consumes data, requests data from memory) or
     *  - WRITE (produces data, writes data to memory)
@@ -103,6 +115,18 @@ class Fifo: public EventManager {
      */
     void update(bool&, bool&, const uint64_t);
 
+    /*!
+     * Updates the FIFO, measured by the engine self-profiler
+     *\param underrun flag that signals an underrun occurred
+     *\param overrun flag that signals an overrun occurred
+     *\param t the current time
+     */
+    inline void profiledUpdate(bool& underrun, bool& overrun,
+                               const uint64_t t) {
+        profiler->measure(EngineProfiler::FIFO_UPDATE, profileId,
+                          [&] { update(underrun, overrun, t); });
+    }
+
     /*!
     * Returns whether the FIFO is empty
     *\return true if the FIFO is empty
@@ -149,6 +173,13 @@ class Fifo: public EventManager {
      */
     inline pair<uint64_t,uint64_t> getRate() const { return make_pair(rate,period);}
 
+    /*!
+     * Changes the FIFO fill/depletion rate at the
+     * time of the last FIFO update
+     *\param r the new fill/depletion rate and period
+     */
+    void setRate(const pair<uint64_t,uint64_t>&);
+
     /*!
      * Getter for the current OT count
      *\return the value of the current OT count
@@ -196,6 +227,16 @@ class Fifo: public EventManager {
      */
     bool send(bool&, bool&, uint64_t&, uint64_t&, const uint64_t, const uint64_t);
 
+    /*!
+     * Returns the data the FIFO can request at the current time
+     *  Also causes the FIFO to call its update function
+     *\param underrun flag that signals an underrun occurred
+     *\param overrun flag that signals an overrun occurred
+     *\param t the current time
+     *\return the bytes a request can be satisfied for,
+     *        the maximum value if the FIFO is unbounded
+     */
+    uint64_t room(bool&, bool&, const uint64_t);
     /*! Records a data response
      *  Also causes the FIFO to call its update function
      *\param underrun flag that signals an underrun occurred
@@ -234,6 +275,19 @@ class Fifo: public EventManager {
      *\return either READ or WRITE
      */
     Profile::Type getType() const { return type;}
+
+    /*!
+     * Walks the FIFO state for fast-forward
+     *\param w the state walker
+     */
+    void walk(StateWalker&);
+
+    /*!
+     * Saves or restores the FIFO runtime state. The rate is
+     * configured, or restored by the parent rate controller
+     *\param s the snapshot
+     */
+    void serialize(Snapshot&);
 };
 
 } /* namespace TrafficProfiles */
@@ -49,6 +49,8 @@ class ProfileGen(SimObject):
     init_only = Param.Bool(False, "Initialises ATP Engine but does not trigger an update immediately after")
     disable_watchdog = Param.Bool(False, "Disables ProfileGen watchdog")
     disable_mem_check = Param.Bool(False, "Disables check for ATP Engine valid physical memory addresses")
+    engine_profile = Param.Bool(False, "Enables the ATP Engine self-profiler, recorded in the atpEngineProfile stat")
+    timeline_atp = Param.Bool(False, "Records the ATP Engine activity timeline to atp_timeline.atptl in the output directory")
 
     def __init__(self, **kwargs):
         super(ProfileGen, self).__init__(**kwargs)
@@ -9,8 +9,11 @@
 
 #include "gem5/profile_gen.hh"
 
+#include <algorithm>
 #include <set>
+#include <string>
 #include <utility>
+#include <vector>
 
 #include "base/intmath.hh"
 #include "base/random.hh"
@@ -20,6 +23,7 @@
 #include "base/output.hh"
 #include "debug/ATP.hh"
 #include "debug/Checkpoint.hh"
+#include "debug/Drain.hh"
 #include "sim/sim_exit.hh"
 
 // ATP includes
@@ -47,7 +51,8 @@ ProfileGen::ProfileGen(const Params &p) :
         trackerLatency(p.tracker_latency),
         coreEngineDebug(p.core_engine_debug),
         initOnly(p.init_only), disableWatchdog(p.disable_watchdog),
-        disableMemCheck(p.disable_mem_check) {
+        disableMemCheck(p.disable_mem_check),
+        engineProfile(p.engine_profile), timelineAtp(p.timeline_atp) {
 
 
     // allocate ATP masters ports
@@ -100,6 +105,19 @@ void ProfileGen::init() {
         tpm.enableTrackerLatency();
     }
 
+    if (engineProfile) {
+        DPRINTF(ATP,"ProfileGen::%s enabling "
+                "ATP Engine self-profiler\n", __func__);
+        tpm.enableEngineProfile();
+    }
+
+    if (timelineAtp) {
+        const string file = simout.resolve("atp_timeline.atptl");
+        tpm.enableTimeline(file);
+        DPRINTF(ATP,"ProfileGen::%s recording ATP Engine activity "
+                "timeline to %s\n", __func__, file);
+    }
+
     if (traceAtp) {
         const string& outDir = simout.directory();
         tpm.enableTracer(outDir);
@@ -126,6 +144,8 @@ void ProfileGen::init() {
         if (port.size() > interface.size()) {
             uint64_t ports = interface.size();
             interface[id] = ports;
+            masterPort[m] = ports;
+            portMaster.push_back(m);
             DPRINTF(ATP,
                     "ProfileGen::%s Master %s connected to port %d\n",
                     __func__, m, interface[id]);
@@ -135,6 +155,8 @@ void ProfileGen::init() {
                     port.size());
         }
     }
+    portQueue.resize(portMaster.size());
+    portServed.resize(portMaster.size());
 
     // Register a callback to record ATP statistics
     statistics::registerDumpCallback([this]() { recordAtpStats(); });
@@ -152,25 +174,31 @@ ProfileGen::startup() {
 }
 
 DrainState ProfileGen::drain() {
-    if (!updateEvent.scheduled()) {
-        // no event has been scheduled yet (e.g. switched from atomic mode)
-        return DrainState::Drained;
+    // queued and stalled requests and outstanding responses aren't
+    // checkpointed, whilst the TPM snapshot counts them as sent: the
+    // updates send the queued requests only until these are done
+    if (!drained()) {
+        DPRINTF(Drain, "ProfileGen::%s draining %d queued requests, %d "
+                "stalled, responses outstanding %d\n", __func__, buffered,
+                retryPkt.size(), tpm.waiting());
+        scheduleUpdate();
+        return DrainState::Draining;
     }
-    if (retryPkt.empty()) {
-        // shut things down
-        nextPacketTick = MaxTick;
+    // shut things down
+    nextPacketTick = MaxTick;
+    if (updateEvent.scheduled()) {
         deschedule(updateEvent);
-        return DrainState::Drained;
-    } else {
-        return DrainState::Draining;
     }
+    return DrainState::Drained;
 }
 
-//TODO how do I serialize the TPM ? shall I just reload the config file?
-void ProfileGen::serialize(CheckpointOut &cp) const {
-    warn("ProfileGen::%s gem5 checkpoints support is not implemented in ATP",
-         __func__);
+void ProfileGen::drainResume() {
+    SimObject::drainResume();
+    // resume requesting packets to the TPM
+    if (!initOnly) scheduleUpdate();
+}
 
+void ProfileGen::serialize(CheckpointOut &cp) const {
     DPRINTF(Checkpoint, "ProfileGen::%s Serializing TrafficGen\n", __func__);
 
     // save next event tick
@@ -182,13 +210,17 @@ void ProfileGen::serialize(CheckpointOut &cp) const {
     SERIALIZE_SCALAR(nextEvent);
 
     SERIALIZE_SCALAR(nextPacketTick);
+
+    // the TPM runtime state - the configuration is reloaded from
+    // the same files on restore. Saving shares the restore code
+    // path, hence it isn't const, but leaves the TPM unchanged
+    const std::string data = const_cast<TrafficProfiles::
+            TrafficProfileManager&>(tpm).saveSnapshot();
+    std::vector<uint8_t> snapshot(data.begin(), data.end());
+    SERIALIZE_CONTAINER(snapshot);
 }
 
-// TODO how to unserialize the TPM?
 void ProfileGen::unserialize(CheckpointIn &cp) {
-    // TODO restore the TPM
-    warn("ProfileGen::%s gem5 checkpoints support is not implemented in ATP",
-         __func__);
     // restore scheduled events
     Tick nextEvent;
     UNSERIALIZE_SCALAR(nextEvent);
@@ -196,6 +228,18 @@ void ProfileGen::unserialize(CheckpointIn &cp) {
         scheduleUpdate(nextEvent);
     }
     UNSERIALIZE_SCALAR(nextPacketTick);
+
+    // restore the TPM runtime state
+    std::vector<uint8_t> snapshot;
+    UNSERIALIZE_CONTAINER(snapshot);
+    if (!tpm.restoreSnapshot(std::string(snapshot.begin(), snapshot.end()))) {
+        fatal("ProfileGen::%s unable to restore the ATP Engine snapshot, "
+              "was the checkpoint taken with the same configuration?\n",
+              __func__);
+    }
+    DPRINTF(Checkpoint, "ProfileGen::%s restored %u bytes ATP Engine "
+            "snapshot at ATP time %llu\n", __func__, snapshot.size(),
+            tpm.getTime());
 }
 
 MemCmd::Command ProfileGen::getGem5Command(const TrafficProfiles::Packet* p) const {
@@ -272,7 +316,7 @@ Packet* ProfileGen::buildGEM5Packet(const TrafficProfiles::Packet* p) {
     return pkt;
 }
 
-TrafficProfiles::Packet* ProfileGen::buildATPPacket(const Packet* p) {
+TrafficProfiles::Packet* ProfileGen::buildATPPacket(Packet* p) {
 
     TrafficProfiles::Packet * pkt = new TrafficProfiles::Packet();
 
@@ -406,71 +450,30 @@ void ProfileGen::watchDog(){
     }
 }
 
-void ProfileGen::addRoutingEntry(const TrafficProfiles::Packet* p) {
+void ProfileGen::addRoutingEntry(Packet* pkt,
+                                 const TrafficProfiles::Packet* p) {
 
-    RequestorID mId = system->getGlobalRequestorId(p->master_id());
+    pkt->pushSenderState(new RoutingState(p->uid()));
 
-    auto& masterTable = routingTable[mId];
-
-    auto addressTable = masterTable.find(p->addr());
-
-    if (addressTable == masterTable.end()) {
-        std::multimap<TrafficProfiles::Command, uint64_t> cmdMap;
-        masterTable.insert(std::make_pair(p->addr(), cmdMap));
-        addressTable = masterTable.find(p->addr());
-        DPRINTF(ATP, "ProfileGen::%s created address table for address %#X\n",
-                __func__, p->addr());
-    }
-    TrafficProfiles::Command cmd = p->cmd()==TrafficProfiles::READ_REQ?
-            TrafficProfiles::READ_RESP:TrafficProfiles::WRITE_RESP;
-    addressTable->second.insert(std::make_pair(cmd ,p->uid()));
-
-    DPRINTF(ATP, "ProfileGen::%s packet master %d uid %d address %#X, cmd "
-            "%s\n", __func__, mId, p->uid(), p->addr(),
-            TrafficProfiles::Command_Name(cmd));
+    DPRINTF(ATP, "ProfileGen::%s packet master %s uid %d address %#X, cmd "
+            "%s\n", __func__, p->master_id(), p->uid(), p->addr(),
+            TrafficProfiles::Command_Name(p->cmd()));
 }
 
-uint64_t ProfileGen::lookupAndRemoveRoutingEntry(const Packet* p) {
-    uint64_t ret = 0;
-
-    try {
-        // O(1) lookup in nested hashmaps
-        auto& masterTable = routingTable.at(p->req->requestorId());
-
-        auto addressTable = masterTable.find(p->getAddr());
+uint64_t ProfileGen::lookupAndRemoveRoutingEntry(Packet* p) {
 
-        DPRINTF(ATP, "ProfileGen::%s packet "
-                "master %d address %#X, size %d\n", __func__,
-                p->req->requestorId(), p->getAddr(), p->getSize());
-
-        if (addressTable != masterTable.end()) {
-            auto entry = addressTable->second.find(getAtpCommand(p));
-            ret = entry->second;
-            // remove UID entry
-            addressTable->second.erase(entry);
-            // clean-up if needed
-            if (addressTable->second.empty()) {
-                masterTable.erase(addressTable);
-            }
-            if (masterTable.empty()) {
-                routingTable.erase(routingTable.find(p->req->requestorId()));
-            }
-        } else {
-            DPRINTF(ATP, "ProfileGen::%s master table content for master %d\n",
-                    __func__, p->req->requestorId());
-
-            for (auto m = begin(masterTable); m!=end(masterTable); ++m) {
-                DPRINTF(ATP, "\t entry for address %#X, size %d\n",
-                        m->first, m->second.size());
-            }
-
-            throw std::out_of_range("Lookup failed in the UID routing");
-        }
-    }
-    catch (const std::out_of_range& o) {
-        fatal("ProfileGen::%s error %s packet %s", __func__, o.what(),
+    auto state = dynamic_cast<RoutingState*>(p->senderState);
+    if (!state) {
+        fatal("ProfileGen::%s error no UID attached to packet %s", __func__,
               p->print());
     }
+    p->popSenderState();
+    const uint64_t ret = state->uid;
+    delete state;
+
+    DPRINTF(ATP, "ProfileGen::%s packet master %d uid %d address %#X, "
+            "size %d\n", __func__, p->req->requestorId(), ret, p->getAddr(),
+            p->getSize());
 
     return ret;
 }
@@ -494,15 +497,30 @@ void ProfileGen::update() {
     // Avoid gem5 / ATP time conversion skews
     if (nextAtpTime == MaxTick) nextAtpTime = getAtpTime();
 
-    DPRINTF(ATP, "ProfileGen::%s requesting packets to AMBA TPM\n", __func__);
-    auto temp = tpm.send(locked, nextAtpTime, nextAtpTime);
-
-    localBuffer.insert(temp.begin(), temp.end());
+    // no new packets are requested while draining
+    const bool draining = (drainState() == DrainState::Draining);
+    std::multimap<std::string, TrafficProfiles::Packet*> temp;
+    if (!draining) {
+        DPRINTF(ATP, "ProfileGen::%s requesting packets to AMBA TPM\n",
+                __func__);
+        temp = tpm.send(locked, nextAtpTime, nextAtpTime);
+    }
+
+    // queue the packets on their master port, in generation order
+    for (auto& t : temp) {
+        auto mp = masterPort.find(t.first);
+        if (mp == masterPort.end()) {
+            fatal("ProfileGen::%s no port registered for ATP master %s",
+                  __func__, t.first);
+        }
+        portQueue[mp->second].push_back(t.second);
+    }
+    buffered += temp.size();
     DPRINTF(ATP, "ProfileGen::%s got %d packets [total buffered %d] from AMBA TPM\n",
-            __func__, temp.size(), localBuffer.size());
+            __func__, temp.size(), buffered);
 
-    // Invalidate when ATP Engine is blocked (nextAtpTime = 0)
-    if (!nextAtpTime)
+    // Invalidate when ATP Engine is blocked (nextAtpTime = 0) or draining
+    if (!nextAtpTime || draining)
         nextAtpTime = nextPacketTick = MaxTick;
     // update next packet ticks from ATP next time hint
     else
@@ -512,46 +530,44 @@ void ProfileGen::update() {
             __func__, nextPacketTick, nextAtpTime);
 
     uint64_t sent = 0;
-    // use a temporary master map to check which masters to serve
-    auto toServe = interface;
-    //  loop until all masters are busy or all ATP packets are depleted
-    auto i = toServe.begin();
-    while (!localBuffer.empty() && !toServe.empty()) {
-        RequestorID mId = i->first;
-        PortID pId = i->second;
-        string master = system->getRequestorName(mId);
-        // save current iterator and increment i, wrap at the end
-        auto current = i++;
-        if (i == toServe.end()) i = toServe.begin();
+    // serve the ports round-robin, one packet per port per round, until
+    // all ports are busy or all ATP packets are depleted
+    std::fill(portServed.begin(), portServed.end(), false);
+    uint64_t toServe = portQueue.size();
+    for (PortID pId = 0; buffered > 0 && toServe > 0;
+         pId = (pId + 1 == (PortID)portQueue.size() ? 0 : pId + 1)) {
+        if (portServed[pId]) {
+            continue;
+        }
+        auto& queue = portQueue[pId];
+        const std::string& master = portMaster[pId];
         DPRINTF(ATP,
-                "ProfileGen::%s checking packets for master %s [ID %d] port %d\n",
-                __func__, master, mId, pId);
-        // per each master in the packets ATP map, check if its port is free
-        // and if there's a packet to send on it
-        auto p = localBuffer.find(master);
+                "ProfileGen::%s checking packets for master %s port %d\n",
+                __func__, master, pId);
+        // check if the port is free and if there's a packet to send on it
         bool portBusy = retryPkt.find(pId) != retryPkt.end();
 
-        if (p!=localBuffer.end()) {
+        if (!queue.empty()) {
             // record how many packets queued per master on average
-            bufferedSum[interface[mId]]+=localBuffer.count(master);
-            bufferedCount[interface[mId]]++;
+            bufferedSum[pId] += queue.size();
+            bufferedCount[pId]++;
         }
 
-        if (p != localBuffer.end() && !portBusy) {
+        if (!queue.empty() && !portBusy) {
+            TrafficProfiles::Packet* p = queue.front();
 
             // suppress packets that are not destined for a memory
-            if (disableMemCheck || system->isMemAddr(p->second->addr())) {
-                retryPkt[pId] = buildGEM5Packet(p->second);
-                // add to the UID routing table
-                addRoutingEntry(p->second);
+            if (disableMemCheck || system->isMemAddr(p->addr())) {
+                retryPkt[pId] = buildGEM5Packet(p);
+                // attach the UID for response routing
+                addRoutingEntry(retryPkt[pId], p);
 
                 // access port for current ATP Master
                 auto &sendPort = port.at(pId);
                 DPRINTF(ATP,
                         "ProfileGen::%s attempting to send packet for "
                         "master %s with address %#X, on port %d still %d to send\n",
-                        __func__, master, p->second->addr(), pId,
-                        localBuffer.size());
+                        __func__, master, p->addr(), pId, buffered);
                 // attempt to send packet to corresponding master port
                 if (!sendPort->sendTimingReq(retryPkt[pId])) {
                     retryPktTick[pId] = curTick();
@@ -567,21 +583,23 @@ void ProfileGen::update() {
                     retryPktTick.erase(pId);
                 }
             } else {
-                DPRINTF(ATP, "Suppressed packet %d address %#X\n", p->second->cmd(),
-                        p->second->addr());
+                DPRINTF(ATP, "Suppressed packet %d address %#X\n", p->cmd(),
+                        p->addr());
                 suppressed = true;
-                suppressedAddress=std::to_string(p->second->addr());
+                suppressedAddress=std::to_string(p->addr());
             }
-            // remove packet from list
-            delete p->second;
-            localBuffer.erase(p);
+            // remove packet from queue
+            delete p;
+            queue.pop_front();
+            buffered--;
         } else {
             // this master's port is busy retransmitting or no packets
             // are available for it
-            toServe.erase(current);
+            portServed[pId] = true;
+            toServe--;
             if (portBusy) {
                 DPRINTF(ATP, "ProfileGen::%s master %s port %d busy retransmitting, queued packets %d\n",
-                        __func__, master,pId,localBuffer.count(master));
+                        __func__, master, pId, queue.size());
             } else {
                 DPRINTF(ATP, "ProfileGen::%s master %s port %d no packets "
                         "available\n", __func__, master, pId);
@@ -590,7 +608,7 @@ void ProfileGen::update() {
     }
     DPRINTF(ATP,
             "ProfileGen::%s sent %d packets, still to be sent %d, locked status is %d\n",
-            __func__, sent, localBuffer.size(), locked);
+            __func__, sent, buffered, locked);
 
     // update the TPM time if needed
     tpm.setTime(getAtpTime());
@@ -623,11 +641,16 @@ void ProfileGen::update() {
         }
     }
 
+    if (draining && drained()) {
+        DPRINTF(Drain, "ProfileGen::%s drained\n", __func__);
+        signalDrainDone();
+    }
+
     // if the TPM is not locked on waits and nextPacketTick is invalid,
     // it means there nothing more to transmit
     // unless we still have some data in the buffer (atpPackets)
     // exit the simulation if configured to do so
-    if ((suppressed && !outOfRangeAddresses)|| (exitWhenDone && retryPkt.empty() && localBuffer.empty()
+    if ((suppressed && !outOfRangeAddresses)|| (exitWhenDone && !draining && retryPkt.empty() && buffered == 0
             && (!locked) && (MaxTick == nextPacketTick)
             && !tpm.waiting())) {
         const std::string reason =
@@ -674,6 +697,21 @@ void ProfileGen::recordAtpStats() {
     }
     DPRINTF(ATP, "ProfileGen::%s ATP global stats: %s\n",
             __func__, tpm.getStats().dump());
+
+    // record ATP Engine self-profiler measurements
+    using TrafficProfiles::EngineProfiler;
+    const auto profile = tpm.getEngineProfile();
+    for (uint64_t i = 0; i < EngineProfiler::N_SECTIONS; ++i) {
+        const auto& t = profile.total.timers[i];
+        atpEngineProfile[2 * i] = t.calls;
+        atpEngineProfile[2 * i + 1] = profile.toNs(t.ticks);
+    }
+    for (uint64_t i = 0; i < EngineProfiler::N_COUNTERS; ++i) {
+        atpEngineProfile[2 * EngineProfiler::N_SECTIONS + i] =
+                profile.total.counters[i];
+    }
+    DPRINTF(ATP, "ProfileGen::%s ATP Engine profile: %s\n",
+            __func__, profile.dump());
 }
 
 void ProfileGen::recvReqRetry(const PortID idx) {
@@ -695,14 +733,9 @@ void ProfileGen::recvReqRetry(const PortID idx) {
             retryPktTick.erase(idx);
             retryTime[idx] += (delay / sim_clock::as_float::s);
 
-            if (drainState() == DrainState::Draining) {
-                // shut things down
-                nextPacketTick = MaxTick;
-                signalDrainDone();
-            } else {
-                // check if any Profile has been unlocked
-                scheduleUpdate();
-            }
+            // check if any Profile has been unlocked, or send the
+            // queued packets while draining
+            scheduleUpdate();
         } else {
             DPRINTF(ATP,"ProfileGen::%s WARNING!!: received retry at %d for busy port %d\n",
                     __func__, curTick(), idx);
@@ -800,6 +833,23 @@ void ProfileGen::regStats() {
         atpFinishTime.subname(m.second, master);
         atpRunTime.subname(m.second, master);
     }
+
+    // register ATP Engine self-profiler statistics
+    using TrafficProfiles::EngineProfiler;
+    atpEngineProfile.init(2 * EngineProfiler::N_SECTIONS +
+                          EngineProfiler::N_COUNTERS)
+            .name(name() + ".atpEngineProfile").desc(
+            "ATP Engine self-profiler section calls and time (ns), "
+            "and counters");
+    for (uint64_t i = 0; i < EngineProfiler::N_SECTIONS; ++i) {
+        const string& s = EngineProfiler::sectionText[i];
+        atpEngineProfile.subname(2 * i, s + "_calls");
+        atpEngineProfile.subname(2 * i + 1, s + "_ns");
+    }
+    for (uint64_t i = 0; i < EngineProfiler::N_COUNTERS; ++i) {
+        atpEngineProfile.subname(2 * EngineProfiler::N_SECTIONS + i,
+                                 EngineProfiler::counterText[i]);
+    }
 }
 
 void
@@ -11,6 +11,7 @@
 #define __AMBA_PROFILE_GEN_HH__
 
 // std includes
+#include <deque>
 #include <map>
 #include <memory>
 #include <fstream>
@@ -186,8 +187,20 @@ protected:
     //! Master to port mapping
     std::map<gem5::RequestorID, gem5::PortID> interface;
 
-    //! Packets waiting to be sent, organised per master
-    std::multimap<std::string, TrafficProfiles::Packet*> localBuffer;
+    //! ATP master name to port mapping, resolves the engine packets
+    std::unordered_map<std::string, gem5::PortID> masterPort;
+
+    //! ATP master name per port
+    std::vector<std::string> portMaster;
+
+    //! Packets waiting to be sent, one FIFO queue per port
+    std::vector<std::deque<TrafficProfiles::Packet*>> portQueue;
+
+    //! Total number of packets waiting to be sent
+    uint64_t buffered{ 0 };
+
+    //! Ports not to be served anymore during the current update
+    std::vector<bool> portServed;
 
     //! Pointer to packet stalled on the ProfileGenPorts
     std::map<gem5::PortID, gem5::Packet*> retryPkt;
@@ -195,16 +208,29 @@ protected:
     //! Tick when the stalled packet was meant to be sent
     std::map<gem5::PortID, gem5::Tick> retryPktTick;
 
+    /*!
+     * Returns whether no requests are queued or stalled
+     * and no responses are outstanding
+     *\return true if drained
+     */
+    inline bool drained() const {
+        return retryPkt.empty() && buffered == 0 && !tpm.waiting();
+    }
+
     /*!\brief UID-based routing support (optional)
      * If UID-based routing is enabled, ATP Engine will route
      * responses faster by exploiting the GID information
      * maintained by this adaptor
      *
-     * the table is built as RequestorID, Address, Command, Request UID
+     * the request UID travels with the GEM5 packet as sender state,
+     * so that responses are matched without any table lookup
      */
-    std::map<gem5::RequestorID, std::multimap<uint64_t,
-        std::multimap<TrafficProfiles::Command, uint64_t>>> routingTable;
-
+    struct RoutingState : public gem5::Packet::SenderState {
+        //! ATP request UID
+        const uint64_t uid;
+        //! Constructor
+        RoutingState(const uint64_t u) : uid(u) { }
+    };
 
     //! Event for scheduling updates
     gem5::EventWrapper<ProfileGen, &ProfileGen::update> updateEvent;
@@ -274,6 +300,9 @@ protected:
     //! ATP masters run time
     gem5::statistics::Vector atpRunTime;
 
+    //! ATP Engine self-profiler section calls and time (ns), and counters
+    gem5::statistics::Vector atpEngineProfile;
+
     //! Enables the ATP to exit simulation if all profiles are depleted
     const bool exitWhenDone;
 
@@ -309,6 +338,10 @@ protected:
     const bool disableWatchdog;
     //! Disables check for ATP Engine valid physical memory addresses
     const bool disableMemCheck;
+    //! Enables the ATP Engine self-profiler
+    const bool engineProfile;
+    //! Records the ATP Engine activity timeline
+    const bool timelineAtp;
 
     //! Stores the last tick used to dump an M3I packet
     uint64_t traceM3iLastTick{ 0 };
@@ -341,21 +374,22 @@ protected:
      *\param p pointer to GEM5 packet
      *\return pointer to ATP packet
      */
-    TrafficProfiles::Packet* buildATPPacket(const gem5::Packet* );
+    TrafficProfiles::Packet* buildATPPacket(gem5::Packet* );
 
     /*!
-     * inserts an entry into the ATP UID routing table
+     * attaches the ATP request UID to a GEM5 packet
+     *\param pkt GEM5 Packet to be sent
      *\param p ATP Packet to be processed
      */
-    void addRoutingEntry(const TrafficProfiles::Packet*);
+    void addRoutingEntry(gem5::Packet*, const TrafficProfiles::Packet*);
 
     /*!
-    * Looks up an entry into the ATP UID routing table,
-    * removes it and returns the corresponding UID
+    * Removes the ATP request UID attached to a GEM5 packet
+    * and returns it
     *\param p GEM5 Packet to be looked up
     *\return the corresponding UID
     */
-    uint64_t lookupAndRemoveRoutingEntry(const gem5::Packet*);
+    uint64_t lookupAndRemoveRoutingEntry(gem5::Packet*);
 
     /*!
      * Gets the corresponding gem5 memory command given an ATP packet
@@ -398,6 +432,8 @@ public:
     virtual void startup() override;
     //! Starts draining the Profile Generator
     gem5::DrainState drain() override;
+    //! Resumes the Profile Generator after a drain
+    void drainResume() override;
     /*!
      * Serializes to checkpoint
      *\param cp reference to the checkpoint
@@ -8,9 +8,12 @@
  *
  */
 
+#include <algorithm>
 #include <queue>
 #include "kronos.hh"
 #include "traffic_profile_manager.hh"
+#include "fast_forward.hh"
+#include "snapshot.hh"
 #include "logger.hh"
 
 namespace TrafficProfiles {
@@ -33,6 +36,13 @@ void Kronos::init() {
             calendar.size());
 }
 
+void Kronos::reset() {
+    calendar.clear();
+    epoch = bucket = counter = 0;
+    initialized = false;
+    LOG("Kronos reset");
+}
+
 Kronos::~Kronos() {
 }
 
@@ -48,7 +58,7 @@ void Kronos::schedule(const Event ev) {
         if (!l.empty()) {
             auto pos = begin(l);
             // search for position where to insert element;
-            while (pos->time < ev.time && pos != end(l))
+            while (pos != end(l) && pos->time < ev.time)
                 pos++;
             l.insert(pos, ev);
         } else {
@@ -115,25 +125,104 @@ void Kronos::get(list<Event>& q) {
         LOG("Kronos::get found", q.size(), "events triggered at time", time,
                 "still active events", counter);
         // update current epoch and bucket
-        uint64_t new_epoch = target_epoch;
-        uint64_t new_bucket = target_bucket;
-
-        // skip empty buckets
-        while ((counter>0) && calendar.at(new_bucket).empty()) {
-            if (++new_bucket >= calendar.size()) {
-                new_bucket=0;
-                new_epoch++;
-            }
-        }
-
-        epoch = new_epoch;
-        bucket = new_bucket;
-        LOG("Kronos::get setting epoch to",epoch,"bucket to",bucket);
+        seek(target_epoch, target_bucket);
     } else {
         ERROR("Kronos::get Kronos uninitialized");
     }
 }
 
+void Kronos::seek(uint64_t e, uint64_t b) {
+    // skip empty buckets
+    while ((counter>0) && calendar.at(b).empty()) {
+        if (++b >= calendar.size()) {
+            b=0;
+            e++;
+        }
+    }
+
+    epoch = e;
+    bucket = b;
+    LOG("Kronos::seek setting epoch to",epoch,"bucket to",bucket);
+}
+
+void Kronos::walk(StateWalker& w) {
+    if (!initialized) {
+        w.reject();
+        return;
+    }
+    // buckets shift consistently only by whole bucket widths,
+    // inexact walks relocate the calendar position instead
+    if (w.isExact()) {
+        w.multipleOf(bucketWidth);
+    }
+    // the calendar position advances with time
+    uint64_t position = epoch * calendar.size() + bucket;
+    w(position, StateWalker::LINEAR);
+
+    // visit events in time order: buckets are sorted by time, hence
+    // the stable sort preserves the order of simultaneous events
+    vector<const Event*> events;
+    events.reserve(counter);
+    for (auto& b : calendar) {
+        for (auto& e : b) {
+            events.push_back(&e);
+        }
+    }
+    stable_sort(events.begin(), events.end(),
+                [](const Event* a, const Event* b) {
+                    return a->time < b->time;
+                });
+    w.size(events);
+    list<Event> advanced;
+    for (auto* e : events) {
+        uint64_t type = e->type, action = e->action, id = e->id,
+                 time = e->time;
+        w(type);
+        w(action);
+        // packet events are identified by the packet UID
+        w(id, StateWalker::IDENTITY);
+        w(time, StateWalker::TIME);
+        if (w.advancing()) {
+            advanced.emplace_back(e->type, e->action, id, time);
+        }
+    }
+
+    if (w.advancing()) {
+        for (auto& b : calendar) {
+            b.clear();
+        }
+        counter = 0;
+        // schedule inserts ahead of simultaneous events
+        for (auto e = advanced.rbegin(); e != advanced.rend(); ++e) {
+            schedule(*e);
+        }
+        if (!w.isExact()) {
+            position = tpm->getTime() / bucketWidth;
+        }
+        epoch = position / calendar.size();
+        bucket = position % calendar.size();
+        LOG("Kronos::walk advanced to epoch",epoch,"bucket",bucket,
+                "total events",counter);
+    }
+}
+
+void Kronos::serialize(Snapshot& s) {
+    uint64_t width = bucketWidth, buckets = calendar.size();
+    s(width);
+    s(buckets);
+    if (width != bucketWidth || buckets != calendar.size()) {
+        WARN("Kronos::serialize snapshot calendar of", buckets,
+             "buckets of width", width, "doesn't match the configured",
+             calendar.size(), "buckets of width", bucketWidth);
+        s.invalidate();
+        return;
+    }
+    s(calendar);
+    s(epoch);
+    s(bucket);
+    s(counter);
+}
+
 uint64_t Kronos::next() const {
     uint64_t ret = 0;
     if (initialized) {
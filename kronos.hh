@@ -20,6 +20,8 @@ using namespace std;
 namespace TrafficProfiles {
 
 class TrafficProfileManager;
+class StateWalker;
+class Snapshot;
 
 /*!
  *\brief Kronos is the simulation engine for ATP
@@ -82,6 +84,14 @@ protected:
     //! initialization flag
     bool initialized;
 
+    /*!
+     * Sets the current epoch and bucket, skipping
+     * forward to the first non-empty bucket
+     *\param e the epoch
+     *\param b the bucket
+     */
+    void seek(uint64_t, uint64_t);
+
 public:
 
     /*!
@@ -96,6 +106,13 @@ public:
      */
     void init();
 
+    /*!
+     * Drops all scheduled events and marks Kronos
+     * as uninitialized, so that it is initialized
+     * again from the TPM on next use
+     */
+    void reset();
+
     /*!
      * Kronos destructor
      */
@@ -140,6 +157,21 @@ public:
     inline const bool& isInitialized() const {
         return initialized;
     }
+
+    /*!
+     * Walks the scheduled events for fast-forward: in ADVANCE
+     * mode, the calendar is rebuilt with the advanced events,
+     * preserving the order of events scheduled at the same time
+     *\param w the state walker
+     */
+    void walk(StateWalker&);
+
+    /*!
+     * Saves or restores the calendar queue, which must
+     * have the same geometry in the restored engine
+     *\param s the snapshot
+     */
+    void serialize(Snapshot&);
 };
 
 } /* namespace TrafficProfiles */
@@ -11,7 +11,7 @@
 
 namespace TrafficProfiles {
 
-Logger* Logger::instance = nullptr;
+thread_local Logger* Logger::threadInstance = nullptr;
 
 const string Logger::RED = "\x1b[31m";
 const string Logger::GREEN =  "\x1b[32m";
@@ -23,18 +23,26 @@ const string Logger::COLOR_RESET = "\x1b[0m";
 
 
 Logger* Logger::get() {
-    if (instance == nullptr) {
+    if (threadInstance != nullptr) {
+        return threadInstance;
+    }
+    // thread-safe lazy initialisation
 #ifdef LOG_FILE
-        // the global Logger entity, configured to log to file
-        instance = new FileLogger(LOG_FILE, LOG_LEVEL);
+    // the global Logger entity, configured to log to file
+    static Logger* const instance = new FileLogger(LOG_FILE, LOG_LEVEL);
 #else
-        // the default global Logger entity, configured to log to standard output
-        instance = new Logger(&cout, LOG_LEVEL);
+    // the default global Logger entity, configured to log to standard output
+    static Logger* const instance = new Logger(&cout, LOG_LEVEL);
 #endif
-    }
     return instance;
 }
 
+Logger* Logger::setThreadLogger(Logger* l) {
+    Logger* previous = threadInstance;
+    threadInstance = l;
+    return previous;
+}
+
 FileLogger::FileLogger(const string& fileName, const Level lvl):
         Logger(&cout, LOG_LEVEL) {
     level = lvl;
@@ -13,15 +13,34 @@
 #include <unistd.h>
 #include <iostream>
 #include <fstream>
+#include <sstream>
+#include <stdexcept>
 #include <string>
 
 using namespace std;
 
 namespace TrafficProfiles {
+
+/*!
+ *\brief ATP Engine error
+ *
+ * Thrown by ERROR when the logger is configured to throw on errors,
+ * so that callers running several engines can recover from a failed
+ * one. The engine which raised it is left in an undefined state and
+ * has to be reset or discarded.
+ */
+class EngineError : public runtime_error {
+public:
+    using runtime_error::runtime_error;
+};
+
 /*!
  *\brief ATP Logger class
  *
- * ATP Logger base class to write logging messages to ostreams
+ * ATP Logger base class to write logging messages to ostreams.
+ * The process-wide logger can be overridden per thread, so that
+ * engines running concurrently have their own verbosity, output
+ * and error handling.
  */
 class Logger {
 public:
@@ -53,8 +72,8 @@ protected:
     //! Colour reset ANSI code
     static const string COLOR_RESET;
 
-    //! Singleton logger object pointer
-    static Logger* instance;
+    //! Calling thread logger, overrides the process-wide one if set
+    static thread_local Logger* threadInstance;
 
     //! Configured verbosity level
     Level  level;
@@ -64,6 +83,8 @@ protected:
     bool colours;
     //! Flag to enable exit on errors
     bool exitOnErrors;
+    //! Flag to throw an EngineError on errors
+    bool throwOnErrors;
 
     /*!
      *  variadic template logger - recursive body
@@ -82,32 +103,41 @@ protected:
      *\param lvl the logging level this message has
      */
     inline virtual void _log(const Level lvl){
-        if (get()->out){
-            if (getColours() && (lvl!=DEBUG_LEVEL)) *(get()->out) << COLOR_RESET;
-            if (lvl!=PROMPT_LEVEL) (*(get()->out)) << endl;
+        if (out){
+            if (getColours() && (lvl!=DEBUG_LEVEL)) *out << COLOR_RESET;
+            if (lvl!=PROMPT_LEVEL) *out << endl;
         }
     }
 
+    /*!
+     * Default Constructor
+     */
+    Logger() = delete;
+
+public:
+
     /*!
      * Constructor
      *\param o address of the ostream to be used
      *\param lvl the verbosity level to be configured
      */
     Logger(ostream* o, const Level lvl):level(lvl), out(o),
-            colours(false), exitOnErrors(true) {}
+            colours(false), exitOnErrors(true), throwOnErrors(false) {}
 
     /*!
-     * Default Constructor
+     * Logger object accessor
+     *\return the calling thread logger if set,
+     * the process-wide logger otherwise
      */
-    Logger() = delete;
-
-public:
+    static Logger *get();
 
     /*!
-     * Singleton Logger object accessor
-     *\return the only instance of the logger object
+     * Sets the calling thread logger, which overrides the
+     * process-wide one. The logger is not owned.
+     *\param l the thread logger, nullptr to use the process-wide one
+     *\return the previous thread logger
      */
-    static Logger *get();
+    static Logger *setThreadLogger(Logger*);
 
     /*!
      * Logging level setter method
@@ -153,6 +183,19 @@ public:
      */
     inline bool getExitOnErrors() const {return exitOnErrors;}
 
+    /*!
+     * Sets the throwOnErrors flag: if set, errors throw an
+     * EngineError instead of exiting
+     *\param t flag value
+     */
+    inline void setThrowOnErrors(const bool t) {throwOnErrors = t;}
+
+    /*!
+     * Gets the value of the throwOnErrors flag
+     *\returns throwOnErrors flag value
+     */
+    inline bool getThrowOnErrors() const {return throwOnErrors;}
+
     /*!
      *  Variadic template logger - helper function
      *  start a recursive chain to print all the variadic
@@ -165,6 +208,14 @@ public:
     template <class ...Tail>
     void log(const Level lvl, Tail&&... args);
 
+    /*!
+     *  Logs an error message, then either throws an EngineError
+     *  or exits, as configured
+     *\param args all the arguments of the variadic function
+     */
+    template <class ...Tail>
+    void error(Tail&&... args);
+
 
     //! Default destructor
     virtual ~Logger(){}
@@ -204,22 +255,22 @@ public:
 // variadic logger, helper function implementation
 template <class ...Tail>
 void Logger::log(const Level lvl, Tail&&... args) {
-    if ((get()->out) && (lvl >= level)) {
+    if (out && (lvl >= level)) {
         switch(lvl) {
         case ERROR_LEVEL:
-            if (getColours()) *(get()->out) << RED;
-            *(get()->out) << "ERROR:";
+            if (getColours()) *out << RED;
+            *out << "ERROR:";
             break;
         case WARNING_LEVEL:
-            if (getColours()) *(get()->out) << YELLOW;
-            *(get()->out) << "WARNING:";
+            if (getColours()) *out << YELLOW;
+            *out << "WARNING:";
             break;
         case PRINT_LEVEL:
-            if (getColours()) *(get()->out) << CYAN;
+            if (getColours()) *out << CYAN;
             break;
         case PROMPT_LEVEL:
-            if (getColours()) *(get()->out) << MAGENTA;
-            *(get()->out) << "#engine>";
+            if (getColours()) *out << MAGENTA;
+            *out << "#engine>";
             break;
         case DEBUG_LEVEL: //intentional fall through
         default: break;
@@ -232,16 +283,29 @@ void Logger::log(const Level lvl, Tail&&... args) {
 // variadic logger recursive body implementation
 template <class T, class ...Tail>
 void Logger::_log(const Level lvl,T head, Tail&&... tail){
-    *(get()->out) << " " << head ;
+    *out << " " << head ;
     _log(lvl, std::forward<Tail>(tail)...);
 }
 
+// variadic error implementation
+template <class ...Tail>
+void Logger::error(Tail&&... args) {
+    log(ERROR_LEVEL, args...);
+    if (throwOnErrors) {
+        ostringstream message;
+        message << "ERROR:";
+        ((message << " " << args), ...);
+        throw EngineError(message.str());
+    } else if (exitOnErrors) {
+        exit(1);
+    }
+}
+
 
 // global logger macros - change LOG_LEVEL to hard code verbosity
 #define LOG_LEVEL Logger::ERROR_LEVEL
 #define ERROR(...)  do { if (Logger::get()->getLevel()<=Logger::ERROR_LEVEL) \
-        { Logger::get()->log(Logger::ERROR_LEVEL,__VA_ARGS__); \
-        if (Logger::get()->getExitOnErrors()) exit(1); } } while (false)
+        Logger::get()->error(__VA_ARGS__); } while (false)
 #define WARN(...)   do { if (Logger::get()->getLevel()<=Logger::WARNING_LEVEL) \
         Logger::get()->log(Logger::WARNING_LEVEL,__VA_ARGS__); } while (false)
 #define LOG(...)    do { if (Logger::get()->getLevel()<=Logger::DEBUG_LEVEL) \
@@ -12,6 +12,8 @@
 #include "logger.hh"
 #include "traffic_profile_desc.hh"
 #include "utilities.hh"
+#include "fast_forward.hh"
+#include "snapshot.hh"
 
 #include <limits>
 
@@ -236,6 +238,39 @@ uint64_t PacketDesc::getSize() {
     return ret;
 }
 
+uint64_t PacketDesc::align(const uint64_t address,
+                           const uint64_t size) const {
+    if (!alignAddresses) {
+        return address;
+    }
+    if (alignment>0) {
+        return address & ~(alignment-1);
+    }
+    // natural alignment
+    // always align to next power of two of the size
+    return address & ~(Utilities::nextPowerTwo(size)-1);
+}
+
+bool PacketDesc::isContiguous() const {
+    return initialized && cmd != Command::NONE &&
+            addressType == CONFIGURED && sizeType == CONFIGURED &&
+            !striding && size > 0 && increment == size;
+}
+
+uint64_t PacketDesc::coalesce(Packet* p, const uint64_t n) {
+    uint64_t count = 1;
+    while (count < n && nextAddress == p->addr() + p->size() &&
+           align(nextAddress, size) == nextAddress) {
+        getAddress();
+        p->set_size(p->size() + size);
+        ++count;
+    }
+    LOG("PacketDesc::coalesce [", tpId, "] burst of", count,
+            "packets at address", Utilities::toHex(p->addr()),
+            "size", p->size());
+    return count;
+}
+
 bool PacketDesc::send(Packet*& p, const uint64_t time) {
     p = nullptr;
     bool ok = false;
@@ -247,17 +282,7 @@ bool PacketDesc::send(Packet*& p, const uint64_t time) {
             uint64_t size = getSize();
             // byte-align the generated address to the packet size,
             // according to the configured alignment
-            if (alignAddresses)
-            {
-                if (alignment>0) {
-                    address &= ~(alignment-1);
-                } else {
-                    uint64_t toAlign = Utilities::nextPowerTwo(size);
-                    // natural alignment
-                    // always align to next power of two of the size
-                    address &=  ~(toAlign-1);
-                }
-            }
+            address = align(address, size);
 
             p->set_addr(address);
             p->set_size(size);
@@ -407,4 +432,35 @@ uint64_t PacketDesc::autoRange(const uint64_t toSend, const bool force) {
     return range;
 }
 
+void PacketDesc::walk(StateWalker& w) {
+    if (addressType == RANDOM || sizeType == RANDOM || striding) {
+        // inexact walks resume the generation where it stopped
+        if (w.isExact()) {
+            w.reject();
+        }
+        return;
+    }
+    w(nextAddress, StateWalker::LINEAR);
+    // the address generation wraps around on the range
+    if (range > 0) {
+        w.bound(base, base + range);
+    }
+}
+
+void PacketDesc::serialize(Snapshot& s) {
+    // streams reconfigure the base and range at runtime
+    s(base);
+    s(range);
+    s(nextAddress);
+    s(strideStart);
+    s(strideCount);
+    s(strides);
+    if (addressType == RANDOM) {
+        randomAddress.serialize(s);
+    }
+    if (sizeType == RANDOM) {
+        randomSize.serialize(s);
+    }
+}
+
 } // end of namespace
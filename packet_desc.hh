@@ -20,6 +20,8 @@ using namespace std;
 namespace TrafficProfiles {
 
 class PacketTagger;
+class StateWalker;
+class Snapshot;
 
 /*!
  *\brief Packet Descriptor
@@ -125,6 +127,13 @@ protected:
     uint64_t getAddress();
     //! gets a newly generated packet size
     uint64_t getSize();
+    /*!
+     * Aligns an address according to the configured alignment
+     *\param address the address to align
+     *\param size the packet size, for natural alignment
+     *\return the aligned address
+     */
+    uint64_t align(const uint64_t, const uint64_t) const;
 public:
 
     //! Default Constructor
@@ -164,6 +173,22 @@ public:
      *\return true if the response packet was expected, false otherwise
      */
     bool receive(const uint64_t, const Packet*);
+    /*!
+     * Returns whether consecutive packets are address-contiguous:
+     * configured addresses and sizes, no striding, and an address
+     * increment equal to the packet size
+     *\return true if generated packets can be coalesced into bursts
+     */
+    bool isContiguous() const;
+    /*!
+     * Grows a generated packet into a burst, consuming the next
+     * packets while they are contiguous to it: the burst stops
+     * short on address range wrap-arounds
+     *\param p the packet to grow
+     *\param n the maximum number of packets in the burst
+     *\return the number of packets the burst holds
+     */
+    uint64_t coalesce(Packet*, const uint64_t);
     /*!
      * Returns this packet descriptor waited response
      *\return this packet descriptor waited response
@@ -250,6 +275,19 @@ public:
      */
     uint64_t autoRange(const uint64_t, const bool = false);
 
+    /*!
+     * Walks the address generator for fast-forward, only
+     * configured linear addresses and sizes are eligible
+     *\param w the state walker
+     */
+    void walk(StateWalker&);
+
+    /*!
+     * Saves or restores the address cursor and the random generators
+     *\param s the snapshot
+     */
+    void serialize(Snapshot&);
+
 
 };
 
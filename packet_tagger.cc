@@ -9,6 +9,8 @@
 
 #include "packet_tagger.hh"
 #include "logger.hh"
+#include "fast_forward.hh"
+#include "snapshot.hh"
 
 namespace TrafficProfiles {
 
@@ -69,4 +71,14 @@ PacketTagger::tagPacket(Packet* pkt) {
     }
 }
 
+void PacketTagger::walk(StateWalker& w) {
+    w(currentId);
+    w(currentUid, StateWalker::LINEAR);
+}
+
+void PacketTagger::serialize(Snapshot& s) {
+    s(currentId);
+    s(currentUid);
+}
+
 } /* namespace TrafficProfiles */
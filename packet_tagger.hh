@@ -15,6 +15,9 @@
 
 namespace TrafficProfiles {
 
+class StateWalker;
+class Snapshot;
+
 /*!
  *\brief Implements the AMBA Traffic Profile Packets Tagger
  *
@@ -78,6 +81,18 @@ public:
      *\param pkt pointer to the packet to be tagged
      */
     void tagGlobalPacket(Packet*);
+
+    /*!
+     * Walks the ID and UID generators for fast-forward
+     *\param w the state walker
+     */
+    void walk(StateWalker&);
+
+    /*!
+     * Saves or restores the ID and UID generators
+     *\param s the snapshot
+     */
+    void serialize(Snapshot&);
 };
 
 } /* namespace TrafficProfiles */
@@ -70,7 +70,10 @@ void PacketTracer::trace(const Packet* const pkt) {
     if (enabled) {
 
         // get numerical master ID
-        const uint64_t mId = tpm->masterId(pkt->master_id());
+        const uint64_t mId = tpm->packetMaster(pkt);
+        if (!isValid(mId)) {
+            ERROR("PacketTracer::trace", pkt->master_id(), "does not exist");
+        }
         // access/create trace files
         auto& masterTraces = getTraceFiles(mId);
 
@@ -89,7 +92,7 @@ void PacketTracer::trace(const Packet* const pkt) {
         trace_prefix(masterTraces[pkt->cmd()]) << pkt->size() << std::endl;
 
         LOG("PacketTracer::trace tracing master",
-                        pkt->master_id(), "packet uid",pkt->uid(),
+                        tpm->masterName(mId), "packet uid",pkt->uid(),
                         "type", Command_Name(pkt->cmd()), "address",
                         Utilities::toHex(pkt->addr()),"size", pkt->size());
 
@@ -108,7 +111,7 @@ void PacketTracer::trace(const Packet* const pkt) {
             const double latency = (int)((double)(delay)/
                     (tpm->toFrequency(tpm->getTimeResolution())/latencyScale));
 
-            LOG("PacketTracer::trace tracing master", pkt->master_id(), "packet uid", pkt->uid(),
+            LOG("PacketTracer::trace tracing master", tpm->masterName(mId), "packet uid", pkt->uid(),
                     "request time", requestTime, "delay (", Configuration::TimeUnit_Name(tpm->getTimeResolution())
                     ,")", delay, "latency (",Configuration::TimeUnit_Name(latencyUnit),")",latency);
 
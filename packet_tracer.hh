@@ -107,6 +107,12 @@ public:
      * Enables the tracer
      */
     inline void enable() {enabled=true;}
+
+    /*!
+     * Returns whether the tracer is enabled
+     *\return true if packets are traced
+     */
+    inline bool isEnabled() const {return enabled;}
 };
 
 } /* namespace TrafficProfiles */
@@ -0,0 +1,223 @@
+/*
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ *
+ * Copyright (c) 2026 ARM Limited
+ * All rights reserved
+ *  Created on: Oct 18, 2026
+ */
+
+#include <cmath>
+#include <sstream>
+#include "qos_envelope.hh"
+#include "traffic_profile_desc.hh"
+#include "traffic_profile_manager.hh"
+#include "logger.hh"
+#include "snapshot.hh"
+#include "types.hh"
+#include "utilities.hh"
+
+namespace TrafficProfiles {
+
+const string QosEnvelope::Violation::text[] = {
+        [BANDWIDTH] = "BANDWIDTH",
+        [LATENCY]   = "LATENCY",
+        [OT]        = "OT"
+};
+
+const string QosEnvelope::Violation::dump(const uint64_t timeScale) const {
+    stringstream ss;
+    ss << text[type]
+       << " from: " << Utilities::toTimeString((double)start/timeScale)
+       << " to: "   << Utilities::toTimeString((double)end/timeScale)
+       << " worst: ";
+    switch (type) {
+    case BANDWIDTH:
+        ss << Utilities::toByteString(value) << "ps";
+        break;
+    case LATENCY:
+        ss << Utilities::toTimeString(value);
+        break;
+    default:
+        ss << value;
+        break;
+    }
+    return ss.str();
+}
+
+QosEnvelope::QosEnvelope():
+        enabled(false), events(false), window(0), minRate(0), minPeriod(0),
+        maxLatency(0), percentile(0), maxOt(0), timeScale(1),
+        started(false), windowStart(0), windowData(0), samples(0),
+        exceeding(0), worstLatency(0), otViolated(false) {
+    last.fill(InvalidId<uint64_t>());
+}
+
+void QosEnvelope::init(TrafficProfileDescriptor* d,
+                       const QosConfiguration* conf) {
+    auto* tpm = d->getTpm();
+    timeScale = tpm->toFrequency(tpm->getTimeResolution());
+    window = d->parseTime(conf->window());
+    percentile = conf->latency_percentile();
+    maxOt = conf->max_ot();
+    events = conf->emit_event();
+
+    if (conf->has_min_bandwidth()) {
+        tie(minRate, minPeriod) = d->parseRate(conf->min_bandwidth());
+    }
+    if (conf->has_max_latency()) {
+        maxLatency = d->parseTime(conf->max_latency());
+    }
+    if ((minRate > 0 || maxLatency > 0) && window == 0) {
+        ERROR("QosEnvelope::init [", d->getName(), "] window",
+              conf->window(), "is below the ATP time resolution");
+    }
+    if (percentile <= 0 || percentile > 1) {
+        ERROR("QosEnvelope::init [", d->getName(), "] latency percentile",
+              percentile, "out of range (0,1]");
+    }
+    enabled = true;
+
+    LOG("QosEnvelope::init [", d->getName(), "] window", window,
+        "min bandwidth", minRate, "every", minPeriod, "max latency",
+        maxLatency, "percentile", percentile, "max OT", maxOt);
+}
+
+bool QosEnvelope::record(const Violation::Type t, const uint64_t start,
+                         const uint64_t end, const double value) {
+    const uint64_t l { last[t] };
+    // extend the last excursion if contiguous
+    if (isValid(l) && violations[l].end == start) {
+        auto& v = violations[l];
+        v.end = end;
+        v.value = (t == Violation::BANDWIDTH ?
+                   min(v.value, value) : max(v.value, value));
+        return false;
+    }
+    last[t] = violations.size();
+    violations.push_back(Violation { t, start, end, value });
+    LOG("QosEnvelope::record violation",
+        violations.back().dump(timeScale));
+    return true;
+}
+
+bool QosEnvelope::evaluate() {
+    bool fired = false;
+    const uint64_t end { windowStart + window };
+
+    if (minRate > 0 &&
+        (double)windowData * minPeriod < (double)minRate * window) {
+        fired |= record(Violation::BANDWIDTH, windowStart, end,
+                        (double)windowData * timeScale / window);
+    }
+    if (maxLatency > 0 && samples > 0) {
+        // the percentile is above the maximum when more responses
+        // than its rank allows exceed the maximum
+        const uint64_t rank = (uint64_t)ceil(percentile * samples);
+        if (exceeding > samples - rank) {
+            fired |= record(Violation::LATENCY, windowStart, end,
+                            worstLatency / timeScale);
+        }
+    }
+    windowData = samples = exceeding = 0;
+    worstLatency = 0;
+    return fired;
+}
+
+bool QosEnvelope::update(const uint64_t t) {
+    if (!enabled || window == 0) {
+        return false;
+    }
+    if (!started) {
+        started = true;
+        windowStart = t;
+        return false;
+    }
+    if (t < windowStart + window) {
+        return false;
+    }
+    bool fired = evaluate();
+    windowStart += window;
+
+    // windows with no traffic are closed in a single step
+    const uint64_t empty { (t - windowStart) / window };
+    if (empty > 0) {
+        if (minRate > 0) {
+            fired |= record(Violation::BANDWIDTH, windowStart,
+                            windowStart + empty * window, 0);
+        }
+        windowStart += empty * window;
+    }
+    return fired;
+}
+
+bool QosEnvelope::send(const uint64_t t, const uint64_t data,
+                       const uint64_t ot) {
+    if (!enabled) {
+        return false;
+    }
+    bool fired = update(t);
+    windowData += data;
+
+    if (maxOt > 0 && ot > maxOt) {
+        if (!otViolated) {
+            otViolated = true;
+            // an OT excursion is never contiguous to the previous one
+            last[Violation::OT] = InvalidId<uint64_t>();
+            fired |= record(Violation::OT, t, t, ot);
+        } else {
+            auto& v = violations[last[Violation::OT]];
+            v.end = t;
+            v.value = max(v.value, (double)ot);
+        }
+    }
+    return fired;
+}
+
+bool QosEnvelope::receive(const uint64_t t, const double delay,
+                          const uint64_t ot) {
+    if (!enabled) {
+        return false;
+    }
+    bool fired = update(t);
+    samples++;
+    if (maxLatency > 0 && delay > maxLatency) {
+        exceeding++;
+    }
+    worstLatency = max(worstLatency, delay);
+
+    if (otViolated && ot <= maxOt) {
+        // the OT excursion ends with this response
+        otViolated = false;
+        violations[last[Violation::OT]].end = t;
+    }
+    return fired;
+}
+
+void QosEnvelope::reset() {
+    started = false;
+    windowStart = windowData = samples = exceeding = 0;
+    worstLatency = 0;
+    otViolated = false;
+    violations.clear();
+    last.fill(InvalidId<uint64_t>());
+}
+
+void QosEnvelope::serialize(Snapshot& s) {
+    s(started);
+    s(windowStart);
+    s(windowData);
+    s(samples);
+    s(exceeding);
+    s(worstLatency);
+    s(otViolated);
+    violations.resize(s.size(violations.size()));
+    for (auto& v : violations) {
+        s(v.type);
+        s(v.start);
+        s(v.end);
+        s(v.value);
+    }
+    s(last);
+}
+
+} // end of namespace
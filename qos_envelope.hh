@@ -0,0 +1,209 @@
+/*
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ *
+ * Copyright (c) 2026 ARM Limited
+ * All rights reserved
+ *  Created on: Oct 18, 2026
+ */
+
+#ifndef __AMBA_TRAFFIC_PROFILE_QOS_ENVELOPE_HH__
+#define __AMBA_TRAFFIC_PROFILE_QOS_ENVELOPE_HH__
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "proto/tp_config.pb.h"
+
+using namespace std;
+
+namespace TrafficProfiles {
+
+class TrafficProfileDescriptor;
+class Snapshot;
+
+/*!
+ *\brief ATP Checker QoS envelope
+ *
+ * Monitors the requests and responses recorded by an ATP Checker
+ * against a configured envelope: minimum bandwidth over a window,
+ * maximum latency percentile over a window and maximum number of
+ * outstanding transactions.
+ *
+ * Excursions out of the envelope are stored in a violation log.
+ * Consecutive violations of the same kind are merged in a single
+ * entry, which spans the whole excursion and keeps its worst value.
+ *
+ * The latency percentile is checked by counting the responses above
+ * the threshold in each window, so that every recorded packet costs
+ * O(1), and windows with no traffic are skipped in a single step.
+ */
+class QosEnvelope {
+
+public:
+
+    /*!
+     *\brief QoS envelope violation
+     */
+    struct Violation {
+        /*!
+         * Violation Type
+         * BANDWIDTH: bandwidth below the configured minimum
+         * LATENCY: latency percentile above the configured maximum
+         * OT: outstanding transactions above the configured maximum
+         */
+        enum Type {
+            BANDWIDTH = 0,
+            LATENCY = 1,
+            OT = 2,
+            N_TYPES = 3
+        } type;
+
+        //! Violation type to string name map
+        static const string text[];
+
+        //! violation start time
+        uint64_t start;
+        //! violation end time
+        uint64_t end;
+        /*!
+         * violation worst value: minimum bandwidth in bytes per second,
+         * maximum latency in seconds or maximum outstanding transactions
+         */
+        double value;
+
+        /*!
+         * Dumps the violation
+         *\param timeScale ATP time units per second
+         *\return a formatted string describing the violation
+         */
+        const string dump(const uint64_t) const;
+    };
+
+protected:
+
+    //! whether a QoS configuration is loaded
+    bool enabled;
+    //! whether violations should be signalled with events
+    bool events;
+
+    //! evaluation window, in ATP time units
+    uint64_t window;
+    //! minimum bandwidth, bytes every minPeriod - 0 means unchecked
+    uint64_t minRate;
+    //! minimum bandwidth period, in ATP time units
+    uint64_t minPeriod;
+    //! maximum latency, in ATP time units - 0 means unchecked
+    uint64_t maxLatency;
+    //! checked latency percentile
+    double percentile;
+    //! maximum outstanding transactions - 0 means unchecked
+    uint64_t maxOt;
+    //! ATP time units per second
+    uint64_t timeScale;
+
+    //! whether the first window has started
+    bool started;
+    //! current window start time
+    uint64_t windowStart;
+    //! data requested in the current window
+    uint64_t windowData;
+    //! responses received in the current window
+    uint64_t samples;
+    //! responses above the maximum latency in the current window
+    uint64_t exceeding;
+    //! worst latency in the current window, in ATP time units
+    double worstLatency;
+    //! whether the outstanding transactions are above the maximum
+    bool otViolated;
+
+    //! violation log
+    vector<Violation> violations;
+    //! violation type -> index of its last entry in the log
+    array<uint64_t, Violation::N_TYPES> last;
+
+    /*!
+     * Records a violation, merging it with the last entry
+     * of the same type if contiguous
+     *\param t the violation type
+     *\param start the violation start time
+     *\param end the violation end time
+     *\param value the violation value
+     *\return true if a new excursion started, false otherwise
+     */
+    bool record(const Violation::Type, const uint64_t, const uint64_t,
+                const double);
+
+    /*!
+     * Evaluates the current window against the envelope
+     *\return true if a new excursion started, false otherwise
+     */
+    bool evaluate();
+
+public:
+
+    //! Default constructor
+    QosEnvelope();
+
+    //! Default destructor
+    virtual ~QosEnvelope() = default;
+
+    /*!
+     * Initialises the QoS envelope
+     *\param d the checker owning the envelope
+     *\param conf the QoS configuration
+     */
+    void init(TrafficProfileDescriptor*, const QosConfiguration*);
+
+    //! returns whether a QoS configuration is loaded
+    inline bool isEnabled() const { return enabled; }
+
+    //! returns whether violations should be signalled with events
+    inline bool emitsEvents() const { return events; }
+
+    /*!
+     * Closes all windows ended before a given time
+     *\param t the current time
+     *\return true if a new excursion started, false otherwise
+     */
+    bool update(const uint64_t);
+
+    /*!
+     * Records a request
+     *\param t the request time
+     *\param data the request size
+     *\param ot the outstanding transactions after the request
+     *\return true if a new excursion started, false otherwise
+     */
+    bool send(const uint64_t, const uint64_t, const uint64_t);
+
+    /*!
+     * Records a response
+     *\param t the response time
+     *\param delay the request to response delay
+     *\param ot the outstanding transactions after the response
+     *\return true if a new excursion started, false otherwise
+     */
+    bool receive(const uint64_t, const double, const uint64_t);
+
+    //! Resets the envelope windows and violation log
+    void reset();
+
+    /*!
+     * Saves or restores the current window and the violation log
+     *\param s the snapshot
+     */
+    void serialize(Snapshot&);
+
+    //! returns the violation log
+    inline const vector<Violation>& getViolations() const {
+        return violations;
+    }
+
+    //! returns the ATP time units per second
+    inline uint64_t getTimeScale() const { return timeScale; }
+};
+
+} // end of namespace
+
+#endif /* __AMBA_TRAFFIC_PROFILE_QOS_ENVELOPE_HH__ */
@@ -7,8 +7,10 @@
  *      Author: Matteo Andreozzi
  */
 
+#include <cmath>
 #include "random_generator.hh"
 
+#include "snapshot.hh"
 #include "logger.hh"
 
 namespace TrafficProfiles {
@@ -96,6 +98,19 @@ void Generator::init(const RandomDesc& from) {
     initialized = true;
 }
 
+void Generator::serialize(Snapshot& s) {
+    s.text(mersenne);
+    bool present = (distribution != nullptr);
+    s(present);
+    if (present != (distribution != nullptr)) {
+        s.invalidate();
+        return;
+    }
+    if (present) {
+        distribution->serialize(s);
+    }
+}
+
 uint64_t Generator::get() {
     uint64_t ret = 0;
     if (initialized) {
@@ -107,6 +122,10 @@ uint64_t Generator::get() {
     return ret;
 }
 
+double Generator::mean() const {
+    return (initialized ? distribution->mean() : 0);
+}
+
 Uniform::Uniform(Generator* const gen, const uint64_t base, const uint64_t range):
         Distribution(gen, base, range) {
     uint64_t min = base, max = base + range;
@@ -123,6 +142,14 @@ uint64_t Uniform::get() {
     return (*uniform)(generator->mersenne);
 }
 
+double Uniform::mean() const {
+    return ((double)uniform->a() + uniform->b()) / 2;
+}
+
+void Uniform::serialize(Snapshot& s) {
+    s.text(*uniform);
+}
+
 Normal::Normal(Generator* const gen, const uint64_t base, const uint64_t range):
         Distribution(gen, base, range) {
     double dev  = range/2, mean = base + dev;
@@ -138,6 +165,14 @@ Normal::Normal(Generator* const gen, const RandomDesc& from):
 uint64_t Normal::get() {
     return (*normal)(generator->mersenne);
 }
+
+double Normal::mean() const {
+    return normal->mean();
+}
+
+void Normal::serialize(Snapshot& s) {
+    s.text(*normal);
+}
 Poisson::Poisson(Generator* const gen, const uint64_t base, const uint64_t range):
         Distribution(gen, base, range) {
     double mean = base + range/2;
@@ -154,6 +189,14 @@ uint64_t Poisson::get() {
     return (*poisson)(generator->mersenne);
 }
 
+double Poisson::mean() const {
+    return poisson->mean();
+}
+
+void Poisson::serialize(Snapshot& s) {
+    s.text(*poisson);
+}
+
 Weibull::Weibull(Generator* const gen, const uint64_t base, const uint64_t range):
         Distribution(gen, base, range) {
     // todo should we work scale and shape out from GAMMA ?
@@ -171,6 +214,14 @@ uint64_t Weibull::get() {
     return (*weibull)(generator->mersenne);
 }
 
+double Weibull::mean() const {
+    return weibull->b() * tgamma(1 + 1 / weibull->a());
+}
+
+void Weibull::serialize(Snapshot& s) {
+    s.text(*weibull);
+}
+
 }
 
 }
@@ -19,6 +19,8 @@ using namespace std;
 
 namespace TrafficProfiles {
 
+class Snapshot;
+
 namespace Random {
 
 //! forward declaration
@@ -64,6 +66,18 @@ public:
      *\return a randomly extracted unsigned integer value
      */
     virtual uint64_t get() = 0;
+
+    /*!
+     * Returns the distribution mean
+     *\return the mean value
+     */
+    virtual double mean() const = 0;
+
+    /*!
+     * Saves or restores the distribution state
+     *\param s the snapshot
+     */
+    virtual void serialize(Snapshot&) = 0;
 };
 
 /*!
@@ -97,6 +111,18 @@ public:
     *\return a randomly extracted unsigned integer value
     */
    uint64_t get();
+
+   /*!
+    * Returns the distribution mean
+    *\return the mean value
+    */
+   double mean() const;
+
+   /*!
+    * Saves or restores the distribution state
+    *\param s the snapshot
+    */
+   void serialize(Snapshot&);
 };
 
 /*!
@@ -129,6 +155,18 @@ public:
     *\return a randomly extracted unsigned integer value
     */
     uint64_t get();
+
+   /*!
+    * Returns the distribution mean
+    *\return the mean value
+    */
+   double mean() const;
+
+    /*!
+     * Saves or restores the distribution state
+     *\param s the snapshot
+     */
+    void serialize(Snapshot&);
 };
 
 /*!
@@ -160,6 +198,18 @@ public:
     *\return a randomly extracted unsigned integer value
     */
     uint64_t get();
+
+   /*!
+    * Returns the distribution mean
+    *\return the mean value
+    */
+   double mean() const;
+
+    /*!
+     * Saves or restores the distribution state
+     *\param s the snapshot
+     */
+    void serialize(Snapshot&);
 };
 
 /*!
@@ -192,6 +242,18 @@ public:
     *\return a randomly extracted unsigned integer value
     */
     uint64_t get();
+
+   /*!
+    * Returns the distribution mean
+    *\return the mean value
+    */
+   double mean() const;
+
+    /*!
+     * Saves or restores the distribution state
+     *\param s the snapshot
+     */
+    void serialize(Snapshot&);
 };
 
 
@@ -255,6 +317,18 @@ class Generator {
      */
     uint64_t get();
 
+    /*!
+     * Returns the mean of the configured distribution
+     *\return the distribution mean, 0 if uninitialised
+     */
+    double mean() const;
+
+    /*!
+     * Saves or restores the random engine and distribution state
+     *\param s the snapshot
+     */
+    void serialize(Snapshot&);
+
     /*!
      * Returns the configured random generator type
      *\return the rng type
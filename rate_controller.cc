@@ -0,0 +1,221 @@
+/*
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ *
+ * Copyright (c) 2026 ARM Limited
+ * All rights reserved
+ *  Created on: Oct 18, 2026
+ */
+
+#include <algorithm>
+#include <cmath>
+#include "rate_controller.hh"
+#include "traffic_profile_desc.hh"
+#include "logger.hh"
+#include "snapshot.hh"
+#include "utilities.hh"
+
+namespace TrafficProfiles {
+
+RateController::RateController():
+        enabled(false), controller(RateControlConfiguration::AIMD),
+        metric(RateControlConfiguration::LATENCY), target(0), interval(0),
+        maxLevel(0), initialRate(0), initialFifoRate(0, 0), fifoRate(0, 0),
+        rate(0), minRate(0), maxRate(0),
+        increase(0), decrease(0), kp(0), ki(0), kd(0), integral(0),
+        prevError(0), started(false), periodStart(0), data(0), latency(0),
+        responses(0), ot(0), otN(0), sustained(0), adjustments(0) {
+}
+
+double RateController::toRate(TrafficProfileDescriptor* d, const string& s) {
+    const auto r = d->parseRate(s);
+    return (r.second > 0 ? (double)r.first / (double)r.second : 0);
+}
+
+pair<uint64_t, uint64_t> RateController::toFifoRate() const {
+    // express the rate as about a granule every period, so
+    // that the FIFO is updated with a fine time granularity
+    const double g = (maxLevel > 0 ?
+                      min((double)granule, (double)maxLevel) : granule);
+    const uint64_t period = max<uint64_t>(1, llround(g / rate));
+    const uint64_t bytes = max<uint64_t>(1, llround(rate * period));
+    return Utilities::reduce(bytes, period);
+}
+
+void RateController::init(TrafficProfileDescriptor* d,
+                          const FifoConfiguration* fifo,
+                          const pair<uint64_t, uint64_t>& initial) {
+    const RateControlConfiguration& conf = fifo->rate_control();
+
+    controller = conf.controller();
+    metric = conf.metric();
+    interval = d->parseTime(conf.period());
+    maxLevel = (fifo->has_full_level() ? fifo->full_level() : fifo->full());
+
+    initialFifoRate = fifoRate = initial;
+    initialRate = rate = (fifoRate.second > 0 ?
+                          (double)fifoRate.first / fifoRate.second : 0);
+    if (rate <= 0) {
+        ERROR("RateController::init [", d->getName(),
+              "] rate control requires a FIFO rate");
+    }
+    if (interval == 0) {
+        ERROR("RateController::init [", d->getName(), "] period",
+              conf.period(), "is below the ATP time resolution");
+    }
+
+    if (metric == RateControlConfiguration::LATENCY) {
+        if (conf.has_target_latency()) {
+            target = d->parseTime(conf.target_latency());
+        }
+    } else {
+        target = conf.target_ot();
+    }
+    if (target <= 0) {
+        ERROR("RateController::init [", d->getName(), "] missing",
+              RateControlConfiguration::Metric_Name(metric), "target");
+    }
+
+    minRate = (conf.has_min_rate() ? toRate(d, conf.min_rate()) :
+               initialRate / 100);
+    maxRate = (conf.has_max_rate() ? toRate(d, conf.max_rate()) :
+               initialRate * 100);
+    // the FIFO cannot fill or deplete more than its level per time unit
+    if (maxLevel > 0) {
+        maxRate = min(maxRate, (double)maxLevel);
+    }
+    if (minRate <= 0 || minRate > maxRate) {
+        ERROR("RateController::init [", d->getName(),
+              "] invalid rate bounds", minRate, maxRate);
+    }
+
+    increase = (conf.has_increase() ? toRate(d, conf.increase()) :
+                initialRate / 10);
+    decrease = conf.decrease();
+    if (decrease <= 0 || decrease >= 1) {
+        ERROR("RateController::init [", d->getName(),
+              "] decrease factor", decrease, "out of range (0,1)");
+    }
+    kp = conf.kp();
+    ki = conf.ki();
+    kd = conf.kd();
+    enabled = true;
+
+    LOG("RateController::init [", d->getName(), "]",
+        RateControlConfiguration::Controller_Name(controller), "on",
+        RateControlConfiguration::Metric_Name(metric), "target", target,
+        "period", interval, "rate", rate, "bounds", minRate, maxRate);
+}
+
+bool RateController::update(const uint64_t t) {
+    if (!started) {
+        started = true;
+        periodStart = t;
+        return false;
+    }
+    if (t < periodStart + interval) {
+        return false;
+    }
+
+    bool changed = false;
+    const bool measured = (metric == RateControlConfiguration::LATENCY ?
+                           responses > 0 : otN > 0);
+    if (measured) {
+        const double m = (metric == RateControlConfiguration::LATENCY ?
+                          latency / responses : (double)ot / otN);
+        const bool within = (m <= target);
+        const double achieved = (double)data / (t - periodStart);
+        if (within) {
+            sustained = max(sustained, achieved);
+        }
+
+        double next = rate;
+        if (controller == RateControlConfiguration::AIMD) {
+            next = (within ? rate + increase : rate * decrease);
+        } else {
+            // error normalised to the target, positive when within target
+            const double error = (target - m) / target;
+            // bound the accumulated error to limit the integral windup
+            integral = min(max(integral + error, -10.), 10.);
+            const double u = kp * error + ki * integral +
+                             kd * (error - prevError);
+            prevError = error;
+            // limit the rate change to a factor two per period
+            next = rate * min(max(1. + u, .5), 2.);
+        }
+        // the master is not rate bound when it cannot keep up with the
+        // current rate (e.g. when back-pressured or OT limited), so that
+        // the rate is not increased further
+        if (next > rate && achieved < rate * utilisation) {
+            next = rate;
+        }
+        next = min(max(next, minRate), maxRate);
+
+        LOG("RateController::update period", periodStart, "to", t,
+            "measured", m, "target", target, "rate", rate, "->", next);
+
+        if (next != rate) {
+            rate = next;
+            fifoRate = toFifoRate();
+            adjustments++;
+            changed = true;
+        }
+    }
+
+    // start a new period
+    periodStart = t;
+    data = responses = ot = otN = 0;
+    latency = 0;
+    return changed;
+}
+
+bool RateController::send(const uint64_t t, const uint64_t size,
+                          const uint64_t o) {
+    if (!enabled) {
+        return false;
+    }
+    const bool changed = update(t);
+    data += size;
+    ot += o;
+    otN++;
+    return changed;
+}
+
+bool RateController::receive(const uint64_t t, const double delay) {
+    if (!enabled) {
+        return false;
+    }
+    const bool changed = update(t);
+    latency += delay;
+    responses++;
+    return changed;
+}
+
+void RateController::reset() {
+    rate = initialRate;
+    fifoRate = initialFifoRate;
+    integral = prevError = 0;
+    started = false;
+    periodStart = 0;
+    data = responses = ot = otN = 0;
+    latency = 0;
+    sustained = 0;
+    adjustments = 0;
+}
+
+void RateController::serialize(Snapshot& s) {
+    s(rate);
+    s(fifoRate);
+    s(integral);
+    s(prevError);
+    s(started);
+    s(periodStart);
+    s(data);
+    s(latency);
+    s(responses);
+    s(ot);
+    s(otN);
+    s(sustained);
+    s(adjustments);
+}
+
+} // end of namespace
@@ -0,0 +1,195 @@
+/*
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ *
+ * Copyright (c) 2026 ARM Limited
+ * All rights reserved
+ *  Created on: Oct 18, 2026
+ */
+
+#ifndef __AMBA_TRAFFIC_PROFILE_RATE_CONTROLLER_HH__
+#define __AMBA_TRAFFIC_PROFILE_RATE_CONTROLLER_HH__
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include "proto/tp_config.pb.h"
+
+using namespace std;
+
+namespace TrafficProfiles {
+
+class TrafficProfileDescriptor;
+class Snapshot;
+
+/*!
+ *\brief ATP Master closed-loop rate controller
+ *
+ * Adjusts the FIFO rate of an ATP Master at runtime, so that the
+ * master converges to the maximum rate it can sustain within a
+ * latency or OT bound.
+ *
+ * At the end of every control period the metric observed in the
+ * period (average latency or average OT) is compared with the
+ * target, and the rate is updated either by an AIMD controller
+ * (additive increase when within target, multiplicative decrease
+ * otherwise) or by a PID controller acting on the error normalised
+ * to the target. The rate is only increased while the master keeps
+ * up with it, so that it does not run away when the throughput is
+ * bound elsewhere (e.g. by back-pressure). The highest bandwidth
+ * achieved in a period within target is recorded as the sustained rate.
+ *
+ * Rates are expressed in bytes per ATP time unit.
+ */
+class RateController {
+
+protected:
+
+    //! FIFO granule: the controlled rate fills about a packet per period
+    static const uint64_t granule = 64;
+    //! fraction of the rate to achieve in a period for it to be increased
+    static constexpr double utilisation = 0.9;
+
+    //! whether a rate control configuration is loaded
+    bool enabled;
+    //! controller algorithm
+    RateControlConfiguration::Controller controller;
+    //! controlled metric
+    RateControlConfiguration::Metric metric;
+    //! metric target, in ATP time units or transactions
+    double target;
+    //! control period, in ATP time units
+    uint64_t interval;
+    //! FIFO maximum level - 0 means unbounded
+    uint64_t maxLevel;
+
+    //! initial rate
+    double initialRate;
+    //! initial rate as FIFO parameters, as configured
+    pair<uint64_t, uint64_t> initialFifoRate;
+    //! current rate as FIFO parameters
+    pair<uint64_t, uint64_t> fifoRate;
+    //! current rate
+    double rate;
+    //! rate lower bound
+    double minRate;
+    //! rate upper bound
+    double maxRate;
+    //! AIMD additive increase
+    double increase;
+    //! AIMD multiplicative decrease factor
+    double decrease;
+    //! PID proportional, integral and derivative gains
+    double kp, ki, kd;
+    //! PID accumulated error
+    double integral;
+    //! PID previous period error
+    double prevError;
+
+    //! whether the first period has started
+    bool started;
+    //! current period start time
+    uint64_t periodStart;
+    //! data sent in the current period
+    uint64_t data;
+    //! cumulative latency in the current period
+    double latency;
+    //! responses received in the current period
+    uint64_t responses;
+    //! cumulative OT in the current period
+    uint64_t ot;
+    //! OT samples in the current period
+    uint64_t otN;
+
+    //! highest bandwidth achieved in a period within target
+    double sustained;
+    //! number of rate adjustments
+    uint64_t adjustments;
+
+    /*!
+     * Closes the current period if ended, adjusting the rate
+     *\param t the current time
+     *\return true if the rate changed, false otherwise
+     */
+    bool update(const uint64_t);
+
+    /*!
+     * Converts a rate string to bytes per ATP time unit
+     *\param d the master owning the controller
+     *\param s the rate string
+     *\return the rate in bytes per ATP time unit
+     */
+    static double toRate(TrafficProfileDescriptor*, const string&);
+
+    /*!
+     * Expresses the current rate as FIFO parameters
+     *\return the FIFO rate in bytes and period in ATP time units
+     */
+    pair<uint64_t, uint64_t> toFifoRate() const;
+
+public:
+
+    //! Default constructor
+    RateController();
+
+    //! Default destructor
+    virtual ~RateController() = default;
+
+    /*!
+     * Initialises the rate controller
+     *\param d the master owning the controller
+     *\param conf the master FIFO configuration
+     *\param initial the master initial FIFO rate
+     */
+    void init(TrafficProfileDescriptor*, const FifoConfiguration*,
+              const pair<uint64_t, uint64_t>&);
+
+    //! returns whether a rate control configuration is loaded
+    inline bool isEnabled() const { return enabled; }
+
+    /*!
+     * Records a request
+     *\param t the request time
+     *\param size the request size
+     *\param o the outstanding transactions after the request
+     *\return true if the rate changed, false otherwise
+     */
+    bool send(const uint64_t, const uint64_t, const uint64_t);
+
+    /*!
+     * Records a response
+     *\param t the response time
+     *\param delay the request to response delay
+     *\return true if the rate changed, false otherwise
+     */
+    bool receive(const uint64_t, const double);
+
+    //! Restores the initial rate and clears the controller state
+    void reset();
+
+    /*!
+     * Saves or restores the current rate and the controller state
+     *\param s the snapshot
+     */
+    void serialize(Snapshot&);
+
+    //! returns the current rate, in bytes per ATP time unit
+    inline double getRate() const { return rate; }
+
+    //! returns the sustained rate, in bytes per ATP time unit
+    inline double getSustainedRate() const { return sustained; }
+
+    //! returns the number of rate adjustments
+    inline uint64_t getAdjustments() const { return adjustments; }
+
+    /*!
+     * Returns the current rate as FIFO parameters
+     *\return the FIFO rate in bytes and period in ATP time units
+     */
+    inline const pair<uint64_t, uint64_t>& getFifoRate() const {
+        return fifoRate;
+    }
+};
+
+} // end of namespace
+
+#endif /* __AMBA_TRAFFIC_PROFILE_RATE_CONTROLLER_HH__ */
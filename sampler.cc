@@ -0,0 +1,217 @@
+/*
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ *
+ * Copyright (c) 2026 ARM Limited
+ * All rights reserved
+ *  Created on: Oct 18, 2026
+ */
+
+#include <algorithm>
+#include <sstream>
+#include "sampler.hh"
+#include "traffic_profile_manager.hh"
+#include "logger.hh"
+#include "utilities.hh"
+
+namespace TrafficProfiles {
+
+constexpr double Sampler::defaultConfidence;
+
+Sampler::Sampler(TrafficProfileManager* t):
+        tpm(t), enabled(false), window(0), interval(0), warming(0),
+        confidence(defaultConfidence), phase(WARMING), warmingEnd(0),
+        startData(0), startReceived(0), startLatency(0), startDispatched(0),
+        skips(0), skippedTime(0), eventWindows(0) {
+}
+
+void Sampler::enable(const uint64_t w, const uint64_t i,
+                     const uint64_t warm, const double c) {
+    if (w == 0) {
+        ERROR("Sampler::enable the measurement window is below the ATP "
+              "time resolution");
+    }
+    if (c <= 0 || c >= 1) {
+        ERROR("Sampler::enable confidence", c, "out of range (0,1)");
+    }
+    window = w;
+    interval = i;
+    warming = warm;
+    confidence = c;
+    enabled = true;
+    reset();
+    LOG("Sampler::enable window", window, "interval", interval,
+        "warming", warming, "confidence", confidence);
+}
+
+void Sampler::disable() {
+    enabled = false;
+}
+
+void Sampler::reset() {
+    phase = WARMING;
+    warmingEnd = 0;
+    start = StateWalker::Sample();
+    startData = startReceived = 0;
+    startLatency = 0;
+    startDispatched = 0;
+    bandwidth = ConvergenceMonitor::Estimator();
+    latency = ConvergenceMonitor::Estimator();
+    skips = skippedTime = eventWindows = 0;
+}
+
+bool Sampler::sample(StateWalker::Sample& s) {
+    StateWalker sampler(false);
+    tpm->walk(sampler);
+    s = move(sampler.getSample());
+    s.time = tpm->getTime();
+    return s.eligible;
+}
+
+void Sampler::measure(const uint64_t t) {
+    const Stats stats = tpm->getMastersStats();
+    const uint64_t received = stats.received - startReceived;
+    bandwidth.add((double)(stats.dataReceived - startData) /
+                  (t - start.time));
+    if (received > 0) {
+        latency.add((stats.latency - startLatency) / received);
+    }
+}
+
+bool Sampler::repeats(const StateWalker::Sample& a,
+                      const StateWalker::Sample& b) {
+    if (a.kinds != b.kinds) {
+        return false;
+    }
+    for (uint64_t i = 0; i < a.values.size(); ++i) {
+        if (a.kinds[i] == StateWalker::VALUE && a.values[i] != b.values[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool Sampler::skip(const StateWalker::Sample& c) {
+    const uint64_t period = c.time - start.time;
+    const uint64_t n = min(interval / period,
+                           FastForward::periods(start, c));
+    if (n == 0) {
+        return false;
+    }
+    // counters, cursors and statistics advance by their window steps,
+    // changing times by the window, the rest carries over
+    vector<uint64_t> steps(c.values.size(), 0);
+    const vector<uint64_t> accelerations(steps.size(), 0);
+    for (uint64_t i = 0; i < steps.size(); ++i) {
+        const uint64_t step = c.values[i] - start.values[i];
+        switch (c.kinds[i]) {
+        case StateWalker::TIME:
+            steps[i] = (step != 0 ? period : 0);
+            break;
+        case StateWalker::LINEAR:
+        case StateWalker::QUADRATIC:
+            steps[i] = step;
+            break;
+        default:
+            break;
+        }
+    }
+    StateWalker advancer(steps, accelerations, n, false);
+    tpm->walk(advancer);
+    ++skips;
+    skippedTime += n * period;
+    LOG("Sampler::skip window of", period, "time units, skipped", n,
+        "windows to", tpm->getTime());
+    return true;
+}
+
+bool Sampler::update() {
+    const uint64_t t = tpm->getTime();
+    if (phase == WARMING) {
+        if (t < warmingEnd) {
+            return false;
+        }
+        if (!sample(start)) {
+            // retry once the state becomes eligible
+            warmingEnd = t + window;
+            return false;
+        }
+        const Stats stats = tpm->getMastersStats();
+        startData = stats.dataReceived;
+        startReceived = stats.received;
+        startLatency = stats.latency;
+        startDispatched = tpm->getDispatchedEvents();
+        phase = MEASURING;
+        return false;
+    }
+
+    if (t < start.time + window) {
+        return false;
+    }
+    // the skip needs an end state with the same structure as the start
+    // one, waited for up to two further windows, and preferably the same
+    // discrete state, so that the window spans whole periods of
+    // deterministic regimes, waited for up to a further window
+    // events dispatched within the window change the subscribers event
+    // state, which the extrapolation can't follow: measure it only
+    const bool quiet = (tpm->getDispatchedEvents() == startDispatched);
+    StateWalker::Sample c;
+    const bool matches = quiet && sample(c) && c.kinds == start.kinds;
+    const uint64_t elapsed = t - start.time;
+    if (quiet &&
+        ((!(matches && repeats(start, c)) && elapsed < 2 * window) ||
+         (!matches && elapsed < 3 * window))) {
+        return false;
+    }
+    measure(t);
+    if (!quiet && eventWindows++ == 0) {
+        WARN("Sampler::update events dispatched to waiting profiles, e.g. "
+             "by wait_for lock sequencing, can't be extrapolated: the windows "
+             "dispatching them are simulated in detail, not skipped");
+    }
+    const bool advanced = (matches && skip(c));
+    phase = WARMING;
+    warmingEnd = tpm->getTime() + warming;
+    return advanced;
+}
+
+double Sampler::getBandwidth() const {
+    return bandwidth.mean *
+           TrafficProfileManager::toFrequency(tpm->getTimeResolution());
+}
+
+double Sampler::getBandwidthError() const {
+    return bandwidth.halfWidth(confidence) *
+           TrafficProfileManager::toFrequency(tpm->getTimeResolution());
+}
+
+double Sampler::getLatency() const {
+    return latency.mean /
+           TrafficProfileManager::toFrequency(tpm->getTimeResolution());
+}
+
+double Sampler::getLatencyError() const {
+    return latency.halfWidth(confidence) /
+           TrafficProfileManager::toFrequency(tpm->getTimeResolution());
+}
+
+const string Sampler::dump() const {
+    stringstream ss;
+    ss << "windows: " << getWindows()
+       << " skips: " << skips
+       << " event windows: " << eventWindows
+       << " skipped time: " << Utilities::toTimeString(skippedTime /
+               (double)TrafficProfileManager::toFrequency(
+                       tpm->getTimeResolution()))
+       << " bandwidth: " << Utilities::toByteString(getBandwidth()) << "ps";
+    if (bandwidth.n > 1) {
+        ss << " +/- " << Utilities::toByteString(getBandwidthError()) << "ps";
+    }
+    ss << " latency: " << Utilities::toTimeString(getLatency());
+    if (latency.n > 1) {
+        ss << " +/- " << Utilities::toTimeString(getLatencyError());
+    }
+    ss << " (" << confidence * 100 << "% confidence)";
+    return ss.str();
+}
+
+} // end of namespace
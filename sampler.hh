@@ -0,0 +1,225 @@
+/*
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ *
+ * Copyright (c) 2026 ARM Limited
+ * All rights reserved
+ *  Created on: Oct 18, 2026
+ */
+
+#ifndef __AMBA_TRAFFIC_PROFILE_SAMPLER_HH__
+#define __AMBA_TRAFFIC_PROFILE_SAMPLER_HH__
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "convergence_monitor.hh"
+#include "fast_forward.hh"
+
+using namespace std;
+
+namespace TrafficProfiles {
+
+class TrafficProfileManager;
+
+/*!
+ *\brief ATP Engine statistical sampling
+ *
+ * Alternates detailed measurement windows with skipped intervals, as
+ * in SMARTS: each window is simulated event by event and its bandwidth
+ * and average latency are recorded as a sample, then the engine state
+ * is extrapolated over the interval which follows, advancing counters,
+ * addresses, times and statistics by the window steps while FIFO
+ * levels, outstanding transactions and in-flight packets carry over
+ * unchanged. An optional detailed warming period after each skip lets
+ * the engine settle before the next window.
+ *
+ * The engine statistics are extrapolated as a whole, while the window
+ * samples provide the mean bandwidth and latency with their Student-t
+ * confidence bounds.
+ *
+ * Skips use inexact state walks: the window end state must have the
+ * same structure as its start one (same in-flight packets count, same
+ * scheduled events count), and preferably the same discrete state
+ * (FIFO levels, halted profiles), which are waited for up to two further
+ * windows, and states with checkers, rate controllers, convergence monitors,
+ * packet tracing, timeline recording or engine self-profiling active
+ * are never skipped. Windows in which events reach subscribed profiles,
+ * e.g. wait_for lock sequencing, change the profiles event state in ways
+ * the extrapolation can't follow: these are measured but not skipped,
+ * hence simulated in detail.
+ */
+class Sampler {
+
+public:
+
+    //! Default confidence level
+    static constexpr double defaultConfidence = 0.95;
+
+protected:
+
+    //! Sampling phase
+    enum Phase { WARMING, MEASURING };
+
+    //! Pointer to the TPM
+    TrafficProfileManager* const tpm;
+
+    //! whether sampling is enabled
+    bool enabled;
+
+    //! measurement window length, in ATP time units
+    uint64_t window;
+
+    //! skipped interval length, in ATP time units
+    uint64_t interval;
+
+    //! detailed warming length before each window, in ATP time units
+    uint64_t warming;
+
+    //! confidence level
+    double confidence;
+
+    //! current phase
+    Phase phase;
+
+    //! time the warming ends at
+    uint64_t warmingEnd;
+
+    //! window start state
+    StateWalker::Sample start;
+
+    //! data received by the masters at the window start
+    uint64_t startData;
+
+    //! responses received by the masters at the window start
+    uint64_t startReceived;
+
+    //! cumulative latency at the window start
+    double startLatency;
+
+    //! events dispatched to subscribed profiles at the window start
+    uint64_t startDispatched;
+
+    //! window bandwidths, in bytes per ATP time unit
+    ConvergenceMonitor::Estimator bandwidth;
+
+    //! window average latencies, in ATP time units
+    ConvergenceMonitor::Estimator latency;
+
+    //! number of skips
+    uint64_t skips;
+
+    //! skipped ATP time
+    uint64_t skippedTime;
+
+    //! windows not skipped as they dispatched events to waiting profiles
+    uint64_t eventWindows;
+
+    /*!
+     * Samples the engine state
+     *\param s the sample
+     *\return false if the state can't be skipped
+     */
+    bool sample(StateWalker::Sample&);
+
+    /*!
+     * Records the window bandwidth and latency
+     *\param t the window end time
+     */
+    void measure(const uint64_t);
+
+    /*!
+     * Checks whether two samples have the same structure and
+     * the same discrete state
+     *\param a the first sample
+     *\param b the second sample
+     *\return true if the VALUE entries repeat
+     */
+    static bool repeats(const StateWalker::Sample&,
+                        const StateWalker::Sample&);
+
+    /*!
+     * Extrapolates the engine state over the skipped interval
+     *\param c the window end state
+     *\return true if the engine time was advanced
+     */
+    bool skip(const StateWalker::Sample&);
+
+    /*!
+     * Handles a wakeup while sampling
+     *\return true if the engine time was advanced
+     */
+    bool update();
+
+public:
+
+    /*!
+     * Constructor
+     *\param t pointer to TPM
+     */
+    Sampler(TrafficProfileManager*);
+
+    //! Default destructor
+    virtual ~Sampler() = default;
+
+    /*!
+     * Enables sampling, from the next wakeup
+     *\param w measurement window length, in ATP time units
+     *\param i skipped interval length, in ATP time units
+     *\param warm detailed warming length, in ATP time units
+     *\param c confidence level of the reported bounds
+     */
+    void enable(const uint64_t, const uint64_t, const uint64_t = 0,
+                const double = defaultConfidence);
+
+    //! Disables sampling
+    void disable();
+
+    //! Clears the samples and the counters
+    void reset();
+
+    //! returns whether sampling is enabled
+    inline bool isEnabled() const { return enabled; }
+
+    /*!
+     * Measures or skips the engine, called by the TPM loop after each
+     * wakeup
+     *\return true if the engine time was advanced
+     */
+    inline bool step() {
+        return (__builtin_expect(enabled, 0) ? update() : false);
+    }
+
+    //! returns the number of measured windows
+    inline uint64_t getWindows() const { return bandwidth.n; }
+
+    //! returns the number of skips
+    inline uint64_t getSkips() const { return skips; }
+
+    //! returns the skipped ATP time
+    inline uint64_t getSkippedTime() const { return skippedTime; }
+
+    //! returns the number of windows not skipped as they dispatched events
+    inline uint64_t getEventWindows() const { return eventWindows; }
+
+    //! returns the mean window bandwidth, in bytes per second
+    double getBandwidth() const;
+
+    //! returns the bandwidth confidence interval half-width
+    double getBandwidthError() const;
+
+    //! returns the mean window latency, in seconds
+    double getLatency() const;
+
+    //! returns the latency confidence interval half-width
+    double getLatencyError() const;
+
+    /*!
+     * Dumps the sampling results
+     *\return a formatted string with the estimates and their bounds
+     */
+    const string dump() const;
+};
+
+} // end of namespace
+
+#endif /* __AMBA_TRAFFIC_PROFILE_SAMPLER_HH__ */
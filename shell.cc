@@ -519,6 +519,12 @@ void Shell::testAgainstSlave(const string& null) {
     test->testAgainstInternalSlave(slaveBandwidth, slaveLatency);
 }
 
+void Shell::estimate(const string& null) {
+    (void)null;
+    test->estimate({ test->getTpm()->getRateScale() }, { slaveBandwidth },
+                   { slaveLatency });
+}
+
 void Shell::reset(const string& null) {
     (void)null;
     test->getTpm()->reset();
@@ -621,12 +627,13 @@ void Shell::streamStatus(const string& root) {
     const uint64_t rootId = test->getTpm()->profileId(root);
 
     if (rootId < numeric_limits<uint64_t>::max()) {
-        const auto& stream = test->getTpm()->getStreamCache();
-        if (stream.find(rootId)!=stream.end()) {
-            for (const auto& node: stream.at(rootId)) {
-                PROMPT(test->getTpm()->getProfile(node.first)->getName(),
-                        node.first==rootId?
-                                "root":(node.second?"leaf":"intermediate"),"\n");
+        const auto& topology = test->getTpm()->getStreamTopology();
+        if (topology.has(rootId)) {
+            const auto stream = topology.stream(rootId);
+            for (uint64_t i = 0; i < stream.size(); ++i) {
+                PROMPT(test->getTpm()->profileName(stream.node(i)),
+                        stream.node(i)==rootId?
+                                "root":(stream.leaf(i)?"leaf":"intermediate"),"\n");
             }
             const bool terminated = test->getTpm()->streamTerminated(rootId);
             PROMPT("The stream is",terminated?"terminated\n":"not terminated\n");
@@ -679,8 +686,9 @@ void Shell::lsMasters(const string& null) const {
 
 void Shell::lsStreams(const string& null) const {
     (void) null;
-    for (const auto&s: test->getTpm()->getStreamCache()) {
-        PROMPT(test->getTpm()->getProfile(s.first)->getName(),"\n");
+    const auto& topology = test->getTpm()->getStreamTopology();
+    for (uint64_t i = 0; i < topology.size(); ++i) {
+        PROMPT(test->getTpm()->profileName(topology.at(i).root()),"\n");
     }
 }
 
@@ -691,6 +699,29 @@ void Shell::lsFiles(const string& null) const {
     }
 }
 
+void Shell::engineProfileOn(const string& null) {
+    (void) null;
+    test->getTpm()->enableEngineProfile();
+    PROMPT("Engine profiler on\n");
+}
+
+void Shell::engineProfileOff(const string& null) {
+    (void) null;
+    test->getTpm()->disableEngineProfile();
+    PROMPT("Engine profiler off\n");
+}
+
+void Shell::engineProfileShow(const string& null) const {
+    (void) null;
+    PROMPT(test->getTpm()->getEngineProfile().dump());
+}
+
+void Shell::engineProfileReset(const string& null) {
+    (void) null;
+    test->getTpm()->getEngineProfiler().reset();
+    PROMPT("Engine profiler measurements cleared\n");
+}
+
 void Shell::hello(const string& world) const {
     PROMPT("The world is",world,"\n");
     PROMPT("    (        )\n");
@@ -57,6 +57,9 @@ protected:
             {"load",    makeCommand(&Shell::load, "loads an atp file")},
             {"test",    makeTpmCommand(&Shell::testAgainstSlave,
                         "plays loaded atp files")},
+            {"estimate", makeTpmCommand(&Shell::estimate,
+                        "estimates the masters bandwidth and latency "
+                        "against the ATP slave, without playing")},
             {"flush",   makeTpmCommand(&Shell::flush,
                         "flushes loaded ATP profiles")},
             {"verbose", makeCommand(&Shell::verbose,
@@ -104,6 +107,19 @@ protected:
                                     "optionally associated to a master. "
                                     "Usage: unique root master")}
                 })
+            },
+            {"profile", make_pair("Runs engine self-profiler commands",
+                CommandMap {
+                    {"on",    makeTpmCommand(&Shell::engineProfileOn,
+                              "Starts measuring the engine hot paths")},
+                    {"off",   makeTpmCommand(&Shell::engineProfileOff,
+                              "Stops measuring the engine hot paths")},
+                    {"show",  makeTpmCommand(&Shell::engineProfileShow,
+                              "Prints the engine measurements per role "
+                              "and per profile")},
+                    {"reset", makeTpmCommand(&Shell::engineProfileReset,
+                              "Clears the engine measurements")}
+                })
             }
     };
 
@@ -335,6 +351,13 @@ public:
      */
     void testAgainstSlave(const string& null);
 
+    /*!
+     * Estimates the loaded files performance
+     * against ATP internal slave
+     *\param null unused
+     */
+    void estimate(const string& null);
+
     /*!
      * Enables ATP verbose mode
      *\param null unused
@@ -414,6 +437,20 @@ public:
 
     //! lists loaded Stream roots
     void lsStreams(const string& null) const;
+
+    /// profile SubCommands
+
+    //! enables the engine self-profiler
+    void engineProfileOn(const string& null);
+
+    //! disables the engine self-profiler
+    void engineProfileOff(const string& null);
+
+    //! prints the engine self-profiler measurements
+    void engineProfileShow(const string& null) const;
+
+    //! clears the engine self-profiler measurements
+    void engineProfileReset(const string& null);
 };
 
 } /* namespace TrafficProfiles */
@@ -0,0 +1,250 @@
+/*
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ *
+ * Copyright (c) 2026 ARM Limited
+ * All rights reserved
+ *  Created on: Oct 18, 2026
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <new>
+#include <thread>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "shm_channel.hh"
+#include "logger.hh"
+
+namespace TrafficProfiles {
+
+const char ShmChannel::magic[8] = { 'A', 'T', 'P', 'S', 'H', 'M', '0', '1' };
+
+static_assert(atomic<uint64_t>::is_always_lock_free &&
+              atomic<bool>::is_always_lock_free,
+              "ShmRing requires address-free atomics");
+
+uint64_t ShmRing::bytes(const uint64_t n, const uint64_t s) {
+    return sizeof(Control) + n * s;
+}
+
+ShmRing::ShmRing(): control(nullptr), slots(nullptr), count(0),
+        slotSize(0), reserved(0), consumed(0) {
+}
+
+void ShmRing::map(void* m, const uint64_t n, const uint64_t s,
+                  const bool init) {
+    control = static_cast<Control*>(m);
+    slots = static_cast<char*>(m) + sizeof(Control);
+    count = n;
+    slotSize = s;
+    reserved = consumed = 0;
+    if (init) {
+        new (control) Control;
+        control->head.store(0, memory_order_relaxed);
+        control->tail.store(0, memory_order_relaxed);
+    }
+}
+
+ShmRing::Message* ShmRing::reserve() {
+    // only the producer writes the tail
+    const uint64_t position =
+            control->tail.load(memory_order_relaxed) + reserved;
+    if (position - control->head.load(memory_order_acquire) >= count) {
+        return nullptr;
+    }
+    ++reserved;
+    return slot(position);
+}
+
+void ShmRing::publish() {
+    if (reserved > 0) {
+        control->tail.fetch_add(reserved, memory_order_release);
+        reserved = 0;
+    }
+}
+
+const ShmRing::Message* ShmRing::peek() const {
+    // only the consumer writes the head
+    const uint64_t position =
+            control->head.load(memory_order_relaxed) + consumed;
+    if (position >= control->tail.load(memory_order_acquire)) {
+        return nullptr;
+    }
+    return slot(position);
+}
+
+void ShmRing::release() {
+    if (consumed > 0) {
+        control->head.fetch_add(consumed, memory_order_release);
+        consumed = 0;
+    }
+}
+
+ShmChannel::ShmChannel(): owner(false), client(false), segment(nullptr),
+        size(0), header(nullptr) {
+}
+
+ShmChannel::~ShmChannel() {
+    close();
+}
+
+string ShmChannel::channelName(const string& server, const uint64_t engine) {
+    return "/" + server + "." + to_string(engine);
+}
+
+void ShmChannel::mapRings(const bool init) {
+    const uint64_t offset = (sizeof(Header) + 63) & ~63ULL;
+    const uint64_t ring = ShmRing::bytes(header->slots, header->slotSize);
+    char* base = static_cast<char*>(segment);
+    requests.map(base + offset, header->slots, header->slotSize, init);
+    responses.map(base + offset + ring, header->slots, header->slotSize,
+                  init);
+}
+
+bool ShmChannel::create(const string& n, const uint64_t slots,
+                        const uint64_t slotSize) {
+    close();
+    uint64_t count = 1;
+    while (count < slots) {
+        count <<= 1;
+    }
+    // slots are aligned to the messages
+    const uint64_t s = (max<uint64_t>(slotSize, 2 * sizeof(ShmRing::Message))
+                        + 7) & ~7ULL;
+    // stale segments of crashed servers are replaced
+    shm_unlink(n.c_str());
+    const int fd = shm_open(n.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0) {
+        WARN("ShmChannel::create unable to create", n, strerror(errno));
+        return false;
+    }
+    size = ((sizeof(Header) + 63) & ~63ULL) + 2 * ShmRing::bytes(count, s);
+    if (ftruncate(fd, size) != 0) {
+        WARN("ShmChannel::create unable to size", n, strerror(errno));
+        ::close(fd);
+        shm_unlink(n.c_str());
+        return false;
+    }
+    segment = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (segment == MAP_FAILED) {
+        WARN("ShmChannel::create unable to map", n, strerror(errno));
+        segment = nullptr;
+        shm_unlink(n.c_str());
+        return false;
+    }
+    name = n;
+    owner = true;
+    header = new (segment) Header;
+    header->slots = count;
+    header->slotSize = s;
+    header->serving.store(false, memory_order_relaxed);
+    header->attached.store(false, memory_order_relaxed);
+    mapRings(true);
+    // the magic is written last, once the segment is initialised
+    atomic_thread_fence(memory_order_release);
+    memcpy(header->magic, magic, sizeof(magic));
+    LOG("ShmChannel::create", n, "with", count, "slots of", s, "bytes");
+    return true;
+}
+
+bool ShmChannel::attach(const string& n) {
+    close();
+    const int fd = shm_open(n.c_str(), O_RDWR, 0);
+    if (fd < 0) {
+        WARN("ShmChannel::attach unable to open", n, strerror(errno));
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (uint64_t)st.st_size < sizeof(Header)) {
+        WARN("ShmChannel::attach", n, "is not an ATP channel");
+        ::close(fd);
+        return false;
+    }
+    size = st.st_size;
+    segment = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (segment == MAP_FAILED) {
+        WARN("ShmChannel::attach unable to map", n, strerror(errno));
+        segment = nullptr;
+        return false;
+    }
+    header = static_cast<Header*>(segment);
+    const uint64_t offset = (sizeof(Header) + 63) & ~63ULL;
+    if (memcmp(header->magic, magic, sizeof(magic)) != 0 ||
+        header->slots == 0 || (header->slots & (header->slots - 1)) != 0 ||
+        offset + 2 * ShmRing::bytes(header->slots, header->slotSize) > size) {
+        WARN("ShmChannel::attach", n, "is not an ATP channel");
+        close();
+        return false;
+    }
+    atomic_thread_fence(memory_order_acquire);
+    bool expected = false;
+    if (!header->attached.compare_exchange_strong(expected, true)) {
+        WARN("ShmChannel::attach", n, "is in use by another client");
+        close();
+        return false;
+    }
+    name = n;
+    client = true;
+    mapRings(false);
+    LOG("ShmChannel::attach attached to", n);
+    return true;
+}
+
+void ShmChannel::close() {
+    if (client) {
+        // the channel can be attached to by another client
+        header->attached.store(false, memory_order_release);
+        client = false;
+    }
+    if (segment != nullptr) {
+        munmap(segment, size);
+        segment = nullptr;
+        header = nullptr;
+    }
+    if (owner) {
+        shm_unlink(name.c_str());
+        owner = false;
+    }
+    name.clear();
+    size = 0;
+}
+
+bool ShmChannel::encode(const ShmRing& r, ShmRing::Message* m,
+                        const Packet& p) {
+    const uint64_t length = p.ByteSizeLong();
+    if (length > r.capacity()) {
+        return false;
+    }
+    // serialised in place, packets may not set all required fields
+    m->length = length;
+    return p.SerializePartialToArray(m->payload(), length);
+}
+
+void ShmChannel::encode(const ShmRing& r, ShmRing::Message* m,
+                        const string& s) {
+    m->length = min<uint64_t>(s.size(), r.capacity());
+    memcpy(m->payload(), s.data(), m->length);
+}
+
+bool ShmChannel::decode(const ShmRing::Message* m, Packet& p) {
+    return p.ParsePartialFromArray(m->payload(), m->length);
+}
+
+void ShmChannel::backoff(uint64_t& n) {
+    if (n < 1024) {
+        // spinning keeps the round trip latency low
+    } else if (n < 4096) {
+        this_thread::yield();
+    } else {
+        this_thread::sleep_for(chrono::microseconds(50));
+    }
+    ++n;
+}
+
+} // end of namespace
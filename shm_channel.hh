@@ -0,0 +1,293 @@
+/*
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ *
+ * Copyright (c) 2026 ARM Limited
+ * All rights reserved
+ *  Created on: Oct 18, 2026
+ */
+
+#ifndef __AMBA_TRAFFIC_PROFILE_SHM_CHANNEL_HH__
+#define __AMBA_TRAFFIC_PROFILE_SHM_CHANNEL_HH__
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include "proto/tp_packet.pb.h"
+
+using namespace std;
+
+namespace TrafficProfiles {
+
+/*!
+ *\brief Lock-free single producer, single consumer message ring
+ *
+ * A ring of fixed-size message slots, laid out in memory shared by
+ * two processes. The producer reserves and fills slots, then publishes
+ * them all at once; the consumer reads published slots in place, then
+ * releases them all at once. Slots are handed over through the head and
+ * tail counters only, with acquire/release ordering: no locks and no
+ * system calls are involved.
+ */
+class ShmRing {
+
+public:
+
+    //! Message header, followed by its payload in the slot
+    struct Message {
+        //! message type, defined by the channel users
+        uint32_t type;
+        //! payload length, in bytes
+        uint32_t length;
+        //! message ATP time
+        uint64_t time;
+        //! message value, defined by the message type
+        uint64_t value;
+
+        //! returns the message payload
+        inline char* payload() { return reinterpret_cast<char*>(this + 1); }
+
+        //! returns the message payload
+        inline const char* payload() const {
+            return reinterpret_cast<const char*>(this + 1);
+        }
+    };
+
+    //! Ring control block, at the start of the ring memory
+    struct Control {
+        //! slots released by the consumer
+        alignas(64) atomic<uint64_t> head;
+        //! slots published by the producer
+        alignas(64) atomic<uint64_t> tail;
+    };
+
+protected:
+
+    //! control block, in shared memory
+    Control* control;
+
+    //! first slot, in shared memory
+    char* slots;
+
+    //! number of slots, a power of two
+    uint64_t count;
+
+    //! slot size, in bytes
+    uint64_t slotSize;
+
+    //! slots reserved by the producer and not yet published
+    uint64_t reserved;
+
+    //! slots read by the consumer and not yet released
+    uint64_t consumed;
+
+    //! returns the slot at a ring position
+    inline Message* slot(const uint64_t position) const {
+        return reinterpret_cast<Message*>(
+                slots + (position & (count - 1)) * slotSize);
+    }
+
+public:
+
+    /*!
+     * Returns the memory taken by a ring
+     *\param n number of slots
+     *\param s slot size, in bytes
+     *\return the ring size, in bytes
+     */
+    static uint64_t bytes(const uint64_t, const uint64_t);
+
+    //! Creates an unmapped ring
+    ShmRing();
+
+    /*!
+     * Maps a ring onto memory
+     *\param m the ring memory, of ShmRing::bytes size
+     *\param n number of slots, a power of two
+     *\param s slot size, in bytes
+     *\param init true to initialise the control block
+     */
+    void map(void*, const uint64_t, const uint64_t, const bool);
+
+    //! returns the payload capacity of a slot, in bytes
+    inline uint64_t capacity() const { return slotSize - sizeof(Message); }
+
+    /*!
+     * Reserves the next free slot, producer side
+     *\return the slot, nullptr if the ring is full
+     */
+    Message* reserve();
+
+    //! Publishes all the reserved slots, producer side
+    void publish();
+
+    /*!
+     * Reads the next published slot in place, consumer side
+     *\return the slot, nullptr if the ring is empty
+     */
+    const Message* peek() const;
+
+    //! Marks the peeked slot as read, consumer side
+    inline void consume() { ++consumed; }
+
+    //! Releases all the read slots to the producer, consumer side
+    void release();
+};
+
+/*!
+ *\brief Shared memory engine channel
+ *
+ * A POSIX shared memory segment, created by an engine server and
+ * attached to by one client at a time, holding a requests ring
+ * (client to server) and a responses ring (server to client).
+ * Packets are encoded directly into the ring slots and decoded
+ * directly from them.
+ */
+class ShmChannel {
+
+public:
+
+    //! Channel segment magic
+    static const char magic[8];
+
+    //! Message types
+    enum Type : uint32_t {
+        SEND,     //!< client: packets request at the message time
+        RECEIVE,  //!< client: packet delivery at the message time
+        SET_TIME, //!< client: sets the engine time, no response
+        DETACH,   //!< client: releases the channel, no response
+        PACKET,   //!< server: a packet generated by the engine
+        SENT,     //!< server: end of packets, value is the locked flag,
+                  //!< time is the next transmission time
+        RECEIVED, //!< server: value is true if the packet was accepted
+        FAILED    //!< server: the engine raised an error, in the payload
+    };
+
+    //! Segment header, at the start of the segment
+    struct Header {
+        //! segment magic
+        char magic[8];
+        //! number of slots per ring
+        uint64_t slots;
+        //! slot size, in bytes
+        uint64_t slotSize;
+        //! true while the server is serving the channel
+        atomic<bool> serving;
+        //! true while a client is attached
+        atomic<bool> attached;
+    };
+
+protected:
+
+    //! shared memory object name
+    string name;
+
+    //! true if created by this process, which unlinks it
+    bool owner;
+
+    //! true if attached to by this process, which detaches on close
+    bool client;
+
+    //! segment mapping
+    void* segment;
+
+    //! segment size, in bytes
+    uint64_t size;
+
+    //! segment header
+    Header* header;
+
+    //! client to server ring
+    ShmRing requests;
+
+    //! server to client ring
+    ShmRing responses;
+
+    //! Maps the rings onto the segment
+    void mapRings(const bool);
+
+public:
+
+    //! Creates a closed channel
+    ShmChannel();
+
+    /*!
+     * Returns the channel name of a hosted engine
+     *\param server the server name
+     *\param engine the engine index
+     *\return the shared memory object name
+     */
+    static string channelName(const string&, const uint64_t);
+
+    //! Unmaps the channel, unlinking it if the owner
+    virtual ~ShmChannel();
+
+    ShmChannel(const ShmChannel&) = delete;
+    ShmChannel& operator=(const ShmChannel&) = delete;
+
+    /*!
+     * Creates a channel segment, server side
+     *\param n the shared memory object name, e.g. /atp.0
+     *\param slots number of slots per ring, rounded to a power of two
+     *\param slotSize slot size, in bytes
+     *\return true if the segment was created
+     */
+    bool create(const string&, const uint64_t, const uint64_t);
+
+    /*!
+     * Attaches to a channel segment, client side
+     *\param n the shared memory object name
+     *\return true if attached, false if missing, invalid or in use
+     */
+    bool attach(const string&);
+
+    //! Unmaps the channel, unlinking it if the owner
+    void close();
+
+    //! returns true if the channel is mapped
+    inline bool isOpen() const { return header != nullptr; }
+
+    //! returns the segment header
+    inline Header* getHeader() { return header; }
+
+    //! returns the client to server ring
+    inline ShmRing& getRequests() { return requests; }
+
+    //! returns the server to client ring
+    inline ShmRing& getResponses() { return responses; }
+
+    /*!
+     * Encodes a packet into a message payload
+     *\param r the ring the message belongs to
+     *\param m the message
+     *\param p the packet
+     *\return false if the packet doesn't fit the slot
+     */
+    static bool encode(const ShmRing&, ShmRing::Message*, const Packet&);
+
+    /*!
+     * Encodes a string into a message payload, truncating it
+     *\param r the ring the message belongs to
+     *\param m the message
+     *\param s the string
+     */
+    static void encode(const ShmRing&, ShmRing::Message*, const string&);
+
+    /*!
+     * Decodes a packet from a message payload
+     *\param m the message
+     *\param p the packet
+     *\return false if the payload is malformed
+     */
+    static bool decode(const ShmRing::Message*, Packet&);
+
+    /*!
+     * Waits for an event with increasing backoff: spins first,
+     * then yields, then sleeps
+     *\param n the number of waits so far, incremented
+     */
+    static void backoff(uint64_t&);
+};
+
+} // end of namespace
+
+#endif /* __AMBA_TRAFFIC_PROFILE_SHM_CHANNEL_HH__ */
@@ -0,0 +1,118 @@
+/*
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ *
+ * Copyright (c) 2026 ARM Limited
+ * All rights reserved
+ *  Created on: Oct 18, 2026
+ */
+
+#include <cstring>
+#include "snapshot.hh"
+#include "logger.hh"
+
+namespace TrafficProfiles {
+
+const char Snapshot::magic[8] = { 'A', 'T', 'P', 'S', 'N', 'P', '0', '1' };
+
+Snapshot::Snapshot(): mode(SAVE), data(magic, sizeof(magic)), offset(0),
+        valid(true) {
+}
+
+Snapshot::Snapshot(const string& d): mode(RESTORE), data(d),
+        offset(sizeof(magic)), valid(true) {
+    if (data.size() < sizeof(magic) ||
+        memcmp(data.data(), magic, sizeof(magic)) != 0) {
+        WARN("Snapshot: not an ATP Engine snapshot");
+        offset = data.size();
+        valid = false;
+    }
+}
+
+void Snapshot::write(const void* p, const uint64_t n) {
+    data.append(static_cast<const char*>(p), n);
+}
+
+void Snapshot::read(void* p, const uint64_t n) {
+    if (!valid || data.size() - offset < n) {
+        memset(p, 0, n);
+        valid = false;
+        return;
+    }
+    memcpy(p, data.data() + offset, n);
+    offset += n;
+}
+
+uint64_t Snapshot::size(const uint64_t n) {
+    uint64_t ret = n;
+    (*this)(ret);
+    // every element takes at least a byte
+    if (restoring() && ret > data.size() - offset) {
+        valid = false;
+        ret = 0;
+    }
+    return ret;
+}
+
+void Snapshot::operator()(string& s) {
+    const uint64_t n = size(s.size());
+    if (saving()) {
+        write(s.data(), n);
+    } else {
+        s.assign(n, '\0');
+        read(&s[0], n);
+    }
+}
+
+void Snapshot::operator()(Packet& p) {
+    // master packets may not set all required fields
+    string s;
+    if (saving()) {
+        p.SerializePartialToString(&s);
+    }
+    (*this)(s);
+    if (restoring() && valid && !p.ParsePartialFromString(s)) {
+        valid = false;
+    }
+}
+
+void Snapshot::operator()(Packet*& p) {
+    bool present = (p != nullptr);
+    (*this)(present);
+    if (restoring()) {
+        delete p;
+        p = (present ? new Packet() : nullptr);
+    }
+    if (present) {
+        (*this)(*p);
+    }
+}
+
+void Snapshot::operator()(list<Event>& l) {
+    const uint64_t n = size(l.size());
+    if (saving()) {
+        for (auto& e : l) {
+            uint64_t type = e.type, action = e.action, id = e.id,
+                     time = e.time;
+            (*this)(type);
+            (*this)(action);
+            (*this)(id);
+            (*this)(time);
+        }
+    } else {
+        l.clear();
+        for (uint64_t i = 0; i < n && valid; ++i) {
+            uint64_t type = 0, action = 0, id = 0, time = 0;
+            (*this)(type);
+            (*this)(action);
+            (*this)(id);
+            (*this)(time);
+            if (type >= Event::N_EVENTS || action > Event::TRIGGERED) {
+                valid = false;
+                break;
+            }
+            l.emplace_back((Event::Type)type, (Event::Action)action, id, time);
+        }
+    }
+}
+
+} // end of namespace
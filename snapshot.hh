@@ -0,0 +1,286 @@
+/*
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ *
+ * Copyright (c) 2026 ARM Limited
+ * All rights reserved
+ *  Created on: Oct 18, 2026
+ */
+
+#ifndef __AMBA_TRAFFIC_PROFILE_SNAPSHOT_HH__
+#define __AMBA_TRAFFIC_PROFILE_SNAPSHOT_HH__
+
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <list>
+#include <map>
+#include <set>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "event.hh"
+#include "proto/tp_packet.pb.h"
+
+using namespace std;
+
+namespace TrafficProfiles {
+
+/*!
+ *\brief Engine runtime state snapshot
+ *
+ * Engine modules serialize their runtime state through a snapshot,
+ * with the same code path for saving and restoring: in SAVE mode
+ * values are appended to a compact binary buffer, in RESTORE mode
+ * they are read back in the same order and assigned.
+ *
+ * Only runtime state is serialized: configured parameters are
+ * loaded from the configuration, hence a snapshot is restored
+ * into an engine loaded with the configuration it was saved from.
+ *
+ * Binary layout: magic, then the values in serialization order,
+ * containers as their size followed by their elements.
+ */
+class Snapshot {
+
+public:
+
+    //! Snapshot mode
+    enum Mode { SAVE, RESTORE };
+
+    //! Binary snapshot magic
+    static const char magic[8];
+
+protected:
+
+    //! snapshot mode
+    const Mode mode;
+
+    //! binary snapshot
+    string data;
+
+    //! read offset, in RESTORE mode
+    uint64_t offset;
+
+    //! false if the snapshot is malformed or doesn't match the engine
+    bool valid;
+
+    /*!
+     * Appends raw bytes to the snapshot
+     *\param p pointer to the bytes
+     *\param n number of bytes
+     */
+    void write(const void*, const uint64_t);
+
+    /*!
+     * Reads raw bytes from the snapshot, zero-filling them
+     * and invalidating the snapshot if truncated
+     *\param p pointer to the bytes
+     *\param n number of bytes
+     */
+    void read(void*, const uint64_t);
+
+public:
+
+    //! Creates a snapshot to save the engine state to
+    Snapshot();
+
+    /*!
+     * Creates a snapshot to restore the engine state from
+     *\param d the binary snapshot
+     */
+    Snapshot(const string&);
+
+    //! Default destructor
+    virtual ~Snapshot() = default;
+
+    //! returns true if saving the engine state
+    inline bool saving() const { return mode == SAVE; }
+
+    //! returns true if restoring the engine state
+    inline bool restoring() const { return mode == RESTORE; }
+
+    //! returns false if the snapshot is malformed or doesn't match
+    inline bool isValid() const { return valid; }
+
+    //! returns true if a restored snapshot has been read completely
+    inline bool atEnd() const { return offset == data.size(); }
+
+    //! returns the binary snapshot
+    inline const string& getData() const { return data; }
+
+    //! Marks the snapshot as malformed or not matching the engine
+    inline void invalidate() { valid = false; }
+
+    /*!
+     * Serializes a container size
+     *\param n the size to be saved
+     *\return the saved or restored size
+     */
+    uint64_t size(const uint64_t);
+
+    /*!
+     * Serializes an arithmetic or enumeration value
+     *\param v the value
+     */
+    template <typename T>
+    typename enable_if<is_arithmetic<T>::value || is_enum<T>::value>::type
+    operator()(T& v) {
+        if (saving()) {
+            write(&v, sizeof(v));
+        } else {
+            read(&v, sizeof(v));
+        }
+    }
+
+    /*!
+     * Serializes a string
+     *\param s the string
+     */
+    void operator()(string&);
+
+    /*!
+     * Serializes a packet, including partially set ones
+     *\param p the packet
+     */
+    void operator()(Packet&);
+
+    /*!
+     * Serializes an owned packet pointer, which is
+     * deleted and re-allocated when restoring
+     *\param p the packet pointer, can be null
+     */
+    void operator()(Packet*&);
+
+    /*!
+     * Serializes a list of events
+     *\param l the events list
+     */
+    void operator()(list<Event>&);
+
+    /*!
+     * Serializes a pair
+     *\param p the pair
+     */
+    template <typename A, typename B>
+    void operator()(pair<A, B>& p) {
+        (*this)(p.first);
+        (*this)(p.second);
+    }
+
+    /*!
+     * Serializes a fixed-size array
+     *\param a the array
+     */
+    template <typename T, size_t N>
+    void operator()(array<T, N>& a) {
+        for (auto& e : a) {
+            (*this)(e);
+        }
+    }
+
+    /*!
+     * Serializes a sequence container
+     *\param c the container
+     */
+    template <typename T>
+    void operator()(vector<T>& c) { sequence(c); }
+
+    template <typename T>
+    void operator()(list<T>& c) { sequence(c); }
+
+    template <typename T>
+    void operator()(deque<T>& c) { sequence(c); }
+
+    /*!
+     * Serializes an ordered set
+     *\param c the set
+     */
+    template <typename K, typename C>
+    void operator()(set<K, C>& c) {
+        const uint64_t n = size(c.size());
+        if (saving()) {
+            for (auto k : c) {
+                (*this)(k);
+            }
+        } else {
+            c.clear();
+            for (uint64_t i = 0; i < n && valid; ++i) {
+                K k {};
+                (*this)(k);
+                c.insert(move(k));
+            }
+        }
+    }
+
+    /*!
+     * Serializes an ordered map
+     *\param c the map
+     */
+    template <typename K, typename V, typename C>
+    void operator()(map<K, V, C>& c) {
+        const uint64_t n = size(c.size());
+        if (saving()) {
+            for (auto& e : c) {
+                K k = e.first;
+                (*this)(k);
+                (*this)(e.second);
+            }
+        } else {
+            c.clear();
+            for (uint64_t i = 0; i < n && valid; ++i) {
+                K k {};
+                V v {};
+                (*this)(k);
+                (*this)(v);
+                c.emplace(move(k), move(v));
+            }
+        }
+    }
+
+    /*!
+     * Serializes a value through its stream operators,
+     * e.g. random engines and distributions
+     *\param v the value
+     */
+    template <typename T>
+    void text(T& v) {
+        string s;
+        if (saving()) {
+            stringstream ss;
+            ss << v;
+            s = ss.str();
+        }
+        (*this)(s);
+        if (restoring()) {
+            stringstream ss(s);
+            ss >> v;
+            if (ss.fail()) {
+                invalidate();
+            }
+        }
+    }
+
+protected:
+
+    /*!
+     * Serializes a resizable sequence container
+     *\param c the container
+     */
+    template <typename C>
+    void sequence(C& c) {
+        const uint64_t n = size(c.size());
+        if (restoring()) {
+            c.clear();
+            c.resize(n);
+        }
+        for (auto& e : c) {
+            (*this)(e);
+        }
+    }
+};
+
+} // end of namespace
+
+#endif /* __AMBA_TRAFFIC_PROFILE_SNAPSHOT_HH__ */
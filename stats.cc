@@ -9,6 +9,8 @@
 
 #include "stats.hh"
 #include "utilities.hh"
+#include "fast_forward.hh"
+#include "snapshot.hh"
 #include <sstream>
 #include <algorithm>
 
@@ -21,7 +23,7 @@ Stats::Stats():
         dataReceived(0), prevLatency(.0), jitter(.0),
         latency(.0), underruns(0), overruns(0),
         ot(0), otN(0), fifoLevel(0),
-        fifoLevelN(0) {
+        fifoLevelN(0), convergence(UNMONITORED) {
 }
 
 Stats::~Stats() {
@@ -78,6 +80,59 @@ Stats::receive (const uint64_t t,const uint64_t data, const double l) {
     jitter += ((fabs(l-prevLatency) - jitter)/16);
     prevLatency = l;
     latency += l;
+
+    if (!latencyHistogram.empty()) {
+        latencyHistogram[latencyBucket(l)]++;
+    }
+}
+
+uint64_t Stats::latencyBucket(const double l) {
+    const uint64_t v = (l > 0 ? llround(l) : 0);
+    const uint64_t linear = 1ULL << subBucketBits;
+    // latencies below the sub-buckets count map one to one
+    if (v < linear) {
+        return v;
+    }
+    // power of two group and sub-bucket within the group
+    const uint64_t e = 63 - __builtin_clzll(v);
+    const uint64_t sub = (v >> (e - subBucketBits)) - linear;
+    return (e - subBucketBits + 1) * linear + sub;
+}
+
+double Stats::bucketLatency(const uint64_t b) {
+    const uint64_t linear = 1ULL << subBucketBits;
+    if (b < linear) {
+        return b;
+    }
+    const uint64_t shift = b / linear - 1;
+    const double low = (double)((linear + b % linear) << shift);
+    return low + (double)(1ULL << shift) / 2;
+}
+
+void Stats::enableLatencyHistogram() {
+    if (latencyHistogram.empty()) {
+        // one group per power of two above the linear range
+        latencyHistogram.assign((64 - subBucketBits + 1) << subBucketBits, 0);
+    }
+}
+
+double Stats::latencyPercentile(const double p) const {
+    uint64_t total = 0;
+    for (auto c : latencyHistogram) {
+        total += c;
+    }
+    if (total == 0) {
+        return 0;
+    }
+    const uint64_t rank = max<uint64_t>(1, ceil(p * total));
+    uint64_t count = 0;
+    for (uint64_t b = 0; b < latencyHistogram.size(); ++b) {
+        count += latencyHistogram[b];
+        if (count >= rank) {
+            return bucketLatency(b) / timeScale;
+        }
+    }
+    return bucketLatency(latencyHistogram.size() - 1) / timeScale;
 }
 
 void
@@ -105,6 +160,15 @@ Stats::dump() const {
        << " average FIFO level: " << avgFifoLevel()
        << " FIFO underruns: "   << underruns
        << " FIFO overruns: "    << overruns;
+    if (!latencyHistogram.empty()) {
+        ss << " latency p50: "   << Utilities::toTimeString(latencyPercentile(.5))
+           << " p90: "           << Utilities::toTimeString(latencyPercentile(.9))
+           << " p99: "           << Utilities::toTimeString(latencyPercentile(.99))
+           << " p99.9: "         << Utilities::toTimeString(latencyPercentile(.999));
+    }
+    if (convergence != UNMONITORED) {
+        ss << " converged: " << (convergence == CONVERGED ? "yes" : "no");
+    }
     return ss.str();
 }
 
@@ -125,6 +189,9 @@ Stats::xport() const {
     ret->set_overruns(overruns);
     ret->set_ot(avgOt());
     ret->set_fifolevel(avgFifoLevel());
+    if (convergence != UNMONITORED) {
+        ret->set_converged(convergence == CONVERGED);
+    }
     return ret;
 }
 
@@ -148,6 +215,19 @@ Stats Stats::operator+(const Stats& s) {
     ret.otN = this->otN + s.otN;
     ret.fifoLevel = this->fifoLevel + s.fifoLevel;
     ret.fifoLevelN = this->fifoLevelN + s.fifoLevelN;
+    // merge the latency histograms, if any
+    ret.latencyHistogram = (this->latencyHistogram.empty() ?
+                            s.latencyHistogram : this->latencyHistogram);
+    if (!this->latencyHistogram.empty() && !s.latencyHistogram.empty()) {
+        for (uint64_t b = 0; b < ret.latencyHistogram.size(); ++b) {
+            ret.latencyHistogram[b] += s.latencyHistogram[b];
+        }
+    }
+    // converged only if all monitored statistics have converged
+    ret.convergence = max(this->convergence, s.convergence);
+    if (this->convergence == MONITORED || s.convergence == MONITORED) {
+        ret.convergence = MONITORED;
+    }
     return ret;
 }
 
@@ -156,4 +236,40 @@ Stats& Stats::operator+=(const Stats& s) {
     return *this;
 }
 
+void Stats::walk(StateWalker& w) {
+    w(started);
+    w(startTime);
+    w(time, StateWalker::TIME);
+    for (auto* c : { &sent, &received, &dataSent, &dataReceived,
+                     &underruns, &overruns, &ot, &otN, &fifoLevelN }) {
+        w(*c, StateWalker::LINEAR);
+    }
+    // FIFO levels may themselves advance linearly
+    w(fifoLevel, StateWalker::QUADRATIC);
+    w(prevLatency);
+    w(jitter);
+    w(latency, StateWalker::LINEAR);
+    w(convergence);
+    w.size(latencyHistogram);
+    for (auto& b : latencyHistogram) {
+        w(b, StateWalker::LINEAR);
+    }
+}
+
+void Stats::serialize(Snapshot& s) {
+    s(started);
+    s(startTime);
+    s(time);
+    for (auto* c : { &sent, &received, &dataSent, &dataReceived,
+                     &underruns, &overruns, &ot, &otN, &fifoLevel,
+                     &fifoLevelN }) {
+        s(*c);
+    }
+    s(prevLatency);
+    s(jitter);
+    s(latency);
+    s(latencyHistogram);
+    s(convergence);
+}
+
 } /* namespace TrafficProfiles */
@@ -14,12 +14,17 @@
 #include <string>
 #include <cmath>
 #include <limits>
+#include <vector>
 
 #include "proto/tp_stats.pb.h"
 
 using namespace std;
 
 namespace TrafficProfiles {
+
+class StateWalker;
+class Snapshot;
+
 /*!
  *\brief Statistics collection class
  *
@@ -31,6 +36,23 @@ class Stats {
     //! started flag : signals that the start time has been initialised
     bool started;
 
+    //! latency histogram sub-buckets per power of two, log2
+    static const uint64_t subBucketBits = 4;
+
+    /*!
+     * Maps a latency to its histogram bucket
+     *\param l the latency, in ATP time units
+     *\return the bucket index
+     */
+    static uint64_t latencyBucket(const double);
+
+    /*!
+     * Returns the latency represented by a histogram bucket
+     *\param b the bucket index
+     *\return the bucket mid-point latency, in ATP time units
+     */
+    static double bucketLatency(const uint64_t);
+
 public:
     //! Start time since when stats are computed
     uint64_t startTime;
@@ -67,6 +89,16 @@ public:
 
     //! Number of FIFO level measurements
     uint64_t fifoLevelN;
+    /*!
+     * Response latency histogram, with log-linear buckets
+     * (about 6% resolution) - empty when disabled
+     */
+    vector<uint64_t> latencyHistogram;
+
+    //! Steady-state convergence status
+    enum Convergence : uint8_t { UNMONITORED, MONITORED, CONVERGED };
+    //! whether the statistics were monitored for convergence and have converged
+    Convergence convergence;
 
     //! Default Constructor
     Stats();
@@ -100,7 +132,27 @@ public:
         sent=0, received=0, dataSent=0,
         dataReceived=0, prevLatency=.0, jitter=.0, latency=.0,
         underruns=0, overruns=0, ot=0, otN=0, fifoLevel=0,
-        fifoLevelN=0;}
+        fifoLevelN=0;
+        latencyHistogram.assign(latencyHistogram.size(), 0);
+        if (convergence==CONVERGED) convergence=MONITORED;}
+
+    /*!
+     * Enables the response latency histogram,
+     * required to compute latency percentiles
+     */
+    void enableLatencyHistogram();
+
+    //! returns whether the response latency histogram is enabled
+    inline bool hasLatencyHistogram() const
+    { return !latencyHistogram.empty(); }
+
+    /*!
+     * Method to compute and get a response latency percentile,
+     * requires the latency histogram
+     *\param p the percentile, in (0,1]
+     *\return the percentile latency in seconds, 0 if not available
+     */
+    double latencyPercentile(const double) const;
 
     /*!
      * Starts the statistics from the given time,
@@ -191,6 +243,19 @@ public:
     *\return this object by reference
     */
     Stats& operator+=(const Stats&);
+
+    /*!
+     * Walks the statistics for fast-forward: counters advance
+     * linearly, the jitter estimator must repeat
+     *\param w the state walker
+     */
+    void walk(StateWalker&);
+
+    /*!
+     * Saves or restores the statistics to or from a snapshot
+     *\param s the snapshot
+     */
+    void serialize(Snapshot&);
 };
 
 } /* namespace TrafficProfiles */
@@ -0,0 +1,134 @@
+/*
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ *
+ * Copyright (c) 2026 ARM Limited
+ * All rights reserved
+ *  Created on: Oct 18, 2026
+ */
+
+#include "stream_topology.hh"
+#include "logger.hh"
+#include "types.hh"
+
+namespace TrafficProfiles {
+
+StreamTopology::StreamTopology(): offsets(1, 0) {
+}
+
+uint64_t StreamTopology::index(const uint64_t root) const {
+    return (root < rootIndex.size() ? rootIndex[root] : InvalidId<uint64_t>());
+}
+
+void StreamTopology::add(const vector<uint64_t>& ids,
+                         const vector<bool>& isLeaf,
+                         const uint64_t terminated) {
+    if (ids.empty() || ids.size() != isLeaf.size()) {
+        ERROR("StreamTopology::add malformed stream of",ids.size(),
+              "nodes and",isLeaf.size(),"leaf flags");
+    }
+    const uint64_t root { ids.front() };
+    if (has(root)) {
+        ERROR("StreamTopology::add duplicated stream root",root);
+    }
+    const uint64_t idx { size() };
+    uint64_t leavesNum { 0 };
+
+    nodes.insert(nodes.end(), ids.begin(), ids.end());
+    leaves.insert(leaves.end(), isLeaf.begin(), isLeaf.end());
+    offsets.push_back(nodes.size());
+
+    for (uint64_t i = 0; i < ids.size(); ++i) {
+        if (isLeaf[i]) {
+            if (ids[i] >= leafOf.size()) {
+                leafOf.resize(ids[i] + 1);
+            }
+            leafOf[ids[i]].push_back(idx);
+            leavesNum++;
+        }
+    }
+    leafCount.push_back(leavesNum);
+    terminatedLeaves.push_back(terminated);
+
+    if (root >= rootIndex.size()) {
+        rootIndex.resize(root + 1, InvalidId<uint64_t>());
+    }
+    rootIndex[root] = idx;
+}
+
+void StreamTopology::clone(const uint64_t origin, const vector<uint64_t>& ids) {
+    const Stream from { stream(origin) };
+    if (ids.size() != from.size()) {
+        ERROR("StreamTopology::clone stream",origin,"has",from.size(),
+              "nodes, clone has",ids.size());
+    }
+    // leaf flags are shared with the origin stream
+    vector<bool> isLeaf (leaves.begin() + offsets[index(origin)],
+                         leaves.begin() + offsets[index(origin) + 1]);
+    add(ids, isLeaf);
+}
+
+bool StreamTopology::has(const uint64_t root) const {
+    return isValid(index(root));
+}
+
+StreamTopology::Stream StreamTopology::at(const uint64_t i) const {
+    return Stream(this, offsets[i], offsets[i + 1] - offsets[i]);
+}
+
+StreamTopology::Stream StreamTopology::stream(const uint64_t root) const {
+    const uint64_t idx { index(root) };
+    if (!isValid(idx)) {
+        ERROR("StreamTopology::stream unknown stream root",root);
+        return Stream(this, 0, 0);
+    }
+    return at(idx);
+}
+
+bool StreamTopology::terminated(const uint64_t root) const {
+    const uint64_t idx { index(root) };
+    if (!isValid(idx)) {
+        ERROR("StreamTopology::terminated unknown stream root",root);
+        return false;
+    }
+    return terminatedLeaves[idx] == leafCount[idx];
+}
+
+void StreamTopology::leafTerminated(const uint64_t id) {
+    if (id < leafOf.size()) {
+        for (auto s : leafOf[id]) {
+            terminatedLeaves[s]++;
+        }
+    }
+}
+
+void StreamTopology::leafReset(const uint64_t id) {
+    if (id < leafOf.size()) {
+        for (auto s : leafOf[id]) {
+            terminatedLeaves[s]--;
+        }
+    }
+}
+
+void StreamTopology::recount(const vector<bool>& terminated) {
+    for (uint64_t s = 0; s < size(); ++s) {
+        terminatedLeaves[s] = 0;
+        for (uint64_t i = offsets[s]; i < offsets[s + 1]; ++i) {
+            if (leaves[i] && nodes[i] < terminated.size() &&
+                terminated[nodes[i]]) {
+                terminatedLeaves[s]++;
+            }
+        }
+    }
+}
+
+void StreamTopology::clear() {
+    offsets.assign(1, 0);
+    nodes.clear();
+    leaves.clear();
+    leafCount.clear();
+    terminatedLeaves.clear();
+    rootIndex.clear();
+    leafOf.clear();
+}
+
+} // end of namespace
@@ -0,0 +1,206 @@
+/*
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ *
+ * Copyright (c) 2026 ARM Limited
+ * All rights reserved
+ *  Created on: Oct 18, 2026
+ */
+
+#ifndef __AMBA_TRAFFIC_PROFILE_STREAM_TOPOLOGY_HH__
+#define __AMBA_TRAFFIC_PROFILE_STREAM_TOPOLOGY_HH__
+
+#include <cstdint>
+#include <vector>
+
+using namespace std;
+
+namespace TrafficProfiles {
+
+/*!
+ *\brief Compiled ATP streams topology
+ *
+ * Stores the profiles belonging to each stream in compressed
+ * sparse row (CSR) format: the nodes of all streams are laid out
+ * contiguously, and each stream is identified by an offset in
+ * the nodes array. Nodes which are stream leaves are flagged in
+ * a bitset parallel to the nodes array.
+ *
+ * Each stream keeps a counter of its terminated leaves, updated
+ * when leaf profiles terminate or are reset, so that testing a
+ * stream for termination does not require visiting its leaves.
+ *
+ * Streams are append-only: they are compiled once from the
+ * profiles dependency graph, and cloned streams are appended
+ * at the end of the arrays.
+ */
+class StreamTopology {
+
+public:
+
+    /*!
+     *\brief Read-only view of a compiled stream
+     */
+    class Stream {
+    protected:
+        //! the topology the stream belongs to
+        const StreamTopology* topology;
+        //! offset of the stream first node
+        uint64_t first;
+        //! number of nodes in the stream
+        uint64_t count;
+
+    public:
+        /*!
+         * Constructor
+         *\param t the topology the stream belongs to
+         *\param f offset of the stream first node
+         *\param c number of nodes in the stream
+         */
+        Stream(const StreamTopology* t, const uint64_t f, const uint64_t c):
+            topology(t), first(f), count(c) {}
+
+        //! returns the number of nodes in the stream
+        inline uint64_t size() const { return count; }
+
+        /*!
+         * Returns a stream node profile ID
+         *\param i node position in the stream
+         *\return the node profile ID
+         */
+        inline uint64_t node(const uint64_t i) const {
+            return topology->nodes[first + i];
+        }
+
+        /*!
+         * Returns whether a stream node is a leaf
+         *\param i node position in the stream
+         *\return true if the node is a leaf
+         */
+        inline bool leaf(const uint64_t i) const {
+            return topology->leaves[first + i];
+        }
+
+        //! returns the stream root profile ID
+        inline uint64_t root() const { return node(0); }
+
+        //! iterators on the stream nodes profile IDs
+        inline const uint64_t* begin() const {
+            return topology->nodes.data() + first;
+        }
+        inline const uint64_t* end() const { return begin() + count; }
+    };
+
+protected:
+
+    //! stream index -> offset of the stream nodes, plus end sentinel
+    vector<uint64_t> offsets;
+
+    //! nodes profile IDs of all streams, stored contiguously
+    vector<uint64_t> nodes;
+
+    //! leaf flags, parallel to nodes
+    vector<bool> leaves;
+
+    //! stream index -> number of leaves
+    vector<uint64_t> leafCount;
+
+    //! stream index -> number of terminated leaves
+    vector<uint64_t> terminatedLeaves;
+
+    //! profile ID -> stream index, for stream roots
+    vector<uint64_t> rootIndex;
+
+    //! profile ID -> indexes of the streams it is a leaf of
+    vector<vector<uint64_t>> leafOf;
+
+    /*!
+     * Returns the index of a stream
+     *\param root stream root profile ID
+     *\return the stream index or InvalidId if not compiled
+     */
+    uint64_t index(const uint64_t) const;
+
+public:
+
+    //! Default constructor
+    StreamTopology();
+
+    //! Default destructor
+    virtual ~StreamTopology() = default;
+
+    /*!
+     * Appends a new stream to the topology
+     *\param ids the stream nodes profile IDs, root first
+     *\param isLeaf the stream nodes leaf flags
+     *\param terminated the number of leaves already terminated
+     */
+    void add(const vector<uint64_t>&, const vector<bool>&,
+             const uint64_t = 0);
+
+    /*!
+     * Appends a clone of a compiled stream to the topology,
+     * the clone shares the stream structure
+     *\param origin the origin stream root profile ID
+     *\param ids the clone nodes profile IDs, in the origin nodes order
+     */
+    void clone(const uint64_t, const vector<uint64_t>&);
+
+    /*!
+     * Returns whether a stream is compiled in the topology
+     *\param root stream root profile ID
+     *\return true if the stream is compiled
+     */
+    bool has(const uint64_t) const;
+
+    /*!
+     * Returns a view on a compiled stream
+     *\param root stream root profile ID
+     *\return a view on the stream nodes
+     */
+    Stream stream(const uint64_t) const;
+
+    /*!
+     * Returns a view on a compiled stream by index
+     *\param i the stream index
+     *\return a view on the stream nodes
+     */
+    Stream at(const uint64_t) const;
+
+    //! returns the number of compiled streams
+    inline uint64_t size() const { return offsets.size() - 1; }
+
+    /*!
+     * Returns whether all leaves of a stream terminated
+     *\param root stream root profile ID
+     *\return true if the stream terminated
+     */
+    bool terminated(const uint64_t) const;
+
+    /*!
+     * Signals the termination of a profile, updating
+     * the counters of the streams it is a leaf of
+     *\param id the terminated profile ID
+     */
+    void leafTerminated(const uint64_t);
+
+    /*!
+     * Signals the reset of a terminated profile, updating
+     * the counters of the streams it is a leaf of
+     *\param id the reset profile ID
+     */
+    void leafReset(const uint64_t);
+
+    /*!
+     * Recounts the terminated leaves of all streams,
+     * e.g. once the profiles states are restored
+     *\param terminated profile ID -> whether the profile terminated
+     */
+    void recount(const vector<bool>&);
+
+    //! Clears all compiled streams
+    void clear();
+};
+
+} // end of namespace
+
+#endif /* __AMBA_TRAFFIC_PROFILE_STREAM_TOPOLOGY_HH__ */
@@ -9,7 +9,11 @@
 // standard library includes
 #include <stdlib.h>
 #include <getopt.h>
+#include <chrono>
 #include <csignal>
+#include <sstream>
+#include <thread>
+#include <vector>
 // cpp unit includes
 #include <cppunit/ui/text/TestRunner.h>
 #include <cppunit/TestSuite.h>
@@ -23,6 +27,9 @@
 // interactive shell
 #include "shell.hh"
 
+// shared memory server
+#include "engine_server.hh"
+
 using namespace TrafficProfiles;
 using namespace std;
 
@@ -42,13 +49,66 @@ void usage() {
             "\t -p (--profiles-as-masters): instantiates one ATP master per ATP FIFO\n",
             "\t -t (--trace) <value>: enables tracing to the specified directory\n"
             "\t -i (--interactive): starts the Engine in interactive shell mode\n"
+            "\t -r (--sweep-rate) <list>: sweeps the masters rates by comma-separated scale factors\n"
+            "\t -B (--sweep-bandwidth) <list>: sweeps comma-separated memory bandwidths\n"
+            "\t -L (--sweep-latency) <list>: sweeps comma-separated memory latencies\n"
+            "\t -j (--jobs) <value>: number of parallel sweep workers\n"
+            "\t -o (--sweep-output) <value>: sweep results path, without extension\n"
+            "\t -P (--perf) <value>: checks the reference workloads, or the given files,\n"
+            "\t\t against a performance baseline JSON file\n"
+            "\t -U (--perf-update): records the performance baseline instead\n"
+            "\t -T (--perf-tolerance) <value>: allowed relative regression (default 0.1)\n"
+            "\t -R (--timeline) <value>: records the engine activity timeline to\n"
+            "\t\t <value>.atptl and converts it to <value>.json (Chrome trace)\n"
+            "\t -C (--timeline-convert) <value>: converts a recorded timeline to\n"
+            "\t\t Chrome trace JSON and exits\n"
+            "\t -F (--fast-forward): advances periodic deterministic regimes\n"
+            "\t\t in bulk, with identical results\n"
+            "\t -M (--sample) <list>: statistical sampling, as window,interval[,warming]\n"
+            "\t\t measures detailed windows and extrapolates the skipped intervals\n"
+            "\t -E (--estimate): estimates the masters bandwidth and latency\n"
+            "\t\t analytically, for each sweep point, without running\n"
+            "\t -S (--snapshot) <value>: saves an engine snapshot to the file\n"
+            "\t -A (--snapshot-at) <value>: time to save the snapshot at (default end)\n"
+            "\t -W (--warm-start) <value>: restores an engine snapshot from the file\n"
+            "\t\t before running, with the configuration it was saved from\n"
+            "\t -w (--what-if) <value>: warms up once to the given time, then runs\n"
+            "\t\t the sweep grid points in forked children from the warmed state\n"
+            "\t -X (--what-if-stream) <list>: comma-separated what-if stream\n"
+            "\t\t reconfigurations, as root:base:range\n"
+            "\t -s (--server) <value>: serves the loaded engines to local clients\n"
+            "\t\t over shared memory channels /<value>.<index>, until interrupted\n"
+            "\t -n (--server-engines) <value>: number of served engines (default 1)\n"
             "\t -? or -h (--help): Prints usage and exits\n\n",
             "No file arguments: runs self-tests\n");
 }
 
+/*
+ * Splits a comma-separated list
+ */
+vector<string> splitList(const string& s) {
+    vector<string> ret;
+    stringstream ss(s);
+    string item;
+    while (getline(ss, item, ',')) {
+        Utilities::trimOuter(item);
+        if (!item.empty()) {
+            ret.push_back(item);
+        }
+    }
+    return ret;
+}
+
 // instantiate test suite
 TestAtp test;
 
+// set when the engine server is interrupted
+volatile sig_atomic_t serverInterrupted = 0;
+
+void serverSignalHandler(int signum) {
+    serverInterrupted = 1;
+}
+
 void signalHandler( int signum ) {
    PRINT("Interrupt signal (",signum,") received");
 
@@ -70,6 +130,7 @@ int main(int argc, char* argv[]) {
     const string defaultBandwidth = "32GB/s";
     const string defaultLatency = "80ns";
     const string defaultTraceDir = "out";
+    const string defaultSweepOutput = "sweep";
     // option flags and index counters
     int opt = 0, option_index = 0;
     int verbose_flag=0, trace_flag=0,
@@ -86,6 +147,26 @@ int main(int argc, char* argv[]) {
             {"latency",     required_argument, 0, 'l'},
             {"bandwidth",   required_argument, 0, 'b'},
             {"trace",       optional_argument, &trace_flag, 1},
+            {"sweep-rate",  required_argument, 0, 'r'},
+            {"sweep-bandwidth", required_argument, 0, 'B'},
+            {"sweep-latency", required_argument, 0, 'L'},
+            {"jobs",        required_argument, 0, 'j'},
+            {"sweep-output", required_argument, 0, 'o'},
+            {"perf",        required_argument, 0, 'P'},
+            {"perf-update", no_argument, 0, 'U'},
+            {"perf-tolerance", required_argument, 0, 'T'},
+            {"timeline",    required_argument, 0, 'R'},
+            {"timeline-convert", required_argument, 0, 'C'},
+            {"fast-forward", no_argument, 0, 'F'},
+            {"sample",      required_argument, 0, 'M'},
+            {"estimate",    no_argument, 0, 'E'},
+            {"snapshot",    required_argument, 0, 'S'},
+            {"snapshot-at", required_argument, 0, 'A'},
+            {"warm-start",  required_argument, 0, 'W'},
+            {"what-if",     required_argument, 0, 'w'},
+            {"what-if-stream", required_argument, 0, 'X'},
+            {"server",      required_argument, 0, 's'},
+            {"server-engines", required_argument, 0, 'n'},
             {0, 0, 0, 0}
     };
 
@@ -94,9 +175,24 @@ int main(int argc, char* argv[]) {
     string bandwidth(defaultBandwidth);
     string latency(defaultLatency);
     string traceDir(defaultTraceDir);
+    string sweepOutput(defaultSweepOutput);
+    vector<string> sweepRates, sweepBandwidths, sweepLatencies;
+    uint64_t jobs = 1;
+    string perfBaseline;
+    bool perfUpdate = false;
+    double perfTolerance = 0.1;
+    string timeline, timelineConvert;
+    bool fastForward = false;
+    vector<string> sampling;
+    bool estimate = false;
+    string snapshot, snapshotAt, warmStart;
+    string whatIf;
+    vector<string> whatIfStreams;
+    string server;
+    uint64_t serverEngines = 1;
 
     // parse options
-    while ((opt = getopt_long(argc,argv,":ivpb:l:t:?h",
+    while ((opt = getopt_long(argc,argv,":ivpb:l:t:r:B:L:j:o:P:UT:R:C:FM:ES:A:W:w:X:s:n:?h",
             long_options, &option_index)) != EOF) {
         switch(opt)
         {
@@ -127,6 +223,86 @@ int main(int argc, char* argv[]) {
             latency = optarg;
             break;
         }
+        case 'r': {
+            sweepRates = splitList(optarg);
+            break;
+        }
+        case 'B': {
+            sweepBandwidths = splitList(optarg);
+            break;
+        }
+        case 'L': {
+            sweepLatencies = splitList(optarg);
+            break;
+        }
+        case 'j': {
+            jobs = strtoull(optarg, nullptr, 10);
+            break;
+        }
+        case 'o': {
+            sweepOutput = optarg;
+            break;
+        }
+        case 'P': {
+            perfBaseline = optarg;
+            break;
+        }
+        case 'U': {
+            perfUpdate = true;
+            break;
+        }
+        case 'T': {
+            perfTolerance = strtod(optarg, nullptr);
+            break;
+        }
+        case 'R': {
+            timeline = optarg;
+            break;
+        }
+        case 'C': {
+            timelineConvert = optarg;
+            break;
+        }
+        case 'F': {
+            fastForward = true;
+            break;
+        }
+        case 'M': {
+            sampling = splitList(optarg);
+            break;
+        }
+        case 'E': {
+            estimate = true;
+            break;
+        }
+        case 'S': {
+            snapshot = optarg;
+            break;
+        }
+        case 'A': {
+            snapshotAt = optarg;
+            break;
+        }
+        case 'W': {
+            warmStart = optarg;
+            break;
+        }
+        case 'w': {
+            whatIf = optarg;
+            break;
+        }
+        case 'X': {
+            whatIfStreams = splitList(optarg);
+            break;
+        }
+        case 's': {
+            server = optarg;
+            break;
+        }
+        case 'n': {
+            serverEngines = strtoull(optarg, nullptr, 10);
+            break;
+        }
         case 't': {
             trace_flag = 1;
             if (optarg){
@@ -152,8 +328,50 @@ int main(int argc, char* argv[]) {
         LOG("ATP Engine: Debug logging enabled from command line");
     }
 
+    if (!timelineConvert.empty()) {
+        const string json =
+                timelineConvert.substr(0, timelineConvert.rfind('.')) + ".json";
+        if (!TimelineRecorder::toChromeTrace(timelineConvert, json)) {
+            return 1;
+        }
+        PRINT("ATP Engine: timeline converted to", json);
+        return 0;
+    }
+
     // interactive mode bypasses self-tests and profiles loading
 
+    if (!perfBaseline.empty()) {
+        // performance gate on the reference workloads by default
+        vector<string> files { "configs/stream.atp",
+                               "configs/cpu_memcpy.atp",
+                               "configs/cpu_pointer_chase.atp",
+                               "configs/gui_examples/gpu.atp",
+                               "configs/gui_examples/dpu.atp" };
+        if (optind < argc) {
+            files.assign(argv + optind, argv + argc);
+        }
+        return (test.perfGate(files, bandwidth, latency, perfBaseline,
+                              perfTolerance, perfUpdate) ? 0 : 1);
+    }
+
+    if (!server.empty()) {
+        // configuration files are parsed once for all the engines
+        EngineServer engineServer(server, serverEngines);
+        for (int i = optind; i < argc; ++i) {
+            if (!engineServer.load(argv[i])) {
+                ERROR("ATP Engine: unable to load file", argv[i]);
+            }
+        }
+        signal(SIGINT, serverSignalHandler);
+        signal(SIGTERM, serverSignalHandler);
+        engineServer.start();
+        while (!serverInterrupted) {
+            this_thread::sleep_for(chrono::milliseconds(100));
+        }
+        engineServer.stop();
+        return 0;
+    }
+
     if (interactive_flag) {
         Shell::get()->setTest(&test);
         Shell::get()->loop();
@@ -176,6 +394,23 @@ int main(int argc, char* argv[]) {
             test.getTpm()->enableProfilesAsMasters();
         }
 
+        const bool sweeping = !sweepRates.empty() ||
+                              !sweepBandwidths.empty() ||
+                              !sweepLatencies.empty() || !whatIf.empty();
+
+        // handle timeline option - sweep workers would share the file
+        if (!timeline.empty() && sweeping) {
+            WARN("ATP Engine: timeline recording is not supported "
+                 "in sweep mode");
+            timeline.clear();
+        }
+        if (!timeline.empty()) {
+            test.getTpm()->enableTimeline(timeline + ".atptl");
+        }
+        if (fastForward) {
+            test.getTpm()->enableFastForward();
+        }
+
         for (int i = optind; i < argc; ++i)
         {
             if (test.buildManager_fromFile(argv[i])) {
@@ -185,8 +420,75 @@ int main(int argc, char* argv[]) {
             }
         }
 
-        // start the test
-        test.testAgainstInternalSlave(bandwidth, latency);
+        if (sweeping && (!snapshot.empty() || !warmStart.empty())) {
+            WARN("ATP Engine: snapshots are not supported in sweep mode");
+            snapshot.clear();
+            warmStart.clear();
+        }
+
+        if (!sampling.empty() && (sweeping || !snapshot.empty() ||
+                                  !warmStart.empty())) {
+            WARN("ATP Engine: sampling is not supported in sweep "
+                 "or snapshot mode");
+            sampling.clear();
+        }
+        if (!sampling.empty() && sampling.size() < 2) {
+            ERROR("ATP Engine: sampling requires a window and an interval");
+        }
+
+        if (!whatIfStreams.empty() && whatIf.empty()) {
+            WARN("ATP Engine: what-if streams require a warm-up time (-w)");
+        }
+
+        // sweep grid, defaulting to the single point options
+        vector<double> scales;
+        for (auto& r : sweepRates) {
+            scales.push_back(strtod(r.c_str(), nullptr));
+        }
+        if (scales.empty()) {
+            scales.push_back(1);
+        }
+        if (sweepBandwidths.empty()) {
+            sweepBandwidths.push_back(bandwidth);
+        }
+        if (sweepLatencies.empty()) {
+            sweepLatencies.push_back(latency);
+        }
+
+        if (estimate) {
+            // estimate the grid points instead of running them
+            test.estimate(scales, sweepBandwidths, sweepLatencies);
+        } else if (sweeping) {
+            if (whatIf.empty()) {
+                test.sweep(scales, sweepBandwidths, sweepLatencies,
+                           jobs, sweepOutput);
+            } else {
+                test.whatIf(bandwidth, latency, whatIf, scales,
+                            sweepBandwidths, sweepLatencies, whatIfStreams,
+                            jobs, sweepOutput);
+            }
+        } else if (!snapshot.empty() || !warmStart.empty()) {
+            test.testWithSnapshots(bandwidth, latency, warmStart, snapshot,
+                                   snapshotAt);
+        } else if (!sampling.empty()) {
+            test.testWithSampling(bandwidth, latency, sampling[0],
+                                  sampling[1],
+                                  sampling.size() > 2 ? sampling[2] : "");
+        } else {
+            // start the test
+            test.testAgainstInternalSlave(bandwidth, latency);
+        }
+        if (fastForward) {
+            const auto& ff = test.getTpm()->getFastForward();
+            PRINT("ATP Engine: fast-forwarded", ff.getSkippedPeriods(),
+                  "periods in", ff.getSkips(), "skips,",
+                  ff.getSkippedTime(), "ATP time units");
+        }
+        if (!timeline.empty()) {
+            test.getTpm()->disableTimeline();
+            TimelineRecorder::toChromeTrace(timeline + ".atptl",
+                                            timeline + ".json");
+        }
         // cleanup
         test.tearDown();
     }
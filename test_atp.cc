@@ -17,11 +17,27 @@
 #include <sstream>
 #include <algorithm>
 #include <cassert>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <limits>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
 #include "traffic_profile_desc.hh"
+#include "traffic_profile_master.hh"
+#include "traffic_profile_slave.hh"
 #include "packet_tagger.hh"
 #include "utilities.hh"
 #include "kronos.hh"
+#include "stream_topology.hh"
 #include "types.hh"
+#include "convergence_monitor.hh"
+#include "engine_client.hh"
+#include "engine_server.hh"
 
 #ifndef CPPUNIT_ASSERT
 #define CPPUNIT_ASSERT(x)
@@ -31,6 +47,9 @@ using namespace std;
 
 namespace TrafficProfiles {
 
+//! internal ATP Slave profile name
+static const string internalSlave = "TestAtp::InternalSlave::";
+
 TestAtp::TestAtp(): tpm(nullptr), configuration(nullptr) {
 }
 
@@ -132,19 +151,35 @@ void TestAtp::dumpStats() {
         for (auto&m: tpm->getMasters()) {
             PRINT(m,"Stats:",tpm->getMasterStats(m).dump());
         }
+        const double timeScale =
+                tpm->toFrequency(tpm->getTimeResolution());
+        for (auto& r: tpm->getRateControllers()) {
+            PRINT(r.first,"rate control: rate",
+                  Utilities::toByteString(r.second->getRate() * timeScale)
+                  + "ps sustained",
+                  Utilities::toByteString(
+                          r.second->getSustainedRate() * timeScale)
+                  + "ps adjustments",r.second->getAdjustments());
+        }
+        for (auto& q: tpm->getQosEnvelopes()) {
+            const auto& log = q.second->getViolations();
+            PRINT(q.first,"QoS violations:",log.size());
+            for (auto& v: log) {
+                PRINT(q.first,"QoS violation:",
+                      v.dump(q.second->getTimeScale()));
+            }
+        }
     }
 }
 
-void TestAtp::testAgainstInternalSlave(const string& rate,
+void TestAtp::configureInternalSlave(const string& rate,
         const string& latency) {
-    PRINT("ATP Engine running in standalone execution mode. "
-            "Internal slave configuration:",rate,latency);
     // the TPM should already be created and loaded with masters
     // query the TPM for masters and assign all unassigned masters to
     // an internal slave
     Profile slave;
     // fill the configuration
-    makeProfile(&slave, ProfileDescription { "TestAtp::InternalSlave::",
+    makeProfile(&slave, ProfileDescription { internalSlave,
                                              Profile::READ });
     // fill in the slave field
     SlaveConfiguration* slave_cfg = slave.mutable_slave();
@@ -164,6 +199,13 @@ void TestAtp::testAgainstInternalSlave(const string& rate,
     }
     // register (overwrite) slave with TPM
     tpm->configureProfile(slave, make_pair(1,1), true);
+}
+
+void TestAtp::testAgainstInternalSlave(const string& rate,
+        const string& latency) {
+    PRINT("ATP Engine running in standalone execution mode. "
+            "Internal slave configuration:",rate,latency);
+    configureInternalSlave(rate, latency);
 
     // request packets to masters and route to the internal slave
     tpm->loop();
@@ -171,6 +213,570 @@ void TestAtp::testAgainstInternalSlave(const string& rate,
     dumpStats();
 }
 
+void TestAtp::testWithSnapshots(const string& rate, const string& latency,
+        const string& restore, const string& save, const string& at) {
+    PRINT("ATP Engine running in standalone execution mode with snapshots. "
+            "Internal slave configuration:",rate,latency);
+    configureInternalSlave(rate, latency);
+
+    if (!restore.empty()) {
+        ifstream in(restore, ifstream::in | ifstream::binary);
+        stringstream data;
+        data << in.rdbuf();
+        if (!in.is_open() || !tpm->restoreSnapshot(data.str())) {
+            ERROR("TestAtp::testWithSnapshots unable to restore snapshot",
+                  restore);
+        }
+        PRINT("ATP Engine: warm-started from", restore, "at time",
+              tpm->getTime());
+    }
+    if (!save.empty()) {
+        // at the end of the run if no time is given
+        tpm->loopUntil(at.empty() ? numeric_limits<uint64_t>::max() :
+                                    toAtpTime(at));
+        ofstream out(save, ofstream::out | ofstream::binary | ofstream::trunc);
+        const string data = tpm->saveSnapshot();
+        out.write(data.data(), data.size());
+        if (!out) {
+            ERROR("TestAtp::testWithSnapshots unable to write snapshot", save);
+        }
+        PRINT("ATP Engine: saved snapshot", save, "at time", tpm->getTime());
+    }
+    tpm->loop();
+
+    dumpStats();
+}
+
+void TestAtp::testWithSampling(const string& rate, const string& latency,
+        const string& window, const string& interval, const string& warming) {
+    PRINT("ATP Engine running in standalone execution mode with sampling. "
+            "Internal slave configuration:",rate,latency);
+    configureInternalSlave(rate, latency);
+
+    tpm->enableSampling(toAtpTime(window), toAtpTime(interval),
+                        warming.empty() ? 0 : toAtpTime(warming));
+    tpm->loop();
+
+    dumpStats();
+    PRINT("ATP Engine: sampled", tpm->getSampler().dump());
+    if (tpm->getSampler().getWindows() > 0 &&
+        tpm->getSampler().getSkips() == 0) {
+        PRINT("ATP Engine: warning, no sampled window was skipped, the run "
+              "was simulated in detail");
+    }
+}
+
+void TestAtp::estimate(const vector<double>& scales,
+        const vector<string>& rates, const vector<string>& latencies) {
+    const double scale = tpm->getRateScale();
+    for (auto s : scales) {
+        for (auto& rate : rates) {
+            for (auto& latency : latencies) {
+                tpm->setRateScale(s);
+                configureInternalSlave(rate, latency);
+                PRINT("ATP Engine: estimate at rate scale", s,
+                      "internal slave configuration:", rate, latency,
+                      "\n" + AnalyticalModel::dump(tpm->estimate()));
+            }
+        }
+    }
+    tpm->setRateScale(scale);
+}
+
+void TestAtp::runSweepPoint(SweepPoint& point) {
+    // reload the configuration with the point offered load
+    tpm->setRateScale(point.scale);
+    tpm->reset();
+    configureInternalSlave(point.rate, point.latency);
+    tpm->loop();
+    collectSweepPoint(point);
+}
+
+void TestAtp::runWhatIfPoint(SweepPoint& point) {
+    // changes on top of the warmed state
+    tpm->scaleRates(point.scale);
+    for (auto& m : tpm->getMasterSlaves()) {
+        if (m.second.rfind(internalSlave, 0) == 0) {
+            auto* slave = static_cast<TrafficProfileSlave*>(
+                    tpm->getProfile(tpm->profileId(m.second)));
+            slave->setBandwidth(point.rate);
+            slave->setLatency(point.latency);
+        }
+    }
+    if (!point.stream.empty() &&
+        tpm->addressStreamReconfigure(tpm->profileId(point.stream),
+                                      point.base, point.range) == 0) {
+        WARN("TestAtp::runWhatIfPoint unable to reconfigure stream",
+             point.stream);
+    }
+    tpm->loop();
+    collectSweepPoint(point);
+}
+
+void TestAtp::collectSweepPoint(SweepPoint& point) const {
+    // the masters statistics, as the global ones count slaves too
+    const Stats stats = tpm->getMastersStats();
+    point.offered = tpm->getOfferedLoad();
+    point.achieved = stats.receiveRate();
+    point.avgLatency = (stats.received > 0 ? stats.avgLatency() : 0);
+    const double ranks[] = { .5, .9, .99, .999 };
+    for (uint64_t i = 0; i < 4; ++i) {
+        point.percentiles[i] = stats.latencyPercentile(ranks[i]);
+    }
+    point.sent = stats.sent;
+    point.received = stats.received;
+    point.time = stats.getTime();
+    point.done = true;
+}
+
+void TestAtp::sweep(const vector<double>& scales,
+        const vector<string>& rates, const vector<string>& latencies,
+        const uint64_t jobs, const string& out) {
+    // build the grid
+    vector<SweepPoint> points;
+    for (auto scale : scales) {
+        for (auto& rate : rates) {
+            for (auto& latency : latencies) {
+                points.push_back(SweepPoint { scale, rate, latency, "",
+                                              0, 0, 0, 0, 0, { 0, 0, 0, 0 },
+                                              0, 0, 0, false });
+            }
+        }
+    }
+    const uint64_t workers = max<uint64_t>(1, min<uint64_t>(jobs,
+                                                            points.size()));
+    PRINT("ATP Engine running in sweep mode:", points.size(),
+          "points on", workers, "workers");
+    tpm->enableLatencyHistogram();
+
+    if (workers == 1) {
+        for (auto& p : points) {
+            runSweepPoint(p);
+        }
+    } else {
+        // each worker process runs every workers-th point
+        // and streams its results back through a pipe
+        vector<int> fds;
+        vector<pid_t> pids;
+        for (uint64_t w = 0; w < workers; ++w) {
+            int fd[2];
+            if (pipe(fd) != 0) {
+                ERROR("TestAtp::sweep unable to create worker pipe");
+            }
+            const pid_t pid = fork();
+            if (pid < 0) {
+                ERROR("TestAtp::sweep unable to fork worker", w);
+            } else if (pid == 0) {
+                close(fd[0]);
+                for (uint64_t i = w; i < points.size(); i += workers) {
+                    runSweepPoint(points[i]);
+                    const string line = serialiseSweepPoint(i, points[i]);
+                    if (write(fd[1], line.data(), line.size()) < 0) {
+                        _exit(1);
+                    }
+                }
+                close(fd[1]);
+                _exit(0);
+            }
+            close(fd[1]);
+            fds.push_back(fd[0]);
+            pids.push_back(pid);
+        }
+
+        // collect results until all workers close their pipes
+        vector<string> pending(workers);
+        vector<pollfd> polled;
+        for (auto fd : fds) {
+            polled.push_back(pollfd { fd, POLLIN, 0 });
+        }
+        uint64_t running = workers;
+        char buffer[4096];
+        while (running > 0) {
+            if (poll(polled.data(), polled.size(), -1) < 0) {
+                ERROR("TestAtp::sweep unable to poll workers");
+            }
+            for (uint64_t w = 0; w < workers; ++w) {
+                if (polled[w].fd < 0 || polled[w].revents == 0) {
+                    continue;
+                }
+                const ssize_t n = read(polled[w].fd, buffer, sizeof(buffer));
+                if (n <= 0) {
+                    close(polled[w].fd);
+                    polled[w].fd = -1;
+                    --running;
+                    continue;
+                }
+                pending[w].append(buffer, n);
+                size_t end;
+                while ((end = pending[w].find('\n')) != string::npos) {
+                    parseSweepPoint(pending[w].substr(0, end), points);
+                    pending[w].erase(0, end + 1);
+                }
+            }
+        }
+        for (auto pid : pids) {
+            waitpid(pid, nullptr, 0);
+        }
+    }
+
+    writeSweep(points, out);
+}
+
+string TestAtp::serialiseSweepPoint(const uint64_t i, const SweepPoint& p) {
+    stringstream ss;
+    ss.precision(17);
+    ss << i << " " << p.offered << " " << p.achieved << " "
+       << p.avgLatency;
+    for (auto v : p.percentiles) {
+        ss << " " << v;
+    }
+    ss << " " << p.sent << " " << p.received << " " << p.time << "\n";
+    return ss.str();
+}
+
+void TestAtp::parseSweepPoint(const string& line, vector<SweepPoint>& points) {
+    stringstream ss(line);
+    uint64_t i = 0;
+    ss >> i;
+    auto& p = points.at(i);
+    ss >> p.offered >> p.achieved >> p.avgLatency;
+    for (auto& v : p.percentiles) {
+        ss >> v;
+    }
+    ss >> p.sent >> p.received >> p.time;
+    p.done = true;
+}
+
+void TestAtp::writeSweep(const vector<SweepPoint>& points, const string& out) {
+    ofstream csv(out + ".csv"), json(out + ".json");
+    if (!csv.is_open() || !json.is_open()) {
+        ERROR("TestAtp::writeSweep unable to write", out);
+    }
+    // stream columns only for what-if stream reconfigurations
+    const bool streams = any_of(points.begin(), points.end(),
+            [](const SweepPoint& p) { return !p.stream.empty(); });
+    csv.precision(9);
+    json.precision(9);
+    csv << "rate_scale,slave_bandwidth,slave_latency,"
+        << (streams ? "stream,stream_base,stream_range," : "")
+        << "offered_Bps,achieved_Bps,avg_latency_s,p50_latency_s,"
+           "p90_latency_s,p99_latency_s,p999_latency_s,sent,received,"
+           "time_s\n";
+    json << "[\n";
+    for (uint64_t i = 0; i < points.size(); ++i) {
+        const auto& p = points[i];
+        if (!p.done) {
+            WARN("TestAtp::writeSweep point", i, "scale", p.scale,
+                 "bandwidth", p.rate, "latency", p.latency,
+                 "did not complete");
+        }
+        csv << p.scale << ",\"" << p.rate << "\",\"" << p.latency << "\",";
+        if (streams) {
+            csv << "\"" << p.stream << "\"," << p.base << "," << p.range
+                << ",";
+        }
+        csv << p.offered << "," << p.achieved << "," << p.avgLatency;
+        for (auto v : p.percentiles) {
+            csv << "," << v;
+        }
+        csv << "," << p.sent << "," << p.received << "," << p.time << "\n";
+
+        json << "  {\"rate_scale\": " << p.scale
+             << ", \"slave_bandwidth\": \"" << p.rate
+             << "\", \"slave_latency\": \"" << p.latency << "\"";
+        if (streams) {
+            json << ", \"stream\": \"" << p.stream
+                 << "\", \"stream_base\": " << p.base
+                 << ", \"stream_range\": " << p.range;
+        }
+        json << ", \"completed\": " << (p.done ? "true" : "false")
+             << ", \"offered_Bps\": " << p.offered
+             << ", \"achieved_Bps\": " << p.achieved
+             << ", \"avg_latency_s\": " << p.avgLatency
+             << ", \"p50_latency_s\": " << p.percentiles[0]
+             << ", \"p90_latency_s\": " << p.percentiles[1]
+             << ", \"p99_latency_s\": " << p.percentiles[2]
+             << ", \"p999_latency_s\": " << p.percentiles[3]
+             << ", \"sent\": " << p.sent
+             << ", \"received\": " << p.received
+             << ", \"time_s\": " << p.time << "}"
+             << (i + 1 < points.size() ? ",\n" : "\n");
+
+        PRINT("Sweep point", i, "scale", p.scale, "bandwidth", p.rate,
+              "latency", p.latency, "offered",
+              Utilities::toByteString(p.offered) + "ps achieved",
+              Utilities::toByteString(p.achieved) + "ps p99 latency",
+              Utilities::toTimeString(p.percentiles[2]));
+    }
+    json << "]\n";
+    PRINT("Sweep results written to", out + ".csv", "and", out + ".json");
+}
+
+uint64_t TestAtp::toAtpTime(const string& t) const {
+    const double hz = Utilities::timeToHz<double>(t);
+    return (hz > 0 ? (uint64_t)round(TrafficProfileManager::toFrequency(
+                             tpm->getTimeResolution()) / hz) :
+                     strtoull(t.c_str(), nullptr, 10));
+}
+
+void TestAtp::whatIf(const string& rate, const string& latency,
+        const string& at, const vector<double>& scales,
+        const vector<string>& rates, const vector<string>& latencies,
+        const vector<string>& streams, const uint64_t jobs,
+        const string& out) {
+    // stream reconfigurations as root:base:range, none by default
+    vector<SweepPoint> changes;
+    for (auto& s : streams) {
+        const size_t r = s.rfind(':');
+        const size_t b = (r == string::npos || r == 0 ?
+                          string::npos : s.rfind(':', r - 1));
+        if (b == string::npos || b == 0) {
+            ERROR("TestAtp::whatIf invalid stream", s,
+                  "expected root:base:range");
+        }
+        changes.push_back(SweepPoint { 1, "", "", s.substr(0, b),
+                                       strtoull(s.c_str() + b + 1, nullptr, 0),
+                                       strtoull(s.c_str() + r + 1, nullptr, 0),
+                                       0, 0, 0, { 0, 0, 0, 0 }, 0, 0, 0,
+                                       false });
+    }
+    if (changes.empty()) {
+        changes.push_back(SweepPoint { 1, "", "", "", 0, 0, 0, 0, 0,
+                                       { 0, 0, 0, 0 }, 0, 0, 0, false });
+    }
+    // build the grid
+    vector<SweepPoint> points;
+    for (auto scale : scales) {
+        for (auto& r : rates) {
+            for (auto& l : latencies) {
+                for (auto p : changes) {
+                    p.scale = scale;
+                    p.rate = r;
+                    p.latency = l;
+                    points.push_back(p);
+                }
+            }
+        }
+    }
+    const uint64_t workers = max<uint64_t>(1, min<uint64_t>(jobs,
+                                                            points.size()));
+    PRINT("ATP Engine running in what-if mode:", points.size(),
+          "points on", workers, "workers, warm-up to", at);
+    tpm->enableLatencyHistogram();
+
+    // warm up once, children share the warmed pages
+    configureInternalSlave(rate, latency);
+    if (!tpm->loopUntil(toAtpTime(at))) {
+        WARN("TestAtp::whatIf the run completed during warm-up at time",
+             tpm->getTime());
+    }
+
+    // one child per point, at most workers at a time,
+    // each sends its results back through a pipe
+    map<pid_t, pair<int, uint64_t>> running;
+    uint64_t next = 0;
+    while (next < points.size() || !running.empty()) {
+        if (next < points.size() && running.size() < workers) {
+            int fd[2];
+            if (pipe(fd) != 0) {
+                ERROR("TestAtp::whatIf unable to create child pipe");
+            }
+            const pid_t pid = fork();
+            if (pid < 0) {
+                ERROR("TestAtp::whatIf unable to fork child", next);
+            } else if (pid == 0) {
+                close(fd[0]);
+                runWhatIfPoint(points[next]);
+                const string line = serialiseSweepPoint(next, points[next]);
+                const bool ok = (write(fd[1], line.data(), line.size()) > 0);
+                close(fd[1]);
+                _exit(ok ? 0 : 1);
+            }
+            close(fd[1]);
+            running.emplace(pid, make_pair(fd[0], next++));
+            continue;
+        }
+        // results fit in the pipe buffer: read them once the child exits
+        const pid_t pid = waitpid(-1, nullptr, 0);
+        if (pid < 0) {
+            ERROR("TestAtp::whatIf unable to wait for children");
+        }
+        auto c = running.find(pid);
+        if (c == running.end()) {
+            continue;
+        }
+        string line;
+        char buffer[256];
+        ssize_t n;
+        while ((n = read(c->second.first, buffer, sizeof(buffer))) > 0) {
+            line.append(buffer, n);
+        }
+        close(c->second.first);
+        if (!line.empty()) {
+            parseSweepPoint(line, points);
+        }
+        running.erase(c);
+    }
+
+    writeSweep(points, out);
+}
+
+bool TestAtp::runPerfWorkload(PerfResult& result, const string& rate,
+        const string& latency) {
+    int fd[2];
+    if (pipe(fd) != 0) {
+        ERROR("TestAtp::runPerfWorkload unable to create pipe");
+    }
+    const pid_t pid = fork();
+    if (pid < 0) {
+        ERROR("TestAtp::runPerfWorkload unable to fork");
+    } else if (pid == 0) {
+        // the child runs the workload from a fresh TPM, silently
+        close(fd[0]);
+        const int null = ::open("/dev/null", O_WRONLY);
+        if (null >= 0) {
+            dup2(null, STDOUT_FILENO);
+        }
+        tearDown();
+        typedef chrono::duration<double> seconds;
+        const auto start = chrono::steady_clock::now();
+        if (!buildManager_fromFile(result.file)) {
+            _exit(1);
+        }
+        const auto loaded = chrono::steady_clock::now();
+        testAgainstInternalSlave(rate, latency);
+        const auto end = chrono::steady_clock::now();
+
+        stringstream ss;
+        ss.precision(17);
+        ss << seconds(loaded - start).count() << " "
+           << seconds(end - loaded).count() << " "
+           << tpm->getStats().sent << "\n";
+        const string line = ss.str();
+        const bool ok = (write(fd[1], line.data(), line.size()) > 0);
+        close(fd[1]);
+        _exit(ok ? 0 : 1);
+    }
+    close(fd[1]);
+    string line;
+    char buffer[256];
+    ssize_t n;
+    while ((n = read(fd[0], buffer, sizeof(buffer))) > 0) {
+        line.append(buffer, n);
+    }
+    close(fd[0]);
+
+    int status = 0;
+    rusage usage;
+    if (wait4(pid, &status, 0, &usage) < 0 || !WIFEXITED(status) ||
+        WEXITSTATUS(status) != 0 || line.empty()) {
+        return false;
+    }
+    double elapsed = 0;
+    uint64_t packets = 0;
+    stringstream(line) >> result.startup >> elapsed >> packets;
+    result.packetsPerSecond = (elapsed > 0 ? packets / elapsed : 0);
+    // ru_maxrss is reported in kB
+    result.peakRss = usage.ru_maxrss;
+    return true;
+}
+
+bool TestAtp::perfGate(const vector<string>& files, const string& rate,
+        const string& latency, const string& baseline,
+        const double tolerance, const bool update) {
+    // absolute slack below which startup and memory changes are noise
+    const double startupSlack = 0.005, rssSlack = 1024;
+
+    vector<PerfResult> results;
+    bool ok = true;
+    for (auto& f : files) {
+        PerfResult r { f, 0, 0, 0 };
+        if (!runPerfWorkload(r, rate, latency)) {
+            WARN("TestAtp::perfGate workload", f, "failed");
+            ok = false;
+            continue;
+        }
+        PRINT("Perf workload", f, "packets per second", r.packetsPerSecond,
+              "peak RSS", r.peakRss, "kB startup",
+              Utilities::toTimeString(r.startup));
+        results.push_back(r);
+    }
+
+    if (update) {
+        ofstream out(baseline);
+        if (!out.is_open()) {
+            ERROR("TestAtp::perfGate unable to write", baseline);
+        }
+        out.precision(9);
+        out << "{\n  \"workloads\": [\n";
+        for (uint64_t i = 0; i < results.size(); ++i) {
+            const auto& r = results[i];
+            out << "    {\"config\": \"" << r.file
+                << "\", \"packets_per_second\": " << r.packetsPerSecond
+                << ", \"peak_rss_kb\": " << r.peakRss
+                << ", \"startup_s\": " << r.startup << "}"
+                << (i + 1 < results.size() ? ",\n" : "\n");
+        }
+        out << "  ]\n}\n";
+        PRINT("Perf baseline written to", baseline);
+        return ok;
+    }
+
+    // load the baseline: one workload object per line
+    ifstream in(baseline);
+    if (!in.is_open()) {
+        WARN("TestAtp::perfGate unable to read baseline", baseline);
+        return false;
+    }
+    map<string, PerfResult> reference;
+    string line;
+    auto value = [&line](const string& key) {
+        const size_t pos = line.find("\"" + key + "\":");
+        return (pos == string::npos ? 0 :
+                strtod(line.c_str() + pos + key.size() + 3, nullptr));
+    };
+    while (getline(in, line)) {
+        const size_t pos = line.find("\"config\": \"");
+        if (pos == string::npos) {
+            continue;
+        }
+        const size_t begin = pos + 11, end = line.find('"', begin);
+        const string file = line.substr(begin, end - begin);
+        reference[file] = PerfResult { file, value("packets_per_second"),
+                                       value("peak_rss_kb"),
+                                       value("startup_s") };
+    }
+
+    auto check = [&](const string& file, const string& metric,
+                     const double base, const double current,
+                     const bool regressed) {
+        const double change = (base > 0 ? (current - base) / base * 100 : 0);
+        PRINT("Perf", file, metric, "baseline", base, "current", current,
+              "change", to_string(change) + "%",
+              regressed ? "REGRESSION" : "OK");
+        ok &= !regressed;
+    };
+    for (auto& r : results) {
+        auto it = reference.find(r.file);
+        if (it == reference.end()) {
+            WARN("TestAtp::perfGate no baseline for", r.file);
+            ok = false;
+            continue;
+        }
+        const auto& b = it->second;
+        check(r.file, "packets_per_second", b.packetsPerSecond,
+              r.packetsPerSecond,
+              r.packetsPerSecond < b.packetsPerSecond * (1 - tolerance));
+        check(r.file, "peak_rss_kb", b.peakRss, r.peakRss,
+              r.peakRss > b.peakRss * (1 + tolerance) + rssSlack);
+        check(r.file, "startup_s", b.startup, r.startup,
+              r.startup > b.startup * (1 + tolerance) + startupSlack);
+    }
+    PRINT("Perf gate", ok ? "passed" : "FAILED", "with tolerance",
+          to_string(tolerance * 100) + "%");
+    return ok;
+}
+
 // unit tests
 
 void
@@ -574,6 +1180,26 @@ void TestAtp::testAtp_stats() {
     s2 += s1;
     CPPUNIT_ASSERT(s2.dump() == s3.dump());
 
+    // latency percentiles from the latency histogram
+    Stats s5;
+    CPPUNIT_ASSERT(!s5.hasLatencyHistogram());
+    CPPUNIT_ASSERT(s5.latencyPercentile(.5) == 0);
+    s5.enableLatencyHistogram();
+    // 90 responses with latency 10, 10 with latency 1000
+    for (uint64_t i=0; i < 100; ++i) {
+        s5.receive(i, 64, (i < 90 ? 10 : 1000));
+    }
+    CPPUNIT_ASSERT(s5.latencyPercentile(.5) == 10);
+    CPPUNIT_ASSERT(s5.latencyPercentile(.9) == 10);
+    // buckets above the linear range have about 6% resolution
+    CPPUNIT_ASSERT(fabs(s5.latencyPercentile(.99) - 1000) < 1000 * .07);
+    // merged histograms add up, reset keeps the histogram enabled
+    Stats s6 { s5 + s5 };
+    CPPUNIT_ASSERT(s6.latencyPercentile(.9) == 10);
+    CPPUNIT_ASSERT(s6.latencyPercentile(.91) > 900);
+    s5.reset();
+    CPPUNIT_ASSERT(s5.hasLatencyHistogram());
+    CPPUNIT_ASSERT(s5.latencyPercentile(.5) == 0);
 }
 
 void TestAtp::testAtp_trafficProfile() {
@@ -677,6 +1303,35 @@ void TestAtp::testAtp_trafficProfile() {
     // test packet is now sent
     CPPUNIT_ASSERT(wait->send(locked, p, next));
     CPPUNIT_ASSERT(!locked);
+
+    // a request held back by a full FIFO is left pending on the master,
+    // which resets must release only once
+    Profile held;
+    makeProfile(&held, ProfileDescription { "testAtp_trafficProfile_held",
+                                            Profile::READ });
+    makeFifoConfiguration(held.mutable_fifo(), 64,
+            FifoConfiguration::EMPTY, 0, 4, 10);
+    pk = makePatternConfiguration(held.mutable_pattern(),
+            Command::READ_REQ,
+            Command::READ_RESP);
+    pk->set_size(64);
+    pk->mutable_address()->set_increment(64);
+    tpm->configureProfile(held);
+    TrafficProfileDescriptor* master =
+            tpm->profiles.at(tpm->profileId("testAtp_trafficProfile_held"));
+    Packet* first = nullptr;
+    CPPUNIT_ASSERT(master->send(locked, first, next));
+    CPPUNIT_ASSERT(!master->send(locked, p, next));
+    master->reset();
+    // the master restarts from its first request, not the released one
+    Packet* restarted = nullptr;
+    CPPUNIT_ASSERT(master->send(locked, restarted, next));
+    CPPUNIT_ASSERT(restarted->addr() == first->addr());
+    CPPUNIT_ASSERT(!master->send(locked, p, next));
+    master->reset();
+    master->reset();
+    delete first;
+    delete restarted;
 }
 
 void TestAtp::testAtp_packetTaggerCreation(){
@@ -947,19 +1602,24 @@ TestAtp::testAtp_tpm() {
     TrafficProfileDescriptor *orig { tpm->getProfile(orig_id) };
     uint64_t clone0_id { tpm->uniqueStream(orig_id) };
     TrafficProfileDescriptor *clone0 { tpm->getProfile(clone0_id) };
-    CPPUNIT_ASSERT(tpm->getStreamCache().size() == 1);
+    CPPUNIT_ASSERT(tpm->getStreamTopology().size() == 1);
     CPPUNIT_ASSERT(tpm->getProfileMap().size() == 2);
     CPPUNIT_ASSERT(orig_id == clone0_id); CPPUNIT_ASSERT(orig == clone0);
     /* 2. Non-first usage should create Clone and return its Root Profile ID
           Clone name should be different from Original */
     clone0_id = tpm->uniqueStream(orig_id);
     clone0 = tpm->getProfile(clone0_id);
-    CPPUNIT_ASSERT(tpm->getStreamCache().size() == 2);
+    CPPUNIT_ASSERT(tpm->getStreamTopology().size() == 2);
     CPPUNIT_ASSERT(tpm->getProfileMap().size() == 4);
     CPPUNIT_ASSERT(orig_id != clone0_id); CPPUNIT_ASSERT(orig != clone0);
+    // Clones share the Original configuration and topology
+    CPPUNIT_ASSERT(clone0->getConfig() == orig->getConfig());
+    CPPUNIT_ASSERT(tpm->getStreamTopology().stream(clone0_id).size() ==
+                   tpm->getStreamTopology().stream(orig_id).size());
+    CPPUNIT_ASSERT(tpm->getStreamTopology().stream(clone0_id).leaf(1));
     uint64_t clone1_id = tpm->uniqueStream(orig_id);
     TrafficProfileDescriptor *clone1 { tpm->getProfile(clone1_id) };
-    CPPUNIT_ASSERT(tpm->getStreamCache().size() == 3);
+    CPPUNIT_ASSERT(tpm->getStreamTopology().size() == 3);
     CPPUNIT_ASSERT(tpm->getProfileMap().size() == 6);
     CPPUNIT_ASSERT(orig_id != clone1_id); CPPUNIT_ASSERT(orig != clone1);
     CPPUNIT_ASSERT(clone0_id != clone1_id); CPPUNIT_ASSERT(clone0 != clone1);
@@ -1032,7 +1692,7 @@ TestAtp::testAtp_tpm() {
     reset(); tpm->configureProfile(config_2); tpm->configureProfile(config_3);
     tpm->streamCacheUpdate(); orig_id = tpm->profileId(profile_0);
     tpm->uniqueStream(orig_id); clone0_id = tpm->uniqueStream(orig_id);
-    CPPUNIT_ASSERT(tpm->getStreamCache().size() == 2);
+    CPPUNIT_ASSERT(tpm->getStreamTopology().size() == 2);
     CPPUNIT_ASSERT(tpm->getProfileMap().size() == 8);
     orig = tpm->getProfile(orig_id); clone0 = tpm->getProfile(clone0_id);
     orig->activate(); clone0->activate();
@@ -1053,7 +1713,7 @@ TestAtp::testAtp_tpm() {
     /* 5. Stream Clones in different Masters */
     reset(); orig_id = tpm->profileId(profile_0);
     clone0_id = tpm->uniqueStream(orig_id, tpm->masterId(profile_1));
-    CPPUNIT_ASSERT(tpm->getStreamCache().size() == 2);
+    CPPUNIT_ASSERT(tpm->getStreamTopology().size() == 2);
     CPPUNIT_ASSERT(tpm->getProfileMap().size() == 4);
     clone0 = tpm->getProfile(clone0_id); clone0->activate();
     locked = false ; next = time = 0;
@@ -1061,9 +1721,47 @@ TestAtp::testAtp_tpm() {
         for (auto &packet : tpm->send(locked, next, time)) {
             Packet *p { packet.second };
             CPPUNIT_ASSERT(p->master_id() == profile_1);
+            CPPUNIT_ASSERT(p->master_ref() == tpm->masterId(profile_1));
+            CPPUNIT_ASSERT(tpm->isInternalMaster(p));
             p->set_cmd(Command::READ_RESP); tpm->receive(0, p);
         }
     }
+    /* 6. Clone Streams remap the Original topology to the Clone profiles,
+          Clone checkers are registered to their own Clone profiles only */
+    const string profile_4 = "testAtp_tpm_profile_4";
+    Profile config_4;
+    makeProfile(&config_4, ProfileDescription { profile_4, Profile::READ });
+    makeFifoConfiguration(config_4.mutable_fifo(), 0,
+            FifoConfiguration::EMPTY, 0, 0, 10);
+    config_4.add_check(profile_1);
+    config_4.add_wait_for(profile_0);
+    reset(); tpm->configureProfile(config_4);
+    tpm->streamCacheUpdate(); orig_id = tpm->profileId(profile_0);
+    tpm->uniqueStream(orig_id); clone0_id = tpm->uniqueStream(orig_id);
+    clone1_id = tpm->uniqueStream(orig_id);
+    const auto& topology = tpm->getStreamTopology();
+    const auto origStream = topology.stream(orig_id);
+    CPPUNIT_ASSERT(origStream.size() == 3);
+    auto checkers = [this](const string& name) {
+        return tpm->getProfile(tpm->profileId(name))->checkers;
+    };
+    CPPUNIT_ASSERT(checkers(profile_1) ==
+                   set<uint64_t> { tpm->profileId(profile_4) });
+    for (const uint64_t n : { 0, 1 }) {
+        const string suffix = TrafficProfileDescriptor::Name::CloneSuffix +
+                              to_string(n);
+        const auto clone = topology.stream(n == 0 ? clone0_id : clone1_id);
+        CPPUNIT_ASSERT(clone.size() == origStream.size());
+        for (uint64_t i = 0; i < clone.size(); ++i) {
+            CPPUNIT_ASSERT(clone.node(i) != origStream.node(i));
+            CPPUNIT_ASSERT(tpm->profileName(clone.node(i)) ==
+                           tpm->profileName(origStream.node(i)) + suffix);
+            CPPUNIT_ASSERT(clone.leaf(i) == origStream.leaf(i));
+        }
+        CPPUNIT_ASSERT(checkers(profile_0 + suffix).empty());
+        CPPUNIT_ASSERT(checkers(profile_1 + suffix) ==
+                       set<uint64_t> { tpm->profileId(profile_4 + suffix) });
+    }
 }
 
 void TestAtp::testAtp_trafficProfileDelay() {
@@ -1248,6 +1946,20 @@ void TestAtp::testAtp_kronos() {
     // should be no scheduled events
     CPPUNIT_ASSERT(!k.next());
 
+    // events are kept in time order within a bucket, including
+    // those later than all the events it holds, in the last bucket
+    for (const uint64_t t : { 43, 44, 42 }) {
+        k.schedule(Event(Event::TICK, Event::TRIGGERED, t, t));
+    }
+    CPPUNIT_ASSERT(k.getCounter() == 3);
+    tpm->setTime(44);
+    list<Event> q;
+    k.get(q);
+    CPPUNIT_ASSERT(q.size() == 3);
+    uint64_t expected = 42;
+    for (auto& ev : q) {
+        CPPUNIT_ASSERT(ev.time == expected++);
+    }
 }
 
 
@@ -1424,6 +2136,1321 @@ void TestAtp::testAtp_trafficProfileManagerRouting() {
 
     // start TPM internal routing
     tpm->loop();
+
+    // a slave over its OT limit rejects requests, which are buffered and
+    // routed again on their retry events, releasing their buffer entries
+    tpm->reset();
+    const string retryMaster = master + "_retry";
+    const string retrySlave = slave + "_retry";
+    Profile retryM, retryS;
+    makeProfile(&retryM, ProfileDescription {
+        retryMaster, Profile::READ, &retryMaster });
+    makeFifoConfiguration(retryM.mutable_fifo(), 0,
+            FifoConfiguration::EMPTY, 8, 64, 0);
+    PatternConfiguration* pk =
+            makePatternConfiguration(retryM.mutable_pattern(),
+                    Command::READ_REQ,
+                    Command::READ_RESP);
+    pk->set_size(64);
+    pk->mutable_address()->set_increment(64);
+    makeProfile(&retryS, ProfileDescription {
+        retrySlave, Profile::READ, &retrySlave });
+    SlaveConfiguration* slave_cfg = retryS.mutable_slave();
+    slave_cfg->set_latency("80ns");
+    slave_cfg->set_rate("32GBps");
+    slave_cfg->set_granularity(64);
+    slave_cfg->set_ot_limit(1);
+    slave_cfg->add_master(retryMaster);
+    tpm->configureProfile(retryM);
+    tpm->configureProfile(retryS);
+    tpm->loop();
+    CPPUNIT_ASSERT(tpm->buffer.empty());
+    CPPUNIT_ASSERT(tpm->getProfileStats(retryMaster).received == 64);
+}
+
+void TestAtp::testAtp_lazyProfiles() {
+    const string profile_0 = "testAtp_lazyProfiles_profile_0";
+    const string profile_1 = "testAtp_lazyProfiles_profile_1";
+    const string profile_2 = "testAtp_lazyProfiles_profile_2";
+    const string checker = "testAtp_lazyProfiles_checker";
+    const list<string> wait_0 { profile_0 }, wait_1 { profile_1 };
+
+    // profile 1 waits for profile 0, profile 2 waits for profile 1
+    Profile config_0, config_1, config_2, config_3;
+    makeProfile(&config_0, ProfileDescription { profile_0, Profile::READ });
+    makeFifoConfiguration(config_0.mutable_fifo(), 1000,
+            FifoConfiguration::EMPTY, 1, 2, 10);
+    PatternConfiguration* pk =
+            makePatternConfiguration(config_0.mutable_pattern(),
+                    Command::READ_REQ,
+                    Command::READ_RESP);
+    pk->set_size(32);
+    PatternConfiguration::Address* address = pk->mutable_address();
+    address->set_base(0);
+    address->set_increment(64);
+
+    config_1 = config_0;
+    config_1.set_name(profile_1);
+    config_1.set_master_id(profile_1);
+    config_1.add_wait_for(profile_0);
+
+    config_2 = config_0;
+    config_2.set_name(profile_2);
+    config_2.set_master_id(profile_2);
+    config_2.add_wait_for(profile_1);
+
+    // checker monitoring profile 1
+    makeProfile(&config_3, ProfileDescription { checker, Profile::READ });
+    makeFifoConfiguration(config_3.mutable_fifo(), 1000,
+            FifoConfiguration::EMPTY, 1, 2, 10);
+    config_3.add_check(profile_1);
+
+    for (auto* c : { &config_0, &config_1, &config_2, &config_3 }) {
+        tpm->configureProfile(*c);
+    }
+
+    const uint64_t id_0 = tpm->profileId(profile_0),
+                   id_1 = tpm->profileId(profile_1),
+                   id_2 = tpm->profileId(profile_2);
+
+    // only profiles waiting for other profiles are deferred
+    CPPUNIT_ASSERT(tpm->getDeferredProfiles() == 2);
+    CPPUNIT_ASSERT(tpm->profiles.at(id_0) != nullptr);
+    CPPUNIT_ASSERT(tpm->profiles.at(id_1) == nullptr);
+    CPPUNIT_ASSERT(tpm->profiles.at(id_2) == nullptr);
+    // deferred profiles are known to the TPM
+    CPPUNIT_ASSERT(tpm->getMasters().size() == 4);
+    CPPUNIT_ASSERT(tpm->profileName(id_2) == profile_2);
+    CPPUNIT_ASSERT(!tpm->isTerminated(profile_2));
+    CPPUNIT_ASSERT(tpm->getProfileStats(profile_2).sent == 0);
+    // subscriptions are compiled per source profile and event type
+    const uint64_t id_c = tpm->profileId(checker);
+    CPPUNIT_ASSERT(tpm->subscriptions.at(id_0) == 1);
+    CPPUNIT_ASSERT(tpm->subscriptions.at(id_1) == 2);
+    CPPUNIT_ASSERT((tpm->dispatchTable.at(id_1)[Event::TERMINATION] ==
+                    vector<uint64_t> { id_2, id_c }));
+    CPPUNIT_ASSERT(tpm->dispatchTable.at(id_1)[Event::ACTIVATION].empty());
+
+    bool locked = false;
+    uint64_t next = 0, time = 0;
+    auto play = [&](const string& m) {
+        for (uint64_t i = 0; i < config_0.fifo().total_txn(); ++i) {
+            auto packets = tpm->send(locked, next, time);
+            CPPUNIT_ASSERT(packets.size() == 1);
+            CPPUNIT_ASSERT(packets.begin()->first == m);
+            Packet* p = packets.begin()->second;
+            p->set_cmd(Command::READ_RESP);
+            tpm->receive(time, p);
+        }
+    };
+
+    // profile 0 termination instantiates profile 1 only
+    play(profile_0);
+    CPPUNIT_ASSERT(tpm->isTerminated(profile_0));
+    CPPUNIT_ASSERT(tpm->subscriptions.at(id_0) == 0);
+    CPPUNIT_ASSERT(tpm->getDeferredProfiles() == 1);
+    CPPUNIT_ASSERT(tpm->profiles.at(id_1) != nullptr);
+    CPPUNIT_ASSERT(tpm->profiles.at(id_2) == nullptr);
+    CPPUNIT_ASSERT(!tpm->streamTerminated(id_0));
+
+    play(profile_1);
+    play(profile_2);
+    CPPUNIT_ASSERT(tpm->getDeferredProfiles() == 0);
+    CPPUNIT_ASSERT(tpm->streamTerminated(id_0));
+    // the checker has been registered to the instantiated profile
+    CPPUNIT_ASSERT(tpm->getProfileStats(checker).sent ==
+                   config_1.fifo().total_txn());
+    // checkers consume the observation bus once per tick
+    CPPUNIT_ASSERT(tpm->observations.empty());
+    CPPUNIT_ASSERT(tpm->observers.at(id_1).size() == 1);
+    CPPUNIT_ASSERT(tpm->getProfileStats(checker).received ==
+                   tpm->getProfileStats(profile_1).received);
+    CPPUNIT_ASSERT(tpm->isTerminated(checker));
+    CPPUNIT_ASSERT(tpm->getProfileStats(profile_2).sent ==
+                   config_2.fifo().total_txn());
+
+    // stream reset restores the profiles, which are now instantiated
+    tpm->streamReset(id_0);
+    CPPUNIT_ASSERT(!tpm->streamTerminated(id_0));
+
+    // with lazy profiles disabled, all profiles are instantiated upfront
+    tpm->reset();
+    tpm->disableLazyProfiles();
+    for (auto* c : { &config_0, &config_1, &config_2, &config_3 }) {
+        tpm->configureProfile(*c);
+    }
+    CPPUNIT_ASSERT(tpm->getDeferredProfiles() == 0);
+    CPPUNIT_ASSERT(tpm->profiles.at(tpm->profileId(profile_2)) != nullptr);
+}
+
+void TestAtp::testAtp_streamTopology() {
+    StreamTopology topology;
+    CPPUNIT_ASSERT(topology.size() == 0);
+
+    // diamond stream: 0 -> (1, 2) -> 3, plus a single node stream 4
+    topology.add({ 0, 1, 2, 3 }, { false, false, false, true });
+    topology.add({ 4 }, { true });
+    CPPUNIT_ASSERT(topology.size() == 2);
+    CPPUNIT_ASSERT(topology.has(0) && topology.has(4));
+    CPPUNIT_ASSERT(!topology.has(1) && !topology.has(5));
+
+    // nodes are stored contiguously, root first
+    const auto stream = topology.stream(0);
+    CPPUNIT_ASSERT(stream.size() == 4);
+    CPPUNIT_ASSERT(stream.root() == 0);
+    CPPUNIT_ASSERT(stream.node(3) == 3 && stream.leaf(3));
+    CPPUNIT_ASSERT(!stream.leaf(1));
+    uint64_t expected = 0;
+    for (auto node : stream) {
+        CPPUNIT_ASSERT(node == expected++);
+    }
+    CPPUNIT_ASSERT(topology.at(1).root() == 4);
+
+    // termination counters only track leaves
+    CPPUNIT_ASSERT(!topology.terminated(0));
+    topology.leafTerminated(1);
+    CPPUNIT_ASSERT(!topology.terminated(0));
+    topology.leafTerminated(3);
+    CPPUNIT_ASSERT(topology.terminated(0));
+    CPPUNIT_ASSERT(!topology.terminated(4));
+    topology.leafReset(3);
+    CPPUNIT_ASSERT(!topology.terminated(0));
+
+    // clones share the origin structure, and have independent counters
+    topology.clone(0, { 5, 6, 7, 8 });
+    CPPUNIT_ASSERT(topology.size() == 3);
+    CPPUNIT_ASSERT(topology.stream(5).leaf(3));
+    CPPUNIT_ASSERT(topology.stream(5).node(3) == 8);
+    topology.leafTerminated(8);
+    CPPUNIT_ASSERT(topology.terminated(5));
+    CPPUNIT_ASSERT(!topology.terminated(0));
+
+    // a stream can be compiled after some of its leaves terminated
+    topology.add({ 9, 10 }, { false, true }, 1);
+    CPPUNIT_ASSERT(topology.terminated(9));
+
+    topology.clear();
+    CPPUNIT_ASSERT(topology.size() == 0);
+    CPPUNIT_ASSERT(!topology.has(0));
+}
+
+void TestAtp::testAtp_qosEnvelope() {
+    const string master = "testAtp_qosEnvelope_master";
+    const string checker = "testAtp_qosEnvelope_checker";
+    const string alarm = "testAtp_qosEnvelope_alarm";
+
+    Profile config_0, config_1, config_2;
+    makeProfile(&config_0, ProfileDescription { master, Profile::READ });
+    makeFifoConfiguration(config_0.mutable_fifo(), 1000,
+            FifoConfiguration::EMPTY, 4, 8, 10);
+    PatternConfiguration* pk =
+            makePatternConfiguration(config_0.mutable_pattern(),
+                    Command::READ_REQ,
+                    Command::READ_RESP);
+    pk->set_size(32);
+    PatternConfiguration::Address* address = pk->mutable_address();
+    address->set_base(0);
+    address->set_increment(64);
+
+    // checker enforcing a QoS envelope on the master
+    makeProfile(&config_1, ProfileDescription { checker, Profile::READ });
+    makeFifoConfiguration(config_1.mutable_fifo(), 0,
+            FifoConfiguration::EMPTY, 0, 0, 10);
+    config_1.add_check(master);
+    QosConfiguration* qos = config_1.mutable_qos();
+    qos->set_window("1us");
+    qos->set_min_bandwidth("1 TBps");
+    qos->set_max_latency("100ns");
+    qos->set_max_ot(2);
+    qos->set_emit_event(true);
+
+    // profile activated by the first QoS violation
+    config_2 = config_0;
+    config_2.set_name(alarm);
+    config_2.set_master_id(alarm);
+    config_2.mutable_fifo()->set_total_txn(1);
+    config_2.add_wait_for(checker + " QOS_VIOLATION");
+
+    // the self-profiler counts the events each profile fires
+    tpm->enableEngineProfile();
+    for (auto* c : { &config_0, &config_1, &config_2 }) {
+        tpm->configureProfile(*c);
+    }
+    const uint64_t checkerId = tpm->profileId(checker);
+    auto events = [&]() {
+        const auto* e = tpm->getEngineProfiler().getEntry(checkerId);
+        return (e != nullptr ? e->counters[EngineProfiler::EVENTS] : 0);
+    };
+
+    const auto envelopes = tpm->getQosEnvelopes();
+    CPPUNIT_ASSERT(envelopes.size() == 1);
+    const auto& log = envelopes.at(checker)->getViolations();
+    // evaluation window in ATP time units
+    const uint64_t w = tpm->toFrequency(tpm->getTimeResolution()) / 1000000;
+
+    bool locked = false;
+    uint64_t next = 0;
+    auto respond = [&](multimap<string, Packet*>& packets, const uint64_t t) {
+        for (auto& p : packets) {
+            p.second->set_cmd(Command::READ_RESP);
+            tpm->receive(t, p.second);
+        }
+    };
+
+    // four requests at once exceed the OT envelope
+    auto packets = tpm->send(locked, next, 0);
+    CPPUNIT_ASSERT(packets.count(master) == 4);
+    CPPUNIT_ASSERT(log.size() == 1);
+    CPPUNIT_ASSERT(log[0].type == QosEnvelope::Violation::OT);
+    CPPUNIT_ASSERT(log[0].start == 0);
+    CPPUNIT_ASSERT(log[0].value == 4);
+    const uint64_t fired = events();
+    CPPUNIT_ASSERT(fired > 0);
+
+    // late responses are batched until the end of their tick
+    respond(packets, w / 2);
+    CPPUNIT_ASSERT(tpm->observations.size() == 4);
+    CPPUNIT_ASSERT(log[0].end == 0);
+
+    // they end the OT excursion, then a second burst starts a new one
+    packets = tpm->send(locked, next, w / 2);
+    CPPUNIT_ASSERT(tpm->observations.empty());
+    CPPUNIT_ASSERT(log[0].end == w / 2);
+    CPPUNIT_ASSERT(packets.count(master) == 4);
+    CPPUNIT_ASSERT(log.size() == 2);
+    CPPUNIT_ASSERT(log[1].start == w / 2);
+    // and fires a further violation event, next to the checker FIFO one
+    CPPUNIT_ASSERT(events() == fired + 2);
+
+    // closing the first window records its bandwidth and latency
+    // violations, the following idle windows extend the bandwidth one
+    while (!packets.empty()) {
+        respond(packets, 3 * w);
+        packets = tpm->send(locked, next, 3 * w);
+    }
+    CPPUNIT_ASSERT(log.size() == 4);
+    CPPUNIT_ASSERT(log[2].type == QosEnvelope::Violation::BANDWIDTH);
+    CPPUNIT_ASSERT(log[2].start == 0);
+    CPPUNIT_ASSERT(log[2].end == 3 * w);
+    CPPUNIT_ASSERT(log[2].value == 0);
+    CPPUNIT_ASSERT(log[3].type == QosEnvelope::Violation::LATENCY);
+    CPPUNIT_ASSERT(log[3].start == 0);
+    CPPUNIT_ASSERT(log[3].end == w);
+
+    // the first violation activated the alarm profile
+    CPPUNIT_ASSERT(tpm->getProfileStats(alarm).sent == 1);
+    CPPUNIT_ASSERT(tpm->isTerminated(checker));
+    tpm->disableEngineProfile();
+}
+
+void TestAtp::testAtp_rateControl() {
+    const string master = "testAtp_rateControl_master";
+
+    Profile config;
+    makeProfile(&config, ProfileDescription { master, Profile::READ });
+    FifoConfiguration* fifo =
+            makeFifoConfiguration(config.mutable_fifo(), 1024,
+                    FifoConfiguration::EMPTY, 0, 0, 0);
+    fifo->set_rate("1 GBps");
+    PatternConfiguration* pk =
+            makePatternConfiguration(config.mutable_pattern(),
+                    Command::READ_REQ,
+                    Command::READ_RESP);
+    pk->set_size(64);
+    PatternConfiguration::Address* address = pk->mutable_address();
+    address->set_base(0);
+    address->set_increment(64);
+
+    // AIMD controller bounding the average latency
+    RateControlConfiguration* rc = fifo->mutable_rate_control();
+    rc->set_controller(RateControlConfiguration::AIMD);
+    rc->set_metric(RateControlConfiguration::LATENCY);
+    rc->set_target_latency("100ns");
+    rc->set_period("1us");
+    rc->set_increase("1 GBps");
+    rc->set_decrease(0.5);
+    tpm->configureProfile(config);
+
+    const auto controllers = tpm->getRateControllers();
+    CPPUNIT_ASSERT(controllers.size() == 1);
+    const RateController* ctrl = controllers.at(master);
+    // ATP time units per second and per nanosecond
+    const uint64_t s = tpm->toFrequency(tpm->getTimeResolution());
+    const uint64_t ns = s / 1000000000;
+    const double initial = ctrl->getRate();
+    CPPUNIT_ASSERT(initial * s == 1000000000);
+
+    bool locked = false;
+    uint64_t next = 0;
+    // issues requests every step, each answered after a delay
+    auto run = [&](const uint64_t from, const uint64_t to,
+                   const uint64_t step, const uint64_t delay) {
+        for (uint64_t t = from; t < to; t += step) {
+            auto packets = tpm->send(locked, next, t);
+            for (auto& p : packets) {
+                p.second->set_cmd(Command::READ_RESP);
+                tpm->receive(t + delay, p.second);
+            }
+        }
+    };
+
+    // latency within target: the rate increases additively
+    run(0, 4000 * ns, 10 * ns, 5 * ns);
+    CPPUNIT_ASSERT(ctrl->getAdjustments() >= 2);
+    CPPUNIT_ASSERT(ctrl->getRate() > initial);
+    CPPUNIT_ASSERT(ctrl->getSustainedRate() > 0);
+    const double peak = ctrl->getRate();
+    const uint64_t adjustments = ctrl->getAdjustments();
+
+    // latency above target: the rate decreases multiplicatively
+    run(4000 * ns, 8000 * ns, 600 * ns, 500 * ns);
+    CPPUNIT_ASSERT(ctrl->getAdjustments() > adjustments);
+    CPPUNIT_ASSERT(ctrl->getRate() <= peak * 0.5);
+
+    // a stream reset restores the configured rate
+    tpm->streamReset(tpm->profileId(master));
+    CPPUNIT_ASSERT(ctrl->getRate() == initial);
+    CPPUNIT_ASSERT(ctrl->getAdjustments() == 0);
+}
+
+void TestAtp::testAtp_engineProfiler() {
+    const string master = "testAtp_engineProfiler_master";
+    const uint64_t txn = 100;
+
+    Profile config;
+    makeProfile(&config, ProfileDescription { master, Profile::READ });
+    FifoConfiguration* fifo =
+            makeFifoConfiguration(config.mutable_fifo(), 1024,
+                    FifoConfiguration::EMPTY, 0, txn, 0);
+    fifo->set_rate("4 GBps");
+    PatternConfiguration* pk =
+            makePatternConfiguration(config.mutable_pattern(),
+                    Command::READ_REQ,
+                    Command::READ_RESP);
+    pk->set_size(64);
+    PatternConfiguration::Address* address = pk->mutable_address();
+    address->set_base(0);
+    address->set_increment(64);
+    tpm->configureProfile(config);
+    configureInternalSlave("8 GBps", "100ns");
+
+    using Profiler = EngineProfiler;
+    Profiler& profiler = tpm->getEngineProfiler();
+    // nothing is measured unless enabled
+    CPPUNIT_ASSERT(!profiler.isEnabled());
+    CPPUNIT_ASSERT(tpm->getEngineProfile().total.empty());
+
+    tpm->enableEngineProfile();
+    CPPUNIT_ASSERT(profiler.isEnabled());
+    tpm->loop();
+    CPPUNIT_ASSERT(tpm->getProfileStats(master).received == txn);
+
+    const auto report = tpm->getEngineProfile();
+    CPPUNIT_ASSERT(report.nsPerTick > 0);
+    const auto& total = report.total;
+    for (uint64_t s = 0; s < Profiler::N_SECTIONS; ++s) {
+        CPPUNIT_ASSERT(total.timers[s].calls > 0);
+    }
+    CPPUNIT_ASSERT(total.counters[Profiler::WAKEUPS] > 0);
+    CPPUNIT_ASSERT(total.counters[Profiler::EVENTS] > 0);
+
+    // per profile: the master sends requests and receives responses
+    const auto& m = report.profiles.at(master);
+    CPPUNIT_ASSERT(m.counters[Profiler::PACKETS_SENT] == txn);
+    CPPUNIT_ASSERT(m.counters[Profiler::PACKETS_RECEIVED] == txn);
+    CPPUNIT_ASSERT(m.timers[Profiler::FIFO_UPDATE].calls > 0);
+    // per role: the slave receives requests and sends responses
+    const auto& s = report.roles.at("SLAVE");
+    CPPUNIT_ASSERT(s.counters[Profiler::PACKETS_RECEIVED] == txn);
+    CPPUNIT_ASSERT(s.counters[Profiler::PACKETS_SENT] == txn);
+    CPPUNIT_ASSERT(total.counters[Profiler::PACKETS_SENT] ==
+                   m.counters[Profiler::PACKETS_SENT] +
+                   s.counters[Profiler::PACKETS_SENT]);
+    CPPUNIT_ASSERT(report.roles.at("MASTER").counters[Profiler::PACKETS_SENT]
+                   == txn);
+
+    // disabling retains the measurements and stops recording
+    tpm->disableEngineProfile();
+    const uint64_t wakeups = total.counters[Profiler::WAKEUPS];
+    bool locked = false;
+    uint64_t next = 0;
+    tpm->send(locked, next, tpm->getTime());
+    CPPUNIT_ASSERT(profiler.getTotal().counters[Profiler::WAKEUPS] ==
+                   wakeups);
+    CPPUNIT_ASSERT(!tpm->getEngineProfile().dump().empty());
+
+    profiler.reset();
+    CPPUNIT_ASSERT(tpm->getEngineProfile().total.empty());
+    CPPUNIT_ASSERT(tpm->getEngineProfile().profiles.empty());
+}
+
+void TestAtp::testAtp_timeline() {
+    const string master = "testAtp_timeline_master";
+    const string binary = "testAtp_timeline.atptl";
+    const string json = "testAtp_timeline.json";
+    const uint64_t txn = 20;
+
+    // the timeline records profile activations at configuration time
+    tpm->enableTimeline(binary);
+    CPPUNIT_ASSERT(tpm->getTimeline().isEnabled());
+
+    Profile config;
+    makeProfile(&config, ProfileDescription { master, Profile::READ });
+    FifoConfiguration* fifo =
+            makeFifoConfiguration(config.mutable_fifo(), 256,
+                    FifoConfiguration::EMPTY, 0, txn, 0);
+    fifo->set_rate("4 GBps");
+    PatternConfiguration* pk =
+            makePatternConfiguration(config.mutable_pattern(),
+                    Command::READ_REQ,
+                    Command::READ_RESP);
+    pk->set_size(64);
+    PatternConfiguration::Address* address = pk->mutable_address();
+    address->set_base(0);
+    address->set_increment(64);
+    tpm->configureProfile(config);
+    configureInternalSlave("8 GBps", "100ns");
+    tpm->loop();
+    CPPUNIT_ASSERT(tpm->getProfileStats(master).received == txn);
+
+    tpm->disableTimeline();
+    CPPUNIT_ASSERT(!tpm->getTimeline().isEnabled());
+    const uint64_t recorded = tpm->getTimeline().getRecorded();
+    CPPUNIT_ASSERT(recorded > 0);
+
+    // fixed-size records, followed by the end record and profile names
+    ifstream in(binary, ifstream::binary | ifstream::ate);
+    CPPUNIT_ASSERT(in.is_open());
+    const uint64_t size = in.tellg();
+    CPPUNIT_ASSERT(size > 16 + (recorded + 1) *
+                   sizeof(TimelineRecorder::Record));
+    in.close();
+
+    CPPUNIT_ASSERT(TimelineRecorder::toChromeTrace(binary, json));
+    ifstream trace(json);
+    stringstream ss;
+    ss << trace.rdbuf();
+    const string s = ss.str();
+    CPPUNIT_ASSERT(s.find("\"traceEvents\"") != string::npos);
+    CPPUNIT_ASSERT(s.find("\"name\":\"" + master + "\"") != string::npos);
+    // the master is active until terminated
+    CPPUNIT_ASSERT(s.find("\"name\":\"active\",\"ph\":\"B\"") !=
+                   string::npos);
+    CPPUNIT_ASSERT(s.find("\"name\":\"active\",\"ph\":\"E\"") !=
+                   string::npos);
+    CPPUNIT_ASSERT(s.find("\"name\":\"wakeup\"") != string::npos);
+    CPPUNIT_ASSERT(s.find("\"name\":\"fifo empty\"") != string::npos);
+    CPPUNIT_ASSERT(s.rfind("]}") != string::npos);
+
+    // unterminated or missing recordings are not converted
+    CPPUNIT_ASSERT(!TimelineRecorder::toChromeTrace(json, binary + ".json"));
+    CPPUNIT_ASSERT(!TimelineRecorder::toChromeTrace("", json));
+
+    remove(binary.c_str());
+    remove(json.c_str());
+}
+
+void TestAtp::testAtp_fastForward() {
+    const string master = "testAtp_fastForward_master";
+    const uint64_t txn = 40000;
+
+    // pointer chasing: one outstanding transaction, no FIFO rate
+    Configuration configuration;
+    Profile& config = *configuration.add_profile();
+    makeProfile(&config, ProfileDescription { master, Profile::READ });
+    makeFifoConfiguration(config.mutable_fifo(), 0,
+            FifoConfiguration::EMPTY, 1, txn, 0);
+    PatternConfiguration* pk =
+            makePatternConfiguration(config.mutable_pattern(),
+                    Command::READ_REQ,
+                    Command::READ_RESP);
+    pk->set_size(64);
+    PatternConfiguration::Address* address = pk->mutable_address();
+    address->set_base(0);
+    address->set_increment(64);
+    // configurations are reloaded on reset
+    tpm->configure(configuration);
+    configureInternalSlave("32GB/s", "80ns");
+    CPPUNIT_ASSERT(!tpm->getFastForward().isEnabled());
+    tpm->loop();
+    CPPUNIT_ASSERT(tpm->getFastForward().getSkips() == 0);
+
+    const uint64_t time = tpm->getTime();
+    const string global = tpm->getStats().dump();
+    const string profile = tpm->getProfileStats(master).dump();
+    CPPUNIT_ASSERT(tpm->getProfileStats(master).received == txn);
+
+    // the fast-forwarded run produces identical results
+    tpm->enableFastForward();
+    tpm->reset();
+    configureInternalSlave("32GB/s", "80ns");
+    tpm->loop();
+    const FastForward& ff = tpm->getFastForward();
+    CPPUNIT_ASSERT(ff.getSkips() > 0);
+    CPPUNIT_ASSERT(ff.getSkippedPeriods() > 0);
+    CPPUNIT_ASSERT(ff.getSkippedTime() > 0 && ff.getSkippedTime() < time);
+    CPPUNIT_ASSERT(tpm->getTime() == time);
+    CPPUNIT_ASSERT(tpm->getStats().dump() == global);
+    CPPUNIT_ASSERT(tpm->getProfileStats(master).dump() == profile);
+
+    // fast-forward is suspended while the engine is profiled
+    tpm->enableEngineProfile();
+    tpm->reset();
+    configureInternalSlave("32GB/s", "80ns");
+    tpm->loop();
+    CPPUNIT_ASSERT(ff.getSkips() == 0);
+    CPPUNIT_ASSERT(tpm->getStats().dump() == global);
+    tpm->disableEngineProfile();
+    tpm->disableFastForward();
+
+    // pointer chasing pair: writes issued while reads are locked,
+    // the skips must stop at both masters transactions budgets
+    const string reads = master + "_reads", writes = master + "_writes";
+    const string locked = reads + " PROFILE_LOCKED";
+    const list<string> afterLock { locked };
+    Configuration pair;
+    for (auto& m : { make_pair(reads, Profile::READ),
+                     make_pair(writes, Profile::WRITE) }) {
+        Profile& p = *pair.add_profile();
+        makeProfile(&p, ProfileDescription { m.first, m.second, nullptr,
+                (m.second == Profile::WRITE ? &afterLock : nullptr) });
+        makeFifoConfiguration(p.mutable_fifo(), 0,
+                FifoConfiguration::EMPTY, 1, txn, 0);
+        PatternConfiguration* pattern = makePatternConfiguration(
+                p.mutable_pattern(),
+                (m.second == Profile::READ ? Command::READ_REQ :
+                                             Command::WRITE_REQ),
+                (m.second == Profile::READ ? Command::READ_RESP :
+                                             Command::WRITE_RESP));
+        pattern->set_size(64);
+        pattern->mutable_address()->set_increment(64);
+    }
+    delete tpm;
+    tpm = new TrafficProfileManager();
+    tpm->configure(pair);
+    configureInternalSlave("32GB/s", "80ns");
+    tpm->loop();
+    const uint64_t pairTime = tpm->getTime();
+    const string pairReads = tpm->getProfileStats(reads).dump();
+    const string pairWrites = tpm->getProfileStats(writes).dump();
+    CPPUNIT_ASSERT(tpm->getProfileStats(reads).received == txn);
+    CPPUNIT_ASSERT(tpm->getProfileStats(writes).sent > 0);
+
+    delete tpm;
+    tpm = new TrafficProfileManager();
+    tpm->enableFastForward();
+    tpm->configure(pair);
+    configureInternalSlave("32GB/s", "80ns");
+    tpm->loop();
+    CPPUNIT_ASSERT(tpm->getFastForward().getSkips() > 0);
+    CPPUNIT_ASSERT(tpm->getTime() == pairTime);
+    CPPUNIT_ASSERT(tpm->getProfileStats(reads).dump() == pairReads);
+    CPPUNIT_ASSERT(tpm->getProfileStats(writes).dump() == pairWrites);
+    tpm->disableFastForward();
+}
+
+void TestAtp::testAtp_snapshot() {
+    const string master = "testAtp_snapshot_master";
+    const uint64_t txn = 2000;
+
+    // random addresses exercise the random generator state
+    Configuration configuration;
+    Profile& config = *configuration.add_profile();
+    makeProfile(&config, ProfileDescription { master, Profile::READ });
+    makeFifoConfiguration(config.mutable_fifo(), 0,
+            FifoConfiguration::EMPTY, 4, txn, 0);
+    PatternConfiguration* pk =
+            makePatternConfiguration(config.mutable_pattern(),
+                    Command::READ_REQ,
+                    Command::READ_RESP);
+    pk->set_size(64);
+    RandomDesc* random = pk->mutable_random_address();
+    random->set_type(RandomDesc::UNIFORM);
+    random->mutable_uniform_desc()->set_min(0);
+    random->mutable_uniform_desc()->set_max(1 << 20);
+    // configurations are reloaded on reset
+    tpm->configure(configuration);
+    configureInternalSlave("32GB/s", "80ns");
+
+    // suspend half-way and save the engine state
+    CPPUNIT_ASSERT(tpm->loopUntil(1000000));
+    CPPUNIT_ASSERT(tpm->getTime() <= 1000000);
+    const uint64_t sent = tpm->getProfileStats(master).sent;
+    CPPUNIT_ASSERT(sent > 0 && sent < txn);
+    const string snapshot = tpm->saveSnapshot();
+    CPPUNIT_ASSERT(!snapshot.empty());
+
+    // a suspended loop resumes where it left
+    tpm->loop();
+    const uint64_t time = tpm->getTime();
+    const string global = tpm->getStats().dump();
+    const string profile = tpm->getProfileStats(master).dump();
+    CPPUNIT_ASSERT(tpm->getProfileStats(master).received == txn);
+
+    // the restored engine completes the run identically
+    tpm->reset();
+    configureInternalSlave("32GB/s", "80ns");
+    CPPUNIT_ASSERT(tpm->restoreSnapshot(snapshot));
+    CPPUNIT_ASSERT(tpm->getProfileStats(master).sent == sent);
+    tpm->loop();
+    CPPUNIT_ASSERT(tpm->getTime() == time);
+    CPPUNIT_ASSERT(tpm->getStats().dump() == global);
+    CPPUNIT_ASSERT(tpm->getProfileStats(master).dump() == profile);
+
+    // malformed snapshots are rejected, leaving the engine unchanged
+    const string completed = tpm->saveSnapshot();
+    CPPUNIT_ASSERT(!tpm->restoreSnapshot("garbage"));
+    CPPUNIT_ASSERT(!tpm->restoreSnapshot(
+            snapshot.substr(0, snapshot.size() / 2)));
+    CPPUNIT_ASSERT(tpm->getTime() == time);
+    CPPUNIT_ASSERT(tpm->saveSnapshot() == completed);
+
+    // chain: the second profile is deferred until the first terminates
+    const string first = master + "_first", second = master + "_second";
+    const list<string> afterFirst { first };
+    Configuration chain;
+    for (auto* name : { &first, &second }) {
+        Profile& p = *chain.add_profile();
+        makeProfile(&p, ProfileDescription { *name, Profile::READ, nullptr,
+                (name == &second ? &afterFirst : nullptr) });
+        makeFifoConfiguration(p.mutable_fifo(), 0,
+                FifoConfiguration::EMPTY, 4, txn, 0);
+        PatternConfiguration* pattern = makePatternConfiguration(
+                p.mutable_pattern(), Command::READ_REQ, Command::READ_RESP);
+        pattern->set_size(64);
+        pattern->mutable_address()->set_increment(64);
+    }
+    auto fresh = [this, &chain]() {
+        delete tpm;
+        tpm = new TrafficProfileManager();
+        tpm->configure(chain);
+        configureInternalSlave("32GB/s", "80ns");
+    };
+    fresh();
+    const uint64_t a = tpm->profileId(first), b = tpm->profileId(second);
+    CPPUNIT_ASSERT(tpm->loopUntil(1000000));
+    CPPUNIT_ASSERT(tpm->deferredProfiles.count(b) == 1);
+    const string running = tpm->saveSnapshot();
+    tpm->loop();
+    const uint64_t chainTime = tpm->getTime();
+    CPPUNIT_ASSERT(tpm->streamTerminated(a));
+    const string done = tpm->saveSnapshot();
+
+    // the stream termination counters follow the restored profiles
+    fresh();
+    CPPUNIT_ASSERT(!tpm->streamTerminated(a));
+    CPPUNIT_ASSERT(tpm->restoreSnapshot(done));
+    CPPUNIT_ASSERT(tpm->streamTerminated(a));
+
+    // a failed restore defers again the profiles it instantiated
+    fresh();
+    CPPUNIT_ASSERT(tpm->restoreSnapshot(running));
+    CPPUNIT_ASSERT(!tpm->streamTerminated(a));
+    const string restored = tpm->saveSnapshot();
+    CPPUNIT_ASSERT(!tpm->restoreSnapshot(done.substr(0, done.size() - 1)));
+    CPPUNIT_ASSERT(tpm->deferredProfiles.count(b) == 1);
+    CPPUNIT_ASSERT(tpm->saveSnapshot() == restored);
+    tpm->loop();
+    CPPUNIT_ASSERT(tpm->getTime() == chainTime);
+    CPPUNIT_ASSERT(tpm->streamTerminated(a));
+}
+
+void TestAtp::testAtp_whatIf() {
+    const string master = "testAtp_whatIf_master";
+    const uint64_t txn = 1000;
+
+    Configuration configuration;
+    Profile& config = *configuration.add_profile();
+    makeProfile(&config, ProfileDescription { master, Profile::READ });
+    makeFifoConfiguration(config.mutable_fifo(), 1024,
+            FifoConfiguration::EMPTY, 4, txn, 0);
+    config.mutable_fifo()->set_rate("1GB/s");
+    PatternConfiguration* pk =
+            makePatternConfiguration(config.mutable_pattern(),
+                    Command::READ_REQ,
+                    Command::READ_RESP);
+    pk->set_size(64);
+    PatternConfiguration::Address* address = pk->mutable_address();
+    address->set_base(0);
+    address->set_increment(64);
+    tpm->configure(configuration);
+    configureInternalSlave("32GB/s", "80ns");
+
+    // warm up, then change the offered load and the slave latency
+    CPPUNIT_ASSERT(tpm->loopUntil(10000000));
+    const double offered = tpm->getOfferedLoad();
+    CPPUNIT_ASSERT(offered > 0);
+    tpm->scaleRates(2);
+    CPPUNIT_ASSERT(tpm->getOfferedLoad() == 2 * offered);
+    auto* slave = static_cast<TrafficProfileSlave*>(tpm->getProfile(
+            tpm->profileId(tpm->getMasterSlaves().at(master))));
+    slave->setLatency("200ns");
+    slave->setBandwidth("16GB/s");
+    CPPUNIT_ASSERT(slave->getLatency() == 200000);
+    tpm->loop();
+    CPPUNIT_ASSERT(tpm->getProfileStats(master).received == txn);
+    // responses after the change see the new latency
+    CPPUNIT_ASSERT(tpm->getProfileStats(master).avgLatency() > 80e-9);
+
+    // the scale applies to masters reloaded by reset
+    tpm->reset();
+    CPPUNIT_ASSERT(tpm->getOfferedLoad() == 2 * offered);
+    tpm->setRateScale(1);
+}
+
+void TestAtp::testAtp_concurrentEngines() {
+    const string master = "testAtp_concurrentEngines_master";
+    const string slave = "testAtp_concurrentEngines_slave";
+    const uint64_t engines = 32, txn = 500;
+
+    // runs an engine on the calling thread, with its own logger
+    auto run = [&](const uint64_t i, string& stats, string& error) {
+        Logger logger(nullptr, Logger::ERROR_LEVEL);
+        logger.setThrowOnErrors(true);
+        Logger* previous = Logger::setThreadLogger(&logger);
+
+        // each engine has its own slave latency
+        Configuration configuration;
+        Profile& config = *configuration.add_profile();
+        makeProfile(&config, ProfileDescription { master, Profile::READ });
+        makeFifoConfiguration(config.mutable_fifo(), 0,
+                FifoConfiguration::EMPTY, 4, txn, 0);
+        PatternConfiguration* pk =
+                makePatternConfiguration(config.mutable_pattern(),
+                        Command::READ_REQ,
+                        Command::READ_RESP);
+        pk->set_size(64);
+        PatternConfiguration::Address* address = pk->mutable_address();
+        address->set_base(0);
+        address->set_increment(64);
+        Profile& s = *configuration.add_profile();
+        makeProfile(&s, ProfileDescription { slave, Profile::READ });
+        SlaveConfiguration* slaveCfg = s.mutable_slave();
+        slaveCfg->set_latency(to_string(10 * (i + 1)) + "ns");
+        slaveCfg->set_rate("32GB/s");
+        slaveCfg->set_granularity(64);
+        slaveCfg->set_ot_limit(0);
+        slaveCfg->add_master(master);
+
+        TrafficProfileManager engine;
+        engine.configure(configuration);
+        engine.loop();
+        stats = engine.getProfileStats(master).dump();
+        // errors are reported to the caller instead of exiting
+        try {
+            engine.profileId("unknown");
+        } catch (const EngineError& e) {
+            error = e.what();
+        }
+        Logger::setThreadLogger(previous);
+    };
+
+    vector<string> serial(engines), serialErrors(engines);
+    for (uint64_t i = 0; i < engines; ++i) {
+        run(i, serial[i], serialErrors[i]);
+    }
+    CPPUNIT_ASSERT(serial.front() != serial.back());
+
+    vector<string> concurrent(engines), errors(engines);
+    vector<thread> threads;
+    for (uint64_t i = 0; i < engines; ++i) {
+        threads.emplace_back(run, i, ref(concurrent[i]), ref(errors[i]));
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    for (uint64_t i = 0; i < engines; ++i) {
+        CPPUNIT_ASSERT(concurrent[i] == serial[i]);
+        CPPUNIT_ASSERT(errors[i].find("unknown does not exist") !=
+                       string::npos);
+    }
+    // the process-wide logger is left untouched
+    CPPUNIT_ASSERT(!Logger::get()->getThrowOnErrors());
+}
+
+void TestAtp::testAtp_engineServer() {
+    const string master = "testAtp_engineServer_master";
+    const string server = "atp_test_" + to_string(getpid());
+    const uint64_t engines = 2, txn = 300;
+
+    // masters only, the loopback client acts as their memory
+    Configuration configuration;
+    Profile& config = *configuration.add_profile();
+    makeProfile(&config, ProfileDescription { master, Profile::READ });
+    makeFifoConfiguration(config.mutable_fifo(), 0,
+            FifoConfiguration::EMPTY, 4, txn, 0);
+    PatternConfiguration* pk =
+            makePatternConfiguration(config.mutable_pattern(),
+                    Command::READ_REQ,
+                    Command::READ_RESP);
+    pk->set_size(64);
+    PatternConfiguration::Address* address = pk->mutable_address();
+    address->set_base(0);
+    address->set_increment(64);
+
+    // loopback memory: answers requests after a fixed latency, driving
+    // either a linked TPM or an engine client
+    auto loopback = [](auto& engine, const uint64_t latency) {
+        multimap<uint64_t, Packet*> pending;
+        uint64_t time = 0, next = 0, received = 0;
+        bool locked = false;
+        while (true) {
+            for (auto& p : engine.send(locked, next, time)) {
+                p.second->set_cmd(Command::READ_RESP);
+                pending.emplace(time + latency, p.second);
+            }
+            bool delivered = false;
+            while (!pending.empty() && pending.begin()->first <= time) {
+                Packet* r = pending.begin()->second;
+                pending.erase(pending.begin());
+                if (engine.receive(time, r)) {
+                    ++received;
+                    delivered = true;
+                } else {
+                    delete r;
+                }
+            }
+            // responses may unlock new requests at the same time
+            if (delivered) {
+                continue;
+            }
+            uint64_t t = (next > time ? next : 0);
+            if (!pending.empty() && (t == 0 || pending.begin()->first < t)) {
+                t = pending.begin()->first;
+            }
+            if (t == 0) {
+                break;
+            }
+            time = t;
+        }
+        return make_pair(received, time);
+    };
+
+    EngineServer engineServer(server, engines, 16);
+    engineServer.configure(configuration);
+    engineServer.start();
+
+    // each client drives its engine concurrently, with its own latency
+    vector<pair<uint64_t, uint64_t>> remote(engines);
+    vector<char> attached(engines, false);
+    vector<thread> clients;
+    for (uint64_t i = 0; i < engines; ++i) {
+        clients.emplace_back([&, i] {
+            EngineClient client;
+            attached[i] = client.attach(server, i);
+            if (attached[i]) {
+                remote[i] = loopback(client, 1000 * (i + 1));
+            }
+        });
+    }
+    for (auto& c : clients) {
+        c.join();
+    }
+    // a channel serves one client at a time
+    EngineClient first, second;
+    CPPUNIT_ASSERT(first.attach(server, 0));
+    CPPUNIT_ASSERT(!second.attach(server, 0));
+    first.detach();
+    CPPUNIT_ASSERT(second.attach(server, 0));
+    second.detach();
+    engineServer.stop();
+
+    // hosted engines behave as linked ones
+    for (uint64_t i = 0; i < engines; ++i) {
+        TrafficProfileManager local;
+        local.configure(configuration);
+        const auto expected = loopback(local, 1000 * (i + 1));
+        CPPUNIT_ASSERT(attached[i]);
+        CPPUNIT_ASSERT(expected.first == txn);
+        CPPUNIT_ASSERT(remote[i] == expected);
+        CPPUNIT_ASSERT(engineServer.getEngine(i).getProfileStats(master)
+                       .dump() == local.getProfileStats(master).dump());
+    }
+    CPPUNIT_ASSERT(remote[0].second != remote[1].second);
+}
+
+void TestAtp::testAtp_convergence() {
+    const string master = "testAtp_convergence_master";
+    const uint64_t txn = 1000000;
+
+    // Student-t quantiles, within the approximation accuracy
+    CPPUNIT_ASSERT(fabs(ConvergenceMonitor::studentQuantile(.975, 10)
+                        - 2.228) < .01);
+    CPPUNIT_ASSERT(fabs(ConvergenceMonitor::studentQuantile(.95, 30)
+                        - 1.697) < .01);
+
+    Profile config;
+    makeProfile(&config, ProfileDescription { master, Profile::READ });
+    FifoConfiguration* fifo =
+            makeFifoConfiguration(config.mutable_fifo(), 1024,
+                    FifoConfiguration::EMPTY, 0, txn, 0);
+    fifo->set_rate("4 GBps");
+    PatternConfiguration* pk =
+            makePatternConfiguration(config.mutable_pattern(),
+                    Command::READ_REQ,
+                    Command::READ_RESP);
+    pk->set_size(64);
+    PatternConfiguration::Address* address = pk->mutable_address();
+    address->set_base(0);
+    address->set_increment(64);
+
+    ConvergenceConfiguration* cc = fifo->mutable_convergence();
+    cc->set_window("1us");
+    cc->set_precision(0.01);
+    tpm->configureProfile(config);
+    configureInternalSlave("8 GBps", "100ns");
+
+    // the budget is well beyond what is needed for stable averages
+    tpm->loop();
+    const Stats stats = tpm->getProfileStats(master);
+    CPPUNIT_ASSERT(stats.received > 0);
+    CPPUNIT_ASSERT(stats.received < txn / 100);
+    CPPUNIT_ASSERT(stats.received == stats.sent);
+    CPPUNIT_ASSERT(stats.convergence == Stats::CONVERGED);
+    CPPUNIT_ASSERT(stats.dump().find("converged: yes") != string::npos);
+    const StatObject* exported = stats.xport();
+    CPPUNIT_ASSERT(exported->has_converged() && exported->converged());
+    delete exported;
+    // unmonitored statistics don't report convergence
+    const StatObject* slave = tpm->getProfileStats(internalSlave).xport();
+    CPPUNIT_ASSERT(!slave->has_converged());
+    delete slave;
+
+    // flagging only: the master runs its whole budget
+    delete tpm;
+    tpm = new TrafficProfileManager();
+    fifo->set_total_txn(stats.received * 2);
+    cc->set_terminate(false);
+    tpm->configureProfile(config);
+    configureInternalSlave("8 GBps", "100ns");
+    tpm->loop();
+    const Stats flagged = tpm->getProfileStats(master);
+    CPPUNIT_ASSERT(flagged.received == stats.received * 2);
+    CPPUNIT_ASSERT(flagged.convergence == Stats::CONVERGED);
+}
+
+void TestAtp::testAtp_sampling() {
+    const string master = "testAtp_sampling_master";
+    const uint64_t txn = 100000;
+
+    // random addresses: not periodic, but in a statistical steady state
+    Configuration configuration;
+    Profile& config = *configuration.add_profile();
+    makeProfile(&config, ProfileDescription { master, Profile::READ });
+    makeFifoConfiguration(config.mutable_fifo(), 0,
+            FifoConfiguration::EMPTY, 4, txn, 0);
+    PatternConfiguration* pk =
+            makePatternConfiguration(config.mutable_pattern(),
+                    Command::READ_REQ,
+                    Command::READ_RESP);
+    pk->set_size(64);
+    RandomDesc* random = pk->mutable_random_address();
+    random->set_type(RandomDesc::UNIFORM);
+    random->mutable_uniform_desc()->set_min(0);
+    random->mutable_uniform_desc()->set_max(1 << 20);
+    // configurations are reloaded on reset
+    tpm->configure(configuration);
+    configureInternalSlave("32GB/s", "80ns");
+    tpm->loop();
+    const uint64_t time = tpm->getTime();
+    const Stats detailed = tpm->getProfileStats(master);
+    CPPUNIT_ASSERT(detailed.received == txn);
+
+    // ATP time units per microsecond
+    const uint64_t us =
+            TrafficProfileManager::toFrequency(tpm->getTimeResolution()) /
+            1000000;
+    tpm->enableSampling(us, 10 * us, us / 10);
+    tpm->reset();
+    configureInternalSlave("32GB/s", "80ns");
+    tpm->loop();
+    const Sampler& sampler = tpm->getSampler();
+    CPPUNIT_ASSERT(sampler.getWindows() > 1);
+    CPPUNIT_ASSERT(sampler.getSkips() > 0);
+    CPPUNIT_ASSERT(sampler.getSkippedTime() > time / 2);
+
+    // the extrapolated run completes the same transactions, in about
+    // the same time
+    const Stats sampled = tpm->getProfileStats(master);
+    CPPUNIT_ASSERT(sampled.sent == txn && sampled.received == txn);
+    CPPUNIT_ASSERT(fabs((double)tpm->getTime() - time) < time / 100.);
+    CPPUNIT_ASSERT(fabs(sampled.receiveRate() - detailed.receiveRate()) <
+                   detailed.receiveRate() / 100);
+    // the estimates are within their bounds of the detailed results,
+    // bounded once more than a window is measured
+    CPPUNIT_ASSERT(isfinite(sampler.getBandwidthError()));
+    CPPUNIT_ASSERT(fabs(sampler.getBandwidth() - detailed.receiveRate()) <
+                   max(sampler.getBandwidthError(),
+                       detailed.receiveRate() / 100));
+    CPPUNIT_ASSERT(fabs(sampler.getLatency() - detailed.avgLatency()) <
+                   max(sampler.getLatencyError(),
+                       detailed.avgLatency() / 100));
+    CPPUNIT_ASSERT(sampler.dump().find("+/-") != string::npos);
+
+    // sampling is suspended while the engine is profiled
+    tpm->enableEngineProfile();
+    tpm->reset();
+    configureInternalSlave("32GB/s", "80ns");
+    tpm->loop();
+    CPPUNIT_ASSERT(sampler.getSkips() == 0);
+    CPPUNIT_ASSERT(tpm->getTime() == time);
+    tpm->disableEngineProfile();
+    tpm->disableSampling();
+
+    // pointer chasing pair: writes sequenced by the reads lock events,
+    // windows which dispatch these are simulated in detail
+    const string reads = master + "_reads", writes = master + "_writes";
+    const string locked = reads + " PROFILE_LOCKED";
+    const list<string> afterLock { locked };
+    Configuration pair;
+    for (auto& m : { make_pair(reads, Profile::READ),
+                     make_pair(writes, Profile::WRITE) }) {
+        Profile& p = *pair.add_profile();
+        makeProfile(&p, ProfileDescription { m.first, m.second, nullptr,
+                (m.second == Profile::WRITE ? &afterLock : nullptr) });
+        makeFifoConfiguration(p.mutable_fifo(), 0,
+                FifoConfiguration::EMPTY, 1, txn, 0);
+        PatternConfiguration* pattern = makePatternConfiguration(
+                p.mutable_pattern(),
+                (m.second == Profile::READ ? Command::READ_REQ :
+                                             Command::WRITE_REQ),
+                (m.second == Profile::READ ? Command::READ_RESP :
+                                             Command::WRITE_RESP));
+        pattern->set_size(64);
+        pattern->mutable_address()->set_increment(64);
+    }
+    delete tpm;
+    tpm = new TrafficProfileManager();
+    tpm->configure(pair);
+    configureInternalSlave("32GB/s", "80ns");
+    tpm->loop();
+    const uint64_t pairTime = tpm->getTime();
+    const string pairReads = tpm->getProfileStats(reads).dump();
+    const string pairWrites = tpm->getProfileStats(writes).dump();
+    CPPUNIT_ASSERT(tpm->getProfileStats(reads).received == txn);
+    CPPUNIT_ASSERT(tpm->getProfileStats(writes).sent > 0);
+
+    delete tpm;
+    tpm = new TrafficProfileManager();
+    tpm->enableSampling(us, 100 * us);
+    tpm->configure(pair);
+    configureInternalSlave("32GB/s", "80ns");
+    tpm->loop();
+    CPPUNIT_ASSERT(tpm->getSampler().getWindows() > 1);
+    CPPUNIT_ASSERT(tpm->getSampler().getEventWindows() ==
+                   tpm->getSampler().getWindows());
+    CPPUNIT_ASSERT(tpm->getSampler().getSkips() == 0);
+    CPPUNIT_ASSERT(tpm->getTime() == pairTime);
+    CPPUNIT_ASSERT(tpm->getProfileStats(reads).dump() == pairReads);
+    CPPUNIT_ASSERT(tpm->getProfileStats(writes).dump() == pairWrites);
+    tpm->disableSampling();
+}
+
+void TestAtp::testAtp_estimate() {
+    const string a = "testAtp_estimate_a", b = "testAtp_estimate_b";
+    const string a1 = a + "_1", a2 = a + "_2", b1 = b + "_1";
+    const list<string> afterA1 { a1 };
+
+    Configuration configuration;
+    PatternConfiguration* pattern = nullptr;
+    // master A: OT bound, then rate bound once its first profile completes
+    Profile& pa1 = *configuration.add_profile();
+    makeProfile(&pa1, ProfileDescription { a1, Profile::READ, &a });
+    makeFifoConfiguration(pa1.mutable_fifo(), 2048,
+            FifoConfiguration::EMPTY, 64, 50000, 0)->set_rate("100GBps");
+    pattern = makePatternConfiguration(pa1.mutable_pattern(),
+            Command::READ_REQ, Command::READ_RESP);
+    pattern->set_size(64);
+    pattern->mutable_address()->set_increment(64);
+    Profile& pa2 = *configuration.add_profile();
+    makeProfile(&pa2, ProfileDescription { a2, Profile::READ, &a,
+                                           &afterA1 });
+    makeFifoConfiguration(pa2.mutable_fifo(), 2048,
+            FifoConfiguration::EMPTY, 64, 50000, 0)->set_rate("4GBps");
+    pattern = makePatternConfiguration(pa2.mutable_pattern(),
+            Command::READ_REQ, Command::READ_RESP);
+    pattern->set_size(64);
+    pattern->mutable_address()->set_increment(64);
+    // master B: bound by its own slave OT limit
+    Profile& pb1 = *configuration.add_profile();
+    makeProfile(&pb1, ProfileDescription { b1, Profile::READ, &b });
+    makeFifoConfiguration(pb1.mutable_fifo(), 0,
+            FifoConfiguration::EMPTY, 64, 100000, 0)->set_rate("100GBps");
+    pattern = makePatternConfiguration(pb1.mutable_pattern(),
+            Command::READ_REQ, Command::READ_RESP);
+    pattern->set_size(64);
+    pattern->mutable_address()->set_increment(64);
+    Profile& slave = *configuration.add_profile();
+    makeProfile(&slave, ProfileDescription { "testAtp_estimate_slave",
+                                             Profile::READ });
+    SlaveConfiguration* slaveConf = slave.mutable_slave();
+    slaveConf->set_rate("32GBps");
+    slaveConf->set_latency("80ns");
+    slaveConf->set_ot_limit(16);
+    slaveConf->set_granularity(64);
+    slaveConf->add_master(b);
+
+    tpm->configure(configuration);
+    configureInternalSlave("32GB/s", "80ns");
+    const auto estimates = tpm->estimate();
+    CPPUNIT_ASSERT(estimates.size() == 2);
+    const AnalyticalModel::Estimate& ea = estimates.at(a);
+    const AnalyticalModel::Estimate& eb = estimates.at(b);
+
+    // Little's law: 32 packets in flight for 80ns, then the FIFO rate
+    CPPUNIT_ASSERT(fabs(ea.latency - 80e-9) < 1e-12);
+    CPPUNIT_ASSERT(fabs(ea.finish - (3.2e6 / 25.6e9 + 3.2e6 / 4e9 +
+                                     2 * 80e-9)) < 1e-9);
+    // 64 packets queue at a slave serving 16 in 80ns
+    CPPUNIT_ASSERT(eb.bound == AnalyticalModel::SLAVE);
+    CPPUNIT_ASSERT(fabs(eb.bandwidth - 12.8e9) < 12.8e9 / 100);
+    CPPUNIT_ASSERT(fabs(eb.latency - 320e-9) < 1e-12);
+    CPPUNIT_ASSERT(AnalyticalModel::dump(estimates).find("bound by: slave")
+                   != string::npos);
+
+    // the estimates are close to the simulated results
+    tpm->loop();
+    for (auto& m : { make_pair(a, ea), make_pair(b, eb) }) {
+        const Stats stats = tpm->getMasterStats(m.first);
+        const double finish = (double)stats.time / stats.timeScale;
+        CPPUNIT_ASSERT(fabs(m.second.bandwidth - stats.receiveRate()) <
+                       stats.receiveRate() * 0.02);
+        CPPUNIT_ASSERT(fabs(m.second.latency - stats.avgLatency()) <
+                       stats.avgLatency() * 0.02);
+        CPPUNIT_ASSERT(fabs(m.second.finish - finish) < finish * 0.02);
+    }
+
+    // offered loads scale the FIFO rates only
+    tpm->setRateScale(0.5);
+    const auto scaled = tpm->estimate();
+    tpm->setRateScale(1);
+    CPPUNIT_ASSERT(scaled.at(a).finish > ea.finish + 3.2e6 / 4e9 * 0.99);
+    CPPUNIT_ASSERT(fabs(scaled.at(b).finish - eb.finish) < 1e-12);
+
+    // pointer chasing pair, as configs/cpu_pointer_chase.atp: the writes
+    // alternate with the reads on their lock events, not estimated
+    const string reads = a + "_reads", writes = a + "_writes";
+    const list<string> afterLock { reads + " PROFILE_LOCKED" };
+    Configuration chase;
+    for (auto& m : { make_pair(reads, Profile::READ),
+                     make_pair(writes, Profile::WRITE) }) {
+        Profile& p = *chase.add_profile();
+        makeProfile(&p, ProfileDescription { m.first, m.second, nullptr,
+                (m.second == Profile::WRITE ? &afterLock : nullptr) });
+        makeFifoConfiguration(p.mutable_fifo(), 0,
+                FifoConfiguration::EMPTY, 1, 10000, 0);
+        pattern = makePatternConfiguration(p.mutable_pattern(),
+                (m.second == Profile::READ ? Command::READ_REQ :
+                                             Command::WRITE_REQ),
+                (m.second == Profile::READ ? Command::READ_RESP :
+                                             Command::WRITE_RESP));
+        pattern->set_size(64);
+        pattern->mutable_address()->set_increment(64);
+    }
+    delete tpm;
+    tpm = new TrafficProfileManager();
+    tpm->configure(chase);
+    configureInternalSlave("32GB/s", "80ns");
+    const auto chased = tpm->estimate();
+    CPPUNIT_ASSERT(chased.at(reads).estimated);
+    CPPUNIT_ASSERT(!chased.at(writes).estimated);
+    CPPUNIT_ASSERT(AnalyticalModel::dump(chased).find(writes +
+                   " not estimated") != string::npos);
+    tpm->loop();
+    const Stats chaseStats = tpm->getMasterStats(reads);
+    CPPUNIT_ASSERT(chaseStats.received == 10000);
+    CPPUNIT_ASSERT(fabs(chased.at(reads).latency - chaseStats.avgLatency())
+                   < chaseStats.avgLatency() * 0.02);
+}
+
+void TestAtp::testAtp_burstCoalescing() {
+    const string master = "testAtp_burstCoalescing_master";
+    const uint64_t txn = 10000;
+
+    Profile config;
+    makeProfile(&config, ProfileDescription { master, Profile::READ });
+    FifoConfiguration* fifo = makeFifoConfiguration(config.mutable_fifo(), 0,
+            FifoConfiguration::EMPTY, 32, txn, 0);
+    fifo->set_rate("100GBps");
+    PatternConfiguration* pattern = makePatternConfiguration(
+            config.mutable_pattern(), Command::READ_REQ, Command::READ_RESP);
+    pattern->set_size(64);
+    pattern->mutable_address()->set_increment(64);
+
+    auto run = [&]() {
+        delete tpm;
+        tpm = new TrafficProfileManager();
+        tpm->configureProfile(config);
+        configureInternalSlave("32GB/s", "80ns");
+        tpm->loop();
+        return tpm->getProfileStats(master);
+    };
+    auto maxBurst = [&]() {
+        return static_cast<TrafficProfileMaster*>(tpm->getProfile(
+                tpm->profileId(master)))->getMaxBurst();
+    };
+
+    const Stats single = run();
+    const uint64_t packets = tpm->getStats().received;
+    CPPUNIT_ASSERT(maxBurst() == 0);
+
+    // up to 16 packets per burst, within the OT limit
+    fifo->set_max_burst(1024);
+    const Stats burst = run();
+    CPPUNIT_ASSERT(maxBurst() == 1024);
+    // the master accounts the bursts packet by packet
+    CPPUNIT_ASSERT(burst.sent == txn && burst.received == txn);
+    CPPUNIT_ASSERT(burst.dataReceived == single.dataReceived);
+    CPPUNIT_ASSERT(burst.time == single.time);
+    CPPUNIT_ASSERT(fabs(burst.avgLatency() - single.avgLatency()) < 1e-12);
+    CPPUNIT_ASSERT(burst.avgOt() == single.avgOt());
+    // while the engine moves fewer, larger packets
+    CPPUNIT_ASSERT(tpm->getStats().received * 4 < packets);
+
+    // address range wrap-arounds cut the bursts short
+    pattern->mutable_address()->set_range("640");
+    const Stats wrapped = run();
+    CPPUNIT_ASSERT(wrapped.received == txn);
+    CPPUNIT_ASSERT(wrapped.dataReceived == single.dataReceived);
+
+    // non-contiguous packets are not coalesced
+    pattern->mutable_address()->set_increment(128);
+    const Stats strided = run();
+    CPPUNIT_ASSERT(maxBurst() == 0);
+    CPPUNIT_ASSERT(strided.received == txn);
+}
+
+void TestAtp::testAtp_sweepPoint() {
+    const string master = "testAtp_sweepPoint_master";
+    const uint64_t txn = 1000;
+
+    Configuration configuration;
+    Profile& config = *configuration.add_profile();
+    makeProfile(&config, ProfileDescription { master, Profile::READ });
+    makeFifoConfiguration(config.mutable_fifo(), 0,
+            FifoConfiguration::EMPTY, 4, txn, 0);
+    PatternConfiguration* pattern = makePatternConfiguration(
+            config.mutable_pattern(), Command::READ_REQ, Command::READ_RESP);
+    pattern->set_size(64);
+    pattern->mutable_address()->set_increment(64);
+    tpm->configure(configuration);
+    tpm->enableLatencyHistogram();
+
+    SweepPoint point { 1, "32GB/s", "80ns", "", 0, 0, 0, 0, 0,
+                       { 0, 0, 0, 0 }, 0, 0, 0, false };
+    runSweepPoint(point);
+    CPPUNIT_ASSERT(point.done);
+
+    // the point reports the master results, not the slave ones
+    const Stats stats = tpm->getProfileStats(master);
+    CPPUNIT_ASSERT(stats.received == txn);
+    CPPUNIT_ASSERT(point.sent == txn && point.received == txn);
+    CPPUNIT_ASSERT(point.achieved == stats.receiveRate());
+    CPPUNIT_ASSERT(point.avgLatency == stats.avgLatency());
+    CPPUNIT_ASSERT(fabs(point.avgLatency - 80e-9) < 1e-12);
+    for (auto p : point.percentiles) {
+        CPPUNIT_ASSERT(fabs(p - 80e-9) < 80e-9 / 10);
+    }
 }
 
 CppUnit::TestSuite* TestAtp::suite() {
@@ -1481,6 +3508,70 @@ CppUnit::TestSuite* TestAtp::suite() {
             "Test 12 - Tests the ATP Traffic Profile Manager routing",
             &TestAtp::testAtp_trafficProfileManagerRouting));
 
+    suiteOfTests->addTest(new CppUnit::TestCaller<TestAtp>(
+            "Test 13 - Tests the ATP Traffic Profile Manager lazy profiles",
+            &TestAtp::testAtp_lazyProfiles));
+
+    suiteOfTests->addTest(new CppUnit::TestCaller<TestAtp>(
+            "Test 14 - Tests the ATP Stream Topology",
+            &TestAtp::testAtp_streamTopology));
+
+    suiteOfTests->addTest(new CppUnit::TestCaller<TestAtp>(
+            "Test 15 - Tests the ATP Checker QoS envelope",
+            &TestAtp::testAtp_qosEnvelope));
+
+    suiteOfTests->addTest(new CppUnit::TestCaller<TestAtp>(
+            "Test 16 - Tests the ATP Master closed-loop rate control",
+            &TestAtp::testAtp_rateControl));
+
+    suiteOfTests->addTest(new CppUnit::TestCaller<TestAtp>(
+            "Test 17 - Tests the ATP Engine self-profiler",
+            &TestAtp::testAtp_engineProfiler));
+
+    suiteOfTests->addTest(new CppUnit::TestCaller<TestAtp>(
+            "Test 18 - Tests the ATP Engine activity timeline recorder",
+            &TestAtp::testAtp_timeline));
+
+    suiteOfTests->addTest(new CppUnit::TestCaller<TestAtp>(
+            "Test 19 - Tests the ATP Engine time fast-forward",
+            &TestAtp::testAtp_fastForward));
+
+    suiteOfTests->addTest(new CppUnit::TestCaller<TestAtp>(
+            "Test 20 - Tests the ATP Engine state snapshot and restore",
+            &TestAtp::testAtp_snapshot));
+
+    suiteOfTests->addTest(new CppUnit::TestCaller<TestAtp>(
+            "Test 21 - Tests the ATP Engine runtime what-if changes",
+            &TestAtp::testAtp_whatIf));
+
+    suiteOfTests->addTest(new CppUnit::TestCaller<TestAtp>(
+            "Test 22 - Tests independent ATP Engines running concurrently",
+            &TestAtp::testAtp_concurrentEngines));
+
+    suiteOfTests->addTest(new CppUnit::TestCaller<TestAtp>(
+            "Test 23 - Tests the ATP Engine shared memory server",
+            &TestAtp::testAtp_engineServer));
+
+    suiteOfTests->addTest(new CppUnit::TestCaller<TestAtp>(
+            "Test 24 - Tests the ATP Master steady-state detection",
+            &TestAtp::testAtp_convergence));
+
+    suiteOfTests->addTest(new CppUnit::TestCaller<TestAtp>(
+            "Test 25 - Tests the ATP Engine statistical sampling",
+            &TestAtp::testAtp_sampling));
+
+    suiteOfTests->addTest(new CppUnit::TestCaller<TestAtp>(
+            "Test 26 - Tests the ATP Engine analytical estimates",
+            &TestAtp::testAtp_estimate));
+
+    suiteOfTests->addTest(new CppUnit::TestCaller<TestAtp>(
+            "Test 27 - Tests the ATP Master burst coalescing",
+            &TestAtp::testAtp_burstCoalescing));
+
+    suiteOfTests->addTest(new CppUnit::TestCaller<TestAtp>(
+            "Test 28 - Tests the ATP Engine sweep points results",
+            &TestAtp::testAtp_sweepPoint));
+
     return suiteOfTests;
 }
 
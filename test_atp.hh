@@ -17,6 +17,7 @@
 #include <string>
 #include <list>
 #include <map>
+#include <vector>
 
 // Unit test suit includes
 
@@ -116,6 +117,118 @@ class TestAtp : public CppUnit::TestFixture  {
     void
     makeProfile(Profile *p, const ProfileDescription &desc) const;
 
+    /*!
+     * Assigns all masters not bound to a slave to an internal ATP Slave
+     *\param rate memory bandwidth of the slave
+     *\param latency request to response latency
+     */
+    void configureInternalSlave(const string&, const string&);
+
+    /*!
+     *\brief Sweep grid point
+     *
+     * Configuration and results of a sweep grid point
+     */
+    struct SweepPoint {
+        //! master FIFO rate scale factor
+        double scale;
+        //! slave bandwidth
+        string rate;
+        //! slave latency
+        string latency;
+        //! what-if stream root profile to reconfigure, none if empty
+        string stream;
+        //! what-if stream address base and range
+        uint64_t base, range;
+        //! offered load, bytes per second
+        double offered;
+        //! achieved bandwidth, bytes per second
+        double achieved;
+        //! average latency, seconds
+        double avgLatency;
+        //! latency 50th, 90th, 99th and 99.9th percentiles, seconds
+        double percentiles[4];
+        //! sent and received packets
+        uint64_t sent, received;
+        //! simulated time, seconds
+        double time;
+        //! whether the point completed
+        bool done;
+    };
+
+    /*!
+     * Runs a sweep grid point, filling in its results
+     *\param point the point to run
+     */
+    void runSweepPoint(SweepPoint&);
+
+    /*!
+     * Applies a what-if grid point changes to the warmed engine
+     * and runs it to completion, filling in its results
+     *\param point the point to run
+     */
+    void runWhatIfPoint(SweepPoint&);
+
+    /*!
+     * Fills in a grid point results from the TPM statistics
+     *\param point the point to fill in
+     */
+    void collectSweepPoint(SweepPoint&) const;
+
+    /*!
+     * Serialises a grid point results, for worker processes
+     *\param i the point index
+     *\param point the point
+     *\return a line with the point index and results
+     */
+    static string serialiseSweepPoint(const uint64_t, const SweepPoint&);
+
+    /*!
+     * Parses a grid point results serialised by a worker
+     *\param line the serialised results
+     *\param points the grid points, indexed by the line
+     */
+    static void parseSweepPoint(const string&, vector<SweepPoint>&);
+
+    /*!
+     * Writes the grid results as CSV and JSON
+     *\param points the grid points
+     *\param out output files path, without extension
+     */
+    static void writeSweep(const vector<SweepPoint>&, const string&);
+
+    /*!
+     * Converts a time to ATP time units
+     *\param t the time, e.g. 10us, or ATP time units if no unit is given
+     *\return the time in ATP time units
+     */
+    uint64_t toAtpTime(const string&) const;
+
+    /*!
+     *\brief Performance gate workload
+     *
+     * Metrics measured running an ATP file
+     */
+    struct PerfResult {
+        //! ATP file
+        string file;
+        //! simulated packets per wall-clock second
+        double packetsPerSecond;
+        //! peak resident set size, kB
+        double peakRss;
+        //! time to load the ATP file, seconds
+        double startup;
+    };
+
+    /*!
+     * Runs an ATP file in a child process and measures it
+     *\param result the workload to run, filled in with its metrics
+     *\param rate memory bandwidth of the slave
+     *\param latency request to response latency
+     *\return true if the run completed, false otherwise
+     */
+    bool runPerfWorkload(PerfResult&, const string&, const string&);
+
   public:
 
     //! Builds a TPM loading from file
@@ -129,6 +242,96 @@ class TestAtp : public CppUnit::TestFixture  {
      */
     void testAgainstInternalSlave(const string&, const string&);
 
+    /*!
+     * Runs against the internal ATP Slave, optionally warm-starting
+     * from an engine snapshot and saving one at a given time
+     *\param rate memory bandwidth of the slave
+     *\param latency request to response latency
+     *\param restore snapshot file to warm-start from, if not empty
+     *\param save snapshot file to save to, if not empty
+     *\param at time to save the snapshot at, e.g. 10us, or ATP time units;
+     * at the end of the run if empty
+     */
+    void testWithSnapshots(const string&, const string&, const string&,
+                           const string&, const string&);
+
+    /*!
+     * Runs against the internal ATP Slave in statistical sampling mode,
+     * reporting the extrapolated statistics and the sampled estimates
+     *\param rate memory bandwidth of the slave
+     *\param latency request to response latency
+     *\param window measurement window length, e.g. 1us, or ATP time units
+     *\param interval skipped interval length, e.g. 10us, or ATP time units
+     *\param warming detailed warming length before each window, none if
+     * empty
+     */
+    void testWithSampling(const string&, const string&, const string&,
+                          const string&, const string&);
+
+    /*!
+     * Estimates the masters bandwidth and latency against the internal
+     * ATP Slave through the analytical model, without running, for each
+     * point of a grid of offered loads, slave bandwidths and latencies
+     *\param scales master FIFO rate scale factors
+     *\param rates memory bandwidths of the slave
+     *\param latencies request to response latencies
+     */
+    void estimate(const vector<double>&, const vector<string>&,
+                  const vector<string>&);
+
+    /*!
+     * Sweeps the loaded configuration against the internal ATP Slave
+     * across a grid of offered loads, slave bandwidths and latencies.
+     * Every grid point reuses the loaded configuration via reset,
+     * points are split across parallel worker processes and the
+     * resulting throughput-latency curve is written as CSV and JSON
+     *\param scales master FIFO rate scale factors
+     *\param rates memory bandwidths of the slave
+     *\param latencies request to response latencies
+     *\param jobs number of worker processes
+     *\param out output files path, without extension
+     */
+    void sweep(const vector<double>&, const vector<string>&,
+               const vector<string>&, const uint64_t, const string&);
+
+    /*!
+     * What-if exploration from a shared warmed state: runs the loaded
+     * configuration against the internal ATP Slave up to a warm-up
+     * time once, then forks a copy-on-write child process per grid
+     * point, which applies the point changes to the warmed engine and
+     * runs it to completion. Results are written as in sweep mode
+     *\param rate memory bandwidth of the slave during warm-up
+     *\param latency request to response latency during warm-up
+     *\param at warm-up time, e.g. 10us, or ATP time units
+     *\param scales master FIFO rate scale factors, on the warmed rates
+     *\param rates memory bandwidths of the slave
+     *\param latencies request to response latencies
+     *\param streams stream reconfigurations, as root:base:range,
+     *        none if empty
+     *\param jobs maximum number of concurrent child processes
+     *\param out output files path, without extension
+     */
+    void whatIf(const string&, const string&, const string&,
+                const vector<double>&, const vector<string>&,
+                const vector<string>&, const vector<string>&,
+                const uint64_t, const string&);
+
+    /*!
+     * Performance regression gate: runs each ATP file against the
+     * internal ATP Slave in a separate process, measuring simulated
+     * packets per wall-clock second, peak RSS and startup time, and
+     * compares them against a baseline, or records the baseline
+     *\param files the ATP files to run
+     *\param rate memory bandwidth of the slave
+     *\param latency request to response latency
+     *\param baseline the baseline JSON file
+     *\param tolerance allowed relative regression of each metric
+     *\param update whether to record the baseline instead of checking it
+     *\return true if no metric regressed, false otherwise
+     */
+    bool perfGate(const vector<string>&, const string&, const string&,
+                  const string&, const double, const bool);
+
 
     //! UNIT TESTS
 
@@ -170,6 +373,44 @@ class TestAtp : public CppUnit::TestFixture  {
 
     //! tests the Traffic Profile Manager routing functionality
     void testAtp_trafficProfileManagerRouting();
+
+    //! tests the Traffic Profile Manager lazy profiles instantiation
+    void testAtp_lazyProfiles();
+
+    //! tests the compiled stream topology
+    void testAtp_streamTopology();
+
+    //! tests the ATP Checker QoS envelope
+    void testAtp_qosEnvelope();
+
+    //! tests the ATP Master closed-loop rate control
+    void testAtp_rateControl();
+
+    //! tests the ATP Engine self-profiler
+    void testAtp_engineProfiler();
+
+    //! tests the ATP Engine activity timeline recorder
+    void testAtp_timeline();
+    //! tests the ATP Engine time fast-forward
+    void testAtp_fastForward();
+    //! tests the ATP Engine state snapshot and restore
+    void testAtp_snapshot();
+    //! tests the ATP Engine runtime what-if changes
+    void testAtp_whatIf();
+    //! tests independent ATP Engines running concurrently
+    void testAtp_concurrentEngines();
+    //! tests the ATP Engine shared memory server
+    void testAtp_engineServer();
+    //! tests the ATP Master steady-state detection
+    void testAtp_convergence();
+    //! tests the ATP Engine statistical sampling
+    void testAtp_sampling();
+    //! tests the ATP Engine analytical estimates
+    void testAtp_estimate();
+    //! tests the ATP Master burst coalescing
+    void testAtp_burstCoalescing();
+    //! tests the ATP Engine sweep points results
+    void testAtp_sweepPoint();
 };
 
 } // end of namespace
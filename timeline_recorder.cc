@@ -0,0 +1,218 @@
+/*
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ *
+ * Copyright (c) 2026 ARM Limited
+ * All rights reserved
+ *  Created on: Oct 18, 2026
+ */
+
+#include <array>
+#include <cstring>
+#include <iomanip>
+#include <map>
+#include "timeline_recorder.hh"
+#include "traffic_profile_manager.hh"
+#include "event.hh"
+#include "logger.hh"
+
+namespace TrafficProfiles {
+
+const char TimelineRecorder::magic[8] = { 'A', 'T', 'P', 'T', 'L', '0', '0', '1' };
+
+static_assert(sizeof(TimelineRecorder::Record) == 24,
+              "TimelineRecorder::Record is not packed");
+
+TimelineRecorder::TimelineRecorder(TrafficProfileManager* t):
+        tpm(t), enabled(false), recorded(0) {
+}
+
+TimelineRecorder::~TimelineRecorder() {
+    close();
+}
+
+void TimelineRecorder::open(const string& file) {
+    close();
+    out.open(file, ofstream::out | ofstream::binary | ofstream::trunc);
+    if (!out.is_open()) {
+        ERROR("TimelineRecorder::open failed to open timeline", file);
+    }
+    // the time scale is written when the recording is closed
+    const uint64_t scale = 0;
+    out.write(magic, sizeof(magic));
+    out.write(reinterpret_cast<const char*>(&scale), sizeof(scale));
+    buffer.reserve(bufferSize);
+    recorded = 0;
+    enabled = true;
+    LOG("TimelineRecorder::open recording timeline to", file);
+}
+
+void TimelineRecorder::flush() {
+    out.write(reinterpret_cast<const char*>(buffer.data()),
+              buffer.size() * sizeof(Record));
+    buffer.clear();
+}
+
+void TimelineRecorder::close() {
+    if (!enabled) {
+        return;
+    }
+    enabled = false;
+    const auto& names = tpm->getProfileMap();
+    buffer.push_back(Record { tpm->getTime(), names.size(), 0, END, 0 });
+    flush();
+    for (auto& n : names) {
+        const uint64_t id = n.second, length = n.first.size();
+        out.write(reinterpret_cast<const char*>(&id), sizeof(id));
+        out.write(reinterpret_cast<const char*>(&length), sizeof(length));
+        out.write(n.first.data(), length);
+    }
+    // ATP time units per second
+    const uint64_t scale = tpm->toFrequency(tpm->getTimeResolution());
+    out.seekp(sizeof(magic));
+    out.write(reinterpret_cast<const char*>(&scale), sizeof(scale));
+    out.close();
+    LOG("TimelineRecorder::close recorded", recorded, "records");
+}
+
+string TimelineRecorder::escape(const string& s) {
+    string ret;
+    for (auto c : s) {
+        if (c == '"' || c == '\\') {
+            ret.push_back('\\');
+        }
+        ret.push_back(c);
+    }
+    return ret;
+}
+
+bool TimelineRecorder::toChromeTrace(const string& inFile,
+                                     const string& outFile) {
+    ifstream in(inFile, ifstream::in | ifstream::binary);
+    if (!in.is_open()) {
+        WARN("TimelineRecorder::toChromeTrace unable to open", inFile);
+        return false;
+    }
+    char m[sizeof(magic)];
+    uint64_t scale = 0;
+    in.read(m, sizeof(m));
+    in.read(reinterpret_cast<char*>(&scale), sizeof(scale));
+    if (!in || memcmp(m, magic, sizeof(magic)) != 0 || scale == 0) {
+        WARN("TimelineRecorder::toChromeTrace", inFile,
+             "is not a closed ATP timeline");
+        return false;
+    }
+
+    ofstream json(outFile, ofstream::out | ofstream::trunc);
+    if (!json.is_open()) {
+        WARN("TimelineRecorder::toChromeTrace unable to open", outFile);
+        return false;
+    }
+
+    // profile tracks are offset by one, track 0 is the TPM
+    enum Span { ACTIVE, EMPTY, FULL, LOCKED, N_SPANS };
+    map<uint64_t, array<bool, N_SPANS>> open;
+    const double toUs = 1e6 / scale;
+    json << fixed << setprecision(6);
+    json << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n"
+         << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":0,"
+            "\"args\":{\"name\":\"ATP Engine\"}},\n"
+         << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":0,"
+            "\"args\":{\"name\":\"TPM\"}}";
+
+    auto emit = [&](const char* ph, const string& name, const uint64_t tid,
+                    const uint64_t t, const string& extra) {
+        json << ",\n{\"name\":\"" << name << "\",\"ph\":\"" << ph
+             << "\",\"pid\":0,\"tid\":" << tid << ",\"ts\":" << t * toUs
+             << extra << "}";
+    };
+    // opens or closes a profile interval, skipping unmatched ends
+    auto span = [&](const Span s, const bool begin, const string& name,
+                    const uint64_t tid, const uint64_t t) {
+        bool& state = open[tid][s];
+        if (state == begin) {
+            return;
+        }
+        state = begin;
+        if (s == ACTIVE) {
+            emit(begin ? "B" : "E", name, tid, t, "");
+        } else {
+            // asynchronous intervals may overlap the active one
+            emit(begin ? "b" : "e", name, tid, t,
+                 ",\"cat\":\"" + name + "\",\"id\":" + to_string(tid));
+        }
+    };
+
+    Record r;
+    bool ended = false;
+    while (!ended && in.read(reinterpret_cast<char*>(&r), sizeof(r))) {
+        const uint64_t tid = (uint64_t)r.id + 1;
+        switch (r.kind) {
+        case WAKEUP:
+            emit("i", r.value > 0 ? "wakeup" : "idle wakeup", 0, r.time,
+                 ",\"s\":\"t\",\"args\":{\"packets\":" +
+                 to_string(r.value) + "}");
+            break;
+        case EVENT:
+            switch (r.type) {
+            case Event::ACTIVATION:
+            case Event::TERMINATION:
+                span(ACTIVE, r.type == Event::ACTIVATION, "active",
+                     tid, r.time);
+                break;
+            case Event::FIFO_EMPTY:
+            case Event::FIFO_NOT_EMPTY:
+                span(EMPTY, r.type == Event::FIFO_EMPTY, "fifo empty",
+                     tid, r.time);
+                break;
+            case Event::FIFO_FULL:
+            case Event::FIFO_NOT_FULL:
+                span(FULL, r.type == Event::FIFO_FULL, "fifo full",
+                     tid, r.time);
+                break;
+            case Event::PROFILE_LOCKED:
+            case Event::PROFILE_UNLOCKED:
+                span(LOCKED, r.type == Event::PROFILE_LOCKED, "locked",
+                     tid, r.time);
+                break;
+            default:
+                emit("i", r.type < Event::N_EVENTS ?
+                     Event::text[r.type] : "UNKNOWN", tid, r.time,
+                     ",\"s\":\"t\"");
+                break;
+            }
+            break;
+        case END:
+            ended = true;
+            break;
+        default:
+            WARN("TimelineRecorder::toChromeTrace unknown record kind",
+                 r.kind);
+            return false;
+        }
+    }
+    if (!ended) {
+        WARN("TimelineRecorder::toChromeTrace", inFile, "is truncated");
+        return false;
+    }
+
+    // profile names as track names
+    for (uint64_t i = 0; i < r.value; ++i) {
+        uint64_t id = 0, length = 0;
+        in.read(reinterpret_cast<char*>(&id), sizeof(id));
+        in.read(reinterpret_cast<char*>(&length), sizeof(length));
+        string name(length, '\0');
+        in.read(&name[0], length);
+        if (!in) {
+            WARN("TimelineRecorder::toChromeTrace", inFile,
+                 "has truncated profile names");
+            return false;
+        }
+        json << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,"
+                "\"tid\":" << id + 1 << ",\"args\":{\"name\":\""
+             << escape(name) << "\"}}";
+    }
+    json << "\n]}\n";
+    return true;
+}
+
+} // end of namespace
@@ -0,0 +1,158 @@
+/*
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ *
+ * Copyright (c) 2026 ARM Limited
+ * All rights reserved
+ *  Created on: Oct 18, 2026
+ */
+
+#ifndef __AMBA_TRAFFIC_PROFILE_TIMELINE_RECORDER_HH__
+#define __AMBA_TRAFFIC_PROFILE_TIMELINE_RECORDER_HH__
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+namespace TrafficProfiles {
+
+class TrafficProfileManager;
+
+/*!
+ *\brief ATP Engine activity timeline recorder
+ *
+ * Records the engine activity as compact fixed-size binary records:
+ * the events dispatched by the TPM (profile activation and termination,
+ * FIFO full and empty transitions, profile locked and unlocked
+ * transitions...) and the engine wakeups, with the number of packets
+ * each one produced. Records are buffered and appended to a binary
+ * file, so that recording can be left on for long runs.
+ *
+ * A recorded file is converted to the Chrome trace JSON format, which
+ * is also loaded by the Perfetto UI: each profile is a track, showing
+ * its active, FIFO full, FIFO empty and locked intervals.
+ *
+ * Binary file layout: magic, ATP time units per second, records,
+ * END record holding the number of profile names, then the profile
+ * names as (ID, length, characters).
+ */
+class TimelineRecorder {
+
+public:
+
+    //! Record kinds
+    enum Kind : uint16_t {
+        EVENT,  //!< TPM event dispatch, type holds the Event type
+        WAKEUP, //!< TPM wakeup, value holds the packets sent
+        END     //!< end of records, value holds the number of names
+    };
+
+    //! Binary record
+    struct Record {
+        //! ATP time
+        uint64_t time;
+        //! kind specific value
+        uint64_t value;
+        //! profile ID
+        uint32_t id;
+        //! record kind
+        uint16_t kind;
+        //! kind specific type
+        uint16_t type;
+    };
+
+    //! Binary file magic
+    static const char magic[8];
+
+    //! Records buffered before being written to file
+    static const uint64_t bufferSize = 4096;
+
+protected:
+
+    //! Pointer to the TPM
+    TrafficProfileManager* const tpm;
+
+    //! whether records are being recorded
+    bool enabled;
+
+    //! Binary output file
+    ofstream out;
+
+    //! Records buffer
+    vector<Record> buffer;
+
+    //! number of recorded records
+    uint64_t recorded;
+
+    //! Writes the buffered records to file
+    void flush();
+
+    /*!
+     * Escapes a string for JSON output
+     *\param s the string to be escaped
+     *\return the escaped string
+     */
+    static string escape(const string&);
+
+public:
+
+    /*!
+     * Constructor
+     *\param t pointer to TPM
+     */
+    TimelineRecorder(TrafficProfileManager*);
+
+    //! Default destructor, closes any open recording
+    virtual ~TimelineRecorder();
+
+    /*!
+     * Starts recording to a binary file
+     *\param file the binary file name
+     */
+    void open(const string&);
+
+    /*!
+     * Stops recording, writes the remaining records and
+     * the profile names, and closes the binary file
+     */
+    void close();
+
+    //! returns whether records are being recorded
+    inline bool isEnabled() const { return enabled; }
+
+    //! returns the number of recorded records
+    inline uint64_t getRecorded() const { return recorded; }
+
+    /*!
+     * Records an engine activity if enabled
+     *\param k the record kind
+     *\param id the profile ID
+     *\param t the ATP time
+     *\param type the kind specific type
+     *\param v the kind specific value
+     */
+    inline void record(const Kind k, const uint64_t id, const uint64_t t,
+                       const uint16_t type, const uint64_t v = 0) {
+        if (__builtin_expect(enabled, 0)) {
+            buffer.push_back(Record { t, v, (uint32_t)id, k, type });
+            ++recorded;
+            if (buffer.size() == bufferSize) {
+                flush();
+            }
+        }
+    }
+
+    /*!
+     * Converts a recorded binary file to the Chrome trace JSON format
+     *\param in the binary file name
+     *\param out the JSON file name
+     *\return true if the file was converted, false otherwise
+     */
+    static bool toChromeTrace(const string&, const string&);
+};
+
+} // end of namespace
+
+#endif /* __AMBA_TRAFFIC_PROFILE_TIMELINE_RECORDER_HH__ */
@@ -10,6 +10,8 @@
 #include "traffic_profile_checker.hh"
 #include "traffic_profile_manager.hh"
 #include "utilities.hh"
+#include "fast_forward.hh"
+#include "snapshot.hh"
 
 namespace TrafficProfiles {
 
@@ -26,6 +28,11 @@ TrafficProfileChecker::TrafficProfileChecker(TrafficProfileManager* manager,
                 "] FIFO configuration not found");
     }
 
+    if (p->has_qos()) {
+        // Initialise the QoS envelope
+        envelope.init(this, &p->qos());
+    }
+
     if (p->check_size() > 0) {
         for (int i = 0; i < p->check_size(); ++i) {
             string toCheck { p->check(i) };
@@ -35,6 +42,7 @@ TrafficProfileChecker::TrafficProfileChecker(TrafficProfileManager* manager,
             const uint64_t pid = tpm->getOrGeneratePid(toCheck);
             LOG("TrafficProfileChecker [", this->name,
                     "] registering profile to check: id", pid);
+            checked.push_back(pid);
             // register this checker to wait for termination of the checked
             // master - this will determine its lifetime
             waitEvent(Event::TERMINATION, pid, true);
@@ -63,74 +71,126 @@ void TrafficProfileChecker::reset() {
             "reset requested");
     // reset the FIFO
     fifo.reset();
+    // reset the QoS envelope
+    envelope.reset();
 }
 
-bool TrafficProfileChecker::send(bool& locked, Packet*& p, uint64_t& next) {
+void TrafficProfileChecker::violation() {
+    if (envelope.emitsEvents()) {
+        LOG("TrafficProfileChecker::violation [", this->name,
+                "] firing QoS violation event with id", id);
+        // each excursion fires its own event, QoS events can repeat
+        emitEvent(Event::QOS_VIOLATION);
+    }
+}
+
+bool TrafficProfileChecker::recordSend(bool& locked, uint64_t& next,
+        const uint64_t t, const uint64_t size) {
     // reset next transmission time
     next = 0;
     locked = false;
     bool ok = false;
-    // get current time
-    const uint64_t& t = tpm->getTime();
 
     if (active(locked)) {
         bool underrun = false, overrun = false;
         uint64_t request_time = 0;
 
-        if (nullptr == p) {
-            ERROR("TrafficProfileChecker::send checker [", this->name,
-                    "] requested to record send with empty packet pointer");
-        }
         ot++;
 
-        LOG("TrafficProfileChecker::send checker [", this->name,
-                "] recorded address ", Utilities::toHex(p->addr()), "OT", ot);
+        LOG("TrafficProfileChecker::recordSend checker [", this->name,
+                "] recorded request at time", t, "OT", ot);
 
-        ok = fifo.send(underrun, overrun, next, request_time, t, p->size());
+        ok = fifo.send(underrun, overrun, next, request_time, t, size);
 
         // update statistics
-        stats.send(t, p->size(), ot);
+        stats.send(t, size, ot);
 
         // updates FIFO stats
         stats.fifoUpdate(fifo.getLevel(),underrun, overrun);
 
+        // check the QoS envelope
+        if (envelope.send(t, size, ot)) {
+            violation();
+        }
+
     } else {
-        LOG("TrafficProfileChecker::send [", this->name, "] is not active",
-                locked ? "it is locked" : "it's terminated");
+        LOG("TrafficProfileChecker::recordSend [", this->name,
+                "] is not active", locked ? "it is locked" : "it's terminated");
     }
     return ok;
 }
 
-
-bool TrafficProfileChecker::receive(
-        uint64_t& next,
-        const Packet* packet, const double delay) {
+void TrafficProfileChecker::recordReceive(const uint64_t t,
+        const uint64_t size, const double delay) {
     bool underrun=false, overrun=false, locked = false;
-    // get current time
-    const uint64_t& t = tpm->getTime();
-    next=0;
     // update OT count
     ot--;
-    LOG("TrafficProfileChecker::receive checker [", this->name,
-                    "] recorded address ",
-                    Utilities::toHex(packet->addr()), "OT", ot);
+    LOG("TrafficProfileChecker::recordReceive checker [", this->name,
+                    "] recorded response at time", t, "OT", ot);
     // this is a checker profile -> update the FIFO accordingly
-    fifo.receive(underrun, overrun, t, packet->size());
+    fifo.receive(underrun, overrun, t, size);
 
-    stats.receive(t, packet->size(), delay);
+    stats.receive(t, size, delay);
 
     // updates FIFO stats
     stats.fifoUpdate(fifo.getLevel(),underrun, overrun);
 
+    // check the QoS envelope
+    if (envelope.receive(t, delay, ot)) {
+        violation();
+    }
+
     // check if the profile is still active (triggers termination event)
     if (!active(locked) && !locked) {
-        LOG("TrafficProfileChecker::receive [", this->name, "] terminated");
+        LOG("TrafficProfileChecker::recordReceive [", this->name,
+                "] terminated");
+    }
+}
+
+bool TrafficProfileChecker::send(bool& locked, Packet*& p, uint64_t& next) {
+    if (nullptr == p) {
+        ERROR("TrafficProfileChecker::send checker [", this->name,
+                "] requested to record send with empty packet pointer");
     }
+    LOG("TrafficProfileChecker::send checker [", this->name,
+            "] recording address ", Utilities::toHex(p->addr()));
+
+    return recordSend(locked, next, tpm->getTime(), p->size());
+}
+
+bool TrafficProfileChecker::receive(
+        uint64_t& next,
+        const Packet* packet, const double delay) {
+    next=0;
+    LOG("TrafficProfileChecker::receive checker [", this->name,
+                    "] recording address ",
+                    Utilities::toHex(packet->addr()));
+
+    recordReceive(tpm->getTime(), packet->size(), delay);
 
     // a traffic profile checker should always accept requests
     return true;
 }
 
+bool TrafficProfileChecker::observe(const vector<Observation>& batch) {
+    bool ok = true;
+    for (auto& o : batch) {
+        if (find(checked.begin(), checked.end(), o.profile) ==
+            checked.end()) {
+            continue;
+        }
+        if (o.request) {
+            bool locked = false;
+            uint64_t next = 0;
+            ok &= recordSend(locked, next, o.time, o.size);
+        } else {
+            // a traffic profile checker should always accept responses
+            recordReceive(o.time, o.size, o.delay);
+        }
+    }
+    return ok;
+}
+
 bool TrafficProfileChecker::active(bool& l) {
     // avoid unused parameter warning
     (void) l;
@@ -138,6 +198,10 @@ bool TrafficProfileChecker::active(bool& l) {
     bool isActive = waiting();
 
     if (!isActive && !terminated) {
+        // close the QoS envelope windows ended so far
+        if (envelope.update(tpm->getTime())) {
+            violation();
+        }
         // fire deactivation event
         emitEvent(Event::TERMINATION);
 
@@ -169,4 +233,14 @@ bool TrafficProfileChecker::receiveEvent(const Event& e) {
     return ok || fifoOk;
 }
 
+void TrafficProfileChecker::walk(StateWalker& w) {
+    w.reject();
+}
+
+void TrafficProfileChecker::serialize(Snapshot& s) {
+    TrafficProfileDescriptor::serialize(s);
+    fifo.serialize(s);
+    envelope.serialize(s);
+}
+
 } /* namespace TrafficProfiles */
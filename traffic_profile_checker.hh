@@ -12,6 +12,7 @@
 
 #include "traffic_profile_desc.hh"
 #include "fifo.hh"
+#include "qos_envelope.hh"
 
 namespace TrafficProfiles {
 
@@ -27,12 +28,64 @@ namespace TrafficProfiles {
  * or it does exceed (WRITES) the monitor FIFO configuration
  *
  */
-class TrafficProfileChecker : public TrafficProfileDescriptor {
+class TrafficProfileChecker final : public TrafficProfileDescriptor {
+
+public:
+
+    /*!
+     *\brief Checked profile packet observation
+     *
+     * Records a request sent or a response received by a checked
+     * profile. Observations are published once on the TPM observation
+     * bus, and consumed once per tick by all checkers, in batches
+     */
+    struct Observation {
+        //! checked profile ID
+        uint64_t profile;
+        //! observation time
+        uint64_t time;
+        //! packet size
+        uint64_t size;
+        //! request to response delay, responses only
+        double delay;
+        //! true for requests, false for responses
+        bool request;
+    };
 
 protected:
     //! ATP FIFO
     Fifo fifo;
 
+    //! QoS envelope, enabled by a QoS configuration
+    QosEnvelope envelope;
+
+    //! IDs of the checked profiles
+    vector<uint64_t> checked;
+
+    /*!
+     * Signals the start of a QoS envelope excursion
+     * by firing a QOS_VIOLATION event, if configured
+     */
+    void violation();
+
+    /*!
+     * Records a request sent by the checked profile
+     *\param locked returns true if the checker is locked on waits
+     *\param next time a packet will be available
+     *\param t the request time
+     *\param size the request size
+     *\return true if the request is within the checker FIFO limits
+     */
+    bool recordSend(bool&, uint64_t&, const uint64_t, const uint64_t);
+
+    /*!
+     * Records a response received by the checked profile
+     *\param t the response time
+     *\param size the response size
+     *\param delay measured request to response delay
+     */
+    void recordReceive(const uint64_t, const uint64_t, const double);
+
 public:
 
     /*!
@@ -84,6 +137,17 @@ public:
      */
     virtual bool receive(uint64_t&, const Packet*, const double);
 
+    /*!
+     * Consumes a batch of observations from the TPM observation bus,
+     * skipping those of profiles this checker doesn't check
+     *\param batch the observations, in publication order
+     *\return true if all observations were accepted, false otherwise
+     */
+    bool observe(const vector<Observation>&);
+
+    //! returns this checker QoS envelope
+    inline const QosEnvelope& getEnvelope() const { return envelope; }
+
     /*!
     * Activates this profile FIFO
     */
@@ -99,6 +163,18 @@ public:
     */
     virtual bool receiveEvent(const Event&);
 
+    /*!
+     * Checkers are not eligible for fast-forward
+     *\param w the state walker
+     */
+    virtual void walk(StateWalker&);
+
+    /*!
+     * Saves or restores the checker FIFO and QoS envelope
+     *\param s the snapshot
+     */
+    virtual void serialize(Snapshot&);
+
     /*!
      * Resets this profile
      */
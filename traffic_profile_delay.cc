@@ -9,6 +9,8 @@
 
 #include "traffic_profile_delay.hh"
 #include "traffic_profile_manager.hh"
+#include "fast_forward.hh"
+#include "snapshot.hh"
 
 namespace TrafficProfiles {
 
@@ -133,5 +135,20 @@ bool TrafficProfileDelay::receive(
     return false;
 }
 
+void TrafficProfileDelay::walk(StateWalker& w) {
+    TrafficProfileDescriptor::walk(w);
+    // the start time follows the current time until started
+    w(startTime, started ? StateWalker::VALUE : StateWalker::TIME);
+    w(time, StateWalker::TIME);
+    if (started && !terminated) {
+        w.deadline(startTime + delay);
+    }
+}
+
+void TrafficProfileDelay::serialize(Snapshot& s) {
+    TrafficProfileDescriptor::serialize(s);
+    s(startTime);
+    s(time);
+}
 
 } /* namespace TrafficProfiles */
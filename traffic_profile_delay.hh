@@ -24,7 +24,7 @@ namespace TrafficProfiles {
  * and accepting no responses. At the of the configured
  * delay, it would terminate.
  */
-class TrafficProfileDelay: public TrafficProfileDescriptor {
+class TrafficProfileDelay final : public TrafficProfileDescriptor {
 
 protected:
     //! configured delay in ATP time units
@@ -94,6 +94,19 @@ public:
      */
     virtual bool receive(uint64_t&, const Packet*, const double);
 
+    /*!
+     * Walks the profile state for fast-forward,
+     * which is bounded by the delay expiration
+     *\param w the state walker
+     */
+    virtual void walk(StateWalker&);
+
+    /*!
+     * Saves or restores the profile runtime state
+     *\param s the snapshot
+     */
+    virtual void serialize(Snapshot&);
+
     /*!
      * Resets this profile
      */
@@ -11,6 +11,8 @@
 #include "traffic_profile_manager.hh"
 #include "logger.hh"
 #include "utilities.hh"
+#include "fast_forward.hh"
+#include "snapshot.hh"
 
 #include <algorithm>
 #include <stdexcept>
@@ -24,18 +26,24 @@ const string TrafficProfileDescriptor::Name::CloneSuffix {
 const string TrafficProfileDescriptor::Name::Default {
     Reserved + string("profile")
 };
-uint64_t TrafficProfileDescriptor::Name::AnonymousCount { 0 };
+
+const string TrafficProfileDescriptor::roleText[] = {
+        [NONE]    = "NONE",
+        [MASTER]  = "MASTER",
+        [CHECKER] = "CHECKER",
+        [SLAVE]   = "SLAVE",
+        [DELAY]   = "DELAY"
+};
 
 TrafficProfileDescriptor::TrafficProfileDescriptor(
         TrafficProfileManager* manager, const uint64_t index, const Profile* p,
         const uint64_t clone_num) :
         EventManager(index,manager),
-        config(p),
-        role(NONE), type(p->type()), tpm(manager), id(index), name(p->name()),
-        masterName(""), masterId(0),
+        config(p), tpm(manager), id(index), masterId(0), ot(0),
+        role(NONE), started(false), terminated(false), type(p->type()),
         _masterIommuId(p->has_iommu_id() ?
                        p->iommu_id() : InvalidId<uint32_t>()),
-        ot(0), started(false), startTime(0), terminated(false) {
+        startTime(0), name(p->name()), masterName("") {
 
     if (clone_num)
         name.append(Name::CloneSuffix).append(to_string(clone_num - 1));
@@ -184,4 +192,46 @@ uint64_t TrafficProfileDescriptor::parseTime(const string t) {
     return (uint64_t)round(ret);
 }
 
+void TrafficProfileDescriptor::walk(StateWalker& w) {
+    // checkers need to observe every packet
+    if (!checkers.empty()) {
+        w.reject();
+        return;
+    }
+    EventManager::walk(w);
+    w(masterId);
+    w(ot);
+    w(role);
+    w(started);
+    w(terminated);
+    w(startTime);
+    w(_streamId);
+    stats.walk(w);
+    if (packetTagger != nullptr) {
+        packetTagger->walk(w);
+    }
+}
+
+void TrafficProfileDescriptor::serialize(Snapshot& s) {
+    EventManager::serialize(s);
+    s(ot);
+    s(started);
+    s(terminated);
+    s(startTime);
+    s(_streamId);
+    stats.serialize(s);
+    // streams create taggers at runtime
+    bool tagged = (packetTagger != nullptr);
+    s(tagged);
+    if (tagged) {
+        if (packetTagger == nullptr) {
+            packetTagger = new PacketTagger();
+        }
+        packetTagger->serialize(s);
+    }
+    if (s.restoring() && packetTagger != nullptr && isValid(_streamId)) {
+        packetTagger->stream_id = _streamId;
+    }
+}
+
 } // end of namespace
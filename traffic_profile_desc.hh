@@ -27,6 +27,8 @@ using namespace std;
 namespace TrafficProfiles {
 
     class TrafficProfileManager;
+    class StateWalker;
+    class Snapshot;
 
     /*!
      *\brief Implements the AMBA Traffic Profile base class
@@ -46,22 +48,41 @@ namespace TrafficProfiles {
             DELAY=4
         };
 
+        //! Roles text description
+        static const string roleText[];
+
         struct Name {
             static constexpr char Reserved { '$' };
             static const string CloneSuffix;
             static const string Default;
-            static uint64_t AnonymousCount;
         };
 
     protected:
         //! traffic profile configuration
         const Profile* config;
+        //! pointer to parent TPM
+        TrafficProfileManager* const tpm;
+
+        /* fields accessed on every engine visit of the profile
+         * are kept together to share cache lines */
+
+        //! Traffic Profile unique ID
+        const uint64_t id;
+        //! Traffic Profile Master Id
+        uint64_t masterId;
+        //! number of current outstanding transactions
+        uint64_t ot;
         //! Traffic Profile Role
         Role role;
+        //! true if this profile started
+        bool started;
+        //! true if this profile terminated
+        bool terminated;
+
         //! Traffic Profile Type
         const Profile::Type type;
-        //! pointer to parent TPM
-        TrafficProfileManager* const tpm;
+        //! Traffic Profile Master IOMMU ID
+        uint32_t _masterIommuId;
         /*!
         *\brief Packet tagger module
         *
@@ -69,33 +90,18 @@ namespace TrafficProfiles {
         * local Packet Descriptor configuration
         */
         PacketTagger* packetTagger {nullptr};
-        //! Traffic Profile unique ID
-        const uint64_t id;
+        //! Traffic Profile Stream ID
+        uint64_t _streamId{ InvalidId<uint64_t>() };
+        //! profile start time
+        uint64_t startTime;
         //! Traffic Profile Name
         string name;
         //! Traffic Profile Master Name : used to tag packets and register with TPM
         string masterName;
-        //! Traffic Profile Master Id
-        uint64_t masterId;
-        //! Traffic Profile Stream ID
-        uint64_t _streamId{ InvalidId<uint64_t>() };
-        //! Traffic Profile Master IOMMU ID
-        uint32_t _masterIommuId;
 
-        //! number of current outstanding transactions
-        uint64_t ot;
         //! statistics collected at Traffic Profile level
         Stats stats;
 
-        //! true if this profile started
-        bool started;
-
-        //! profile start time
-        uint64_t startTime;
-
-        //! true if this profile terminated
-        bool terminated;
-
         // Monitors support
         //! set of checkers (ATP monitors) assigned to this profile
         set<uint64_t> checkers;
@@ -207,72 +213,91 @@ namespace TrafficProfiles {
          * Returns the termination status of this Traffic Profile
          *\return whether this Traffic Profile is terminated
          */
-        virtual inline const bool& isTerminated() const { return terminated;}
+        inline const bool& isTerminated() const { return terminated;}
 
         /*!
          * Register checker (ATP Monitor) to this profile
          *\param cid checker profile ID
          */
-        virtual inline void registerChecker(const uint64_t cid) {checkers.emplace(cid);}
+        inline void registerChecker(const uint64_t cid) {checkers.emplace(cid);}
 
         /*
          * getter method for the TPM pointer
          *\return a pointer to the TPM
          */
-        virtual inline TrafficProfileManager* const & getTpm() { return tpm;}
+        inline TrafficProfileManager* const & getTpm() { return tpm;}
 
         /*! getter method for this Traffic Profile id
          *\return the traffic profile id
          */
-        virtual inline const uint64_t& getId() const {return id;}
+        inline const uint64_t& getId() const {return id;}
 
         /*! getter method for this Traffic Profile name
          *\return the traffic profile name
          */
-        virtual inline const string& getName() const {return name;}
+        inline const string& getName() const {return name;}
         /*! getter method for this Traffic Profile master name
          *\return the traffic profile master name
          */
-        virtual inline const string& getMasterName() const {return masterName;}
+        inline const string& getMasterName() const {return masterName;}
 
         /*! getter method for this Traffic Profile master ID
          *\return the traffic profile master ID
          */
-        virtual inline const uint64_t& getMasterId() const {return masterId;}
+        inline const uint64_t& getMasterId() const {return masterId;}
 
         /*!
          * gets the profile role
          *\return profile role type
          */
-        virtual inline const Role& getRole() const {return role;}
+        inline const Role& getRole() const {return role;}
 
         /*! getter method for this Traffic Profile statistics object
          *\return a constant reference to this Profile statistics object
          */
-        virtual inline const Stats& getStats() const {return stats;}
+        inline const Stats& getStats() const {return stats;}
+
+        /*!
+         * Enables the response latency histogram of this profile stats
+         */
+        inline void enableLatencyHistogram() {stats.enableLatencyHistogram();}
+
         /*!
          * Advances this Traffic Profile statistics object time
          *\param t time to set
          */
-        virtual inline void setStatsTime(const uint64_t t) {stats.setTime(t);}
+        inline void setStatsTime(const uint64_t t) {stats.setTime(t);}
 
         /*!
          * Returns the current outstanding transactions (OT) number
          *\return OT
          */
-        virtual inline uint64_t getOt() const {return ot;}
+        inline uint64_t getOt() const {return ot;}
 
         /*!
          * Gets a const reference to the internal configuration
          * object
          *\return the internal configuration object
          */
-        virtual inline const Profile* getConfig() const {return config;}
+        inline const Profile* getConfig() const {return config;}
 
         /*!
          * Activates the profile
          */
         void activate();
+
+        /*!
+         * Walks the profile state for fast-forward,
+         * profiles with checkers are not eligible
+         *\param w the state walker
+         */
+        virtual void walk(StateWalker&);
+
+        /*!
+         * Saves or restores the profile runtime state
+         *\param s the snapshot
+         */
+        virtual void serialize(Snapshot&);
      };
 } // end of namespace
 #endif /* __AMBA_TRAFFIC_PROFILE_DESC_HH_ */
@@ -33,15 +33,22 @@ const uint64_t TrafficProfileManager::defaultFrequency = 1e9;
 
 TrafficProfileManager::TrafficProfileManager() :
                                 initialized(false), profilesAsMasters(false),
-                                trackerLatency(false), kronosEnabled(false),
+                                trackerLatency(false), latencyHistogram(false),
+                                kronosEnabled(false),
                                 kronosBucketsWidth(0), kronosCalendarLength(0),
                                 kronosConfigurationValid(false),
                                 time(0), timeResolution(defaultTimeResolution),
-                                forwardDeclaredProfiles(0),
-                                tracer(this), streamCacheValid(false), kronos(this) {
+                                forwardDeclaredProfiles(0), lazyProfiles(true),
+                                rateScale(1), anonymousProfiles(0),
+                                tracer(this), streamCacheValid(false),
+                                dispatched(0), kronos(this),
+                                timeline(this), fastForward(this),
+                                sampler(this), suspended(false) {
 }
 
 TrafficProfileManager::~TrafficProfileManager() {
+    // the timeline records profile names on close
+    timeline.close();
     for (auto& p : profiles) {
         delete p;
     }
@@ -50,6 +57,7 @@ TrafficProfileManager::~TrafficProfileManager() {
 void TrafficProfileManager::signalReset(const uint64_t pId) {
     try {
         nonTerminatedProfiles[profiles.at(pId)->getMasterId()]++;
+        streamTopology.leafReset(pId);
     } catch (out_of_range& oor){
         ERROR("TrafficProfileManager::signalReset unknown profile id", pId);
     }
@@ -90,40 +98,41 @@ bool TrafficProfileManager::isTerminated(const string& m) {
     return terminated;
 }
 
-bool TrafficProfileManager::load(const string& fileName) {
+bool TrafficProfileManager::parse(const string& fileName, Configuration& c) {
     // input stream used to acquire traffic profile specifications
     ifstream stream(fileName.c_str());
-    bool ok = false;
-    if (stream.is_open()) {
-        LOG("TrafficProfileManager::init loading Manager object from file",
-                fileName);
-        // zero copy input stream from istream
-        IstreamInputStream zeroCopyStream(&stream);
-        // allocate google protocol buffer configuration object
-        Configuration c;
-        // Allocate a parser object
-        TextFormat::Parser parser;
-        // configure the parser to be case insensitive
-        parser.AllowCaseInsensitiveField(true);
-
-        // TextFormat acquires from plain text Google Protocol Buffer specifications
-        if (parser.Parse(&zeroCopyStream, &c)) {
-            // load the configuration object into the Traffic Profiles descriptors
-            loadConfiguration(c);
-        } else {
-            ERROR("TrafficProfileManager::load errors parsing file", fileName);
-        }
-        // close istream
-        stream.close();
-        // mark TPM as initialized
-        initialized = true;
-        // return ok
-        ok = true;
-    } else {
+    if (!stream.is_open()) {
         WARN("TrafficProfileManager::init unable to access file ", fileName);
+        return false;
     }
+    LOG("TrafficProfileManager::init loading Manager object from file",
+            fileName);
+    // zero copy input stream from istream
+    IstreamInputStream zeroCopyStream(&stream);
+    // Allocate a parser object
+    TextFormat::Parser parser;
+    // configure the parser to be case insensitive
+    parser.AllowCaseInsensitiveField(true);
+
+    // TextFormat acquires from plain text Google Protocol Buffer specifications
+    if (!parser.Parse(&zeroCopyStream, &c)) {
+        ERROR("TrafficProfileManager::load errors parsing file", fileName);
+        return false;
+    }
+    return true;
+}
 
-    return ok;
+bool TrafficProfileManager::load(const string& fileName) {
+    // allocate google protocol buffer configuration object
+    Configuration c;
+    if (!parse(fileName, c)) {
+        return false;
+    }
+    // load the configuration object into the Traffic Profiles descriptors
+    loadConfiguration(c);
+    // mark TPM as initialized
+    initialized = true;
+    return true;
 }
 
 void TrafficProfileManager::configure(const Configuration& from) {
@@ -192,6 +201,20 @@ TrafficProfileManager::masterName(const uint64_t mId) const {
     }
 }
 
+uint64_t TrafficProfileManager::packetMaster(const Packet* pkt) const {
+    if (pkt->has_master_ref()) {
+        return pkt->master_ref();
+    }
+    const auto m = masterMap.find(pkt->master_id());
+    return (m != masterMap.end() ? m->second : InvalidId<uint64_t>());
+}
+
+const string&
+TrafficProfileManager::packetMasterName(const Packet* pkt) const {
+    return (pkt->has_master_id() || !pkt->has_master_ref() ?
+            pkt->master_id() : masterName(pkt->master_ref()));
+}
+
 
 const unordered_set<string>
 TrafficProfileManager::getMasters() const {
@@ -211,10 +234,15 @@ const Stats TrafficProfileManager::getMasterStats(const string& m) {
     auto it = masterProfiles.find(mId);
     if (it != masterProfiles.end()) {
         for (auto& p : it->second) {
-            if (!terminated) {
+            if (!terminated && profiles.at(p) != nullptr) {
                 profiles.at(p)->setStatsTime(time);
             }
-            ret += profiles.at(p)->getStats();
+            Stats s { profileStats(p) };
+            // deferred profiles follow their master time too
+            if (!terminated) {
+                s.setTime(time);
+            }
+            ret += s;
         }
     } else {
         ERROR("TrafficProfileManager::getMasterStats Unknown master requested",
@@ -224,10 +252,10 @@ const Stats TrafficProfileManager::getMasterStats(const string& m) {
 }
 
 TrafficProfileDescriptor* TrafficProfileManager::getProfile(
-        const uint64_t index) const {
+        const uint64_t index) {
     TrafficProfileDescriptor* ret(nullptr);
     try {
-        ret = profiles.at(index);
+        ret = instantiate(index);
     } catch (out_of_range& oor) {
         ERROR("TrafficProfileManager::getProfile unable to find profile id",
                 index, "in", oor.what());
@@ -235,11 +263,116 @@ TrafficProfileDescriptor* TrafficProfileManager::getProfile(
     return ret;
 }
 
+const string TrafficProfileManager::profileName(const uint64_t pId) const {
+    auto d = deferredProfiles.find(pId);
+    if (d != deferredProfiles.end()) {
+        string name { d->second.config->name() };
+        if (d->second.cloneNum) {
+            name.append(TrafficProfileDescriptor::Name::CloneSuffix)
+                .append(to_string(d->second.cloneNum - 1));
+        }
+        return name;
+    }
+    return profiles.at(pId)->getName();
+}
+
+const Profile* TrafficProfileManager::profileConfig(const uint64_t pId) const {
+    auto d = deferredProfiles.find(pId);
+    return (d != deferredProfiles.end() ?
+            d->second.config : profiles.at(pId)->getConfig());
+}
+
+const Stats TrafficProfileManager::getMastersStats() const {
+    Stats ret;
+    ret.timeScale = toFrequency(timeResolution);
+    for (auto& m : masterProfiles) {
+        for (auto& p : m.second) {
+            if (!isChecker(p)) {
+                ret += profileStats(p);
+            }
+        }
+    }
+    return ret;
+}
+
+map<string, AnalyticalModel::Estimate>
+TrafficProfileManager::estimate() const {
+    const double frequency = toFrequency(timeResolution);
+    AnalyticalModel model(frequency);
+
+    // rates in bytes per ATP time unit, as the profiles parse them
+    auto rate = [&](const uint64_t id, const string& s) {
+        uint64_t r = 0, multiplier = 0;
+        tie(r, multiplier) = Utilities::toRate<uint64_t>(s);
+        if (multiplier > 0) {
+            return (double)r * multiplier / frequency;
+        }
+        auto f = timeScaleFactor.find(id);
+        return (f != timeScaleFactor.end() && f->second.second > 0 ?
+                (double)r / f->second.second : (double)r);
+    };
+
+    for (auto s : slaves) {
+        const auto* slave = static_cast<TrafficProfileSlave*>(profiles.at(s));
+        const auto& bw = slave->getBandwidth();
+        model.addSlave(s, (bw.second > 0 ? (double)bw.first / bw.second : 0),
+                       slave->getMeanLatency(), slave->getMaxOt(),
+                       slave->getWidth());
+    }
+    for (auto& m : masterProfiles) {
+        // masters without an assigned slave fall back to a single one
+        auto s = masterSlaveMap.find(m.first);
+        const uint64_t slave = (s != masterSlaveMap.end() ? s->second :
+                                slaves.size() == 1 ? *slaves.begin() :
+                                InvalidId<uint64_t>());
+        for (auto p : m.second) {
+            if (isChecker(p)) {
+                continue;
+            }
+            const Profile* conf = profileConfig(p);
+            double r = 0;
+            if (conf->has_fifo()) {
+                r = rate(p, conf->fifo().rate());
+                if (!conf->fifo().has_rate_control()) {
+                    r *= rateScale;
+                }
+            }
+            model.addProfile(*conf, profileName(p), masterName(m.first),
+                             slave, r);
+        }
+    }
+    return model.estimate();
+}
+
+void TrafficProfileManager::enableLatencyHistogram() {
+    latencyHistogram = true;
+    stats.enableLatencyHistogram();
+    // deferred masters enable theirs once instantiated
+    for (auto& m : masterProfiles) {
+        for (auto p : m.second) {
+            if (profiles.at(p) != nullptr) {
+                profiles[p]->enableLatencyHistogram();
+            }
+        }
+    }
+}
+
+Stats TrafficProfileManager::profileStats(const uint64_t pId) const {
+    const auto* p = profiles.at(pId);
+    if (p != nullptr) {
+        return p->getStats();
+    }
+    // not instantiated yet: same as a profile which never started
+    Stats ret;
+    ret.timeScale = toFrequency(timeResolution);
+    return ret;
+}
+
 const Stats TrafficProfileManager::getProfileStats(const string& p) {
     Stats ret;
     try {
         const auto id = profileMap.at(p);
-        ret = profiles.at(id)->getStats();
+        ret = profileStats(id);
     } catch (out_of_range& oor) {
         ERROR(
                 "TrafficProfileManager::getProfileStats Unknown profile requested",
@@ -248,6 +381,77 @@ const Stats TrafficProfileManager::getProfileStats(const string& p) {
     return ret;
 }
 
+const map<string, const QosEnvelope*>
+TrafficProfileManager::getQosEnvelopes() const {
+    map<string, const QosEnvelope*> ret;
+    for (auto id : checkers) {
+        auto* checker = static_cast<TrafficProfileChecker*>(profiles.at(id));
+        if (checker->getEnvelope().isEnabled()) {
+            ret.emplace(checker->getName(), &checker->getEnvelope());
+        }
+    }
+    return ret;
+}
+
+const map<string, const RateController*>
+TrafficProfileManager::getRateControllers() const {
+    map<string, const RateController*> ret;
+    for (uint64_t id = 0; id < profiles.size(); ++id) {
+        // deferred masters have not started yet
+        if (role(id) != TrafficProfileDescriptor::MASTER ||
+            profiles[id] == nullptr) {
+            continue;
+        }
+        auto* master = static_cast<TrafficProfileMaster*>(profiles[id]);
+        if (master->getRateController().isEnabled()) {
+            ret.emplace(master->getName(), &master->getRateController());
+        }
+    }
+    return ret;
+}
+
+EngineProfiler::Report TrafficProfileManager::getEngineProfile() const {
+    EngineProfiler::Report ret;
+    ret.nsPerTick = profiler.nsPerTick();
+    ret.total = profiler.getTotal();
+    for (uint64_t id = 0; id < profiler.size(); ++id) {
+        const auto* e = profiler.getEntry(id);
+        if (e->empty()) {
+            continue;
+        }
+        ret.roles[TrafficProfileDescriptor::roleText[role(id)]] += *e;
+        ret.profiles[profileName(id)] += *e;
+    }
+    return ret;
+}
+
+double TrafficProfileManager::getOfferedLoad() const {
+    double ret = 0;
+    for (uint64_t id = 0; id < profiles.size(); ++id) {
+        if (role(id) != TrafficProfileDescriptor::MASTER ||
+            profiles[id] == nullptr) {
+            continue;
+        }
+        const auto r =
+                static_cast<TrafficProfileMaster*>(profiles[id])->getFifoRate();
+        if (r.second > 0) {
+            ret += (double)r.first / r.second;
+        }
+    }
+    return ret * toFrequency(timeResolution);
+}
+
+void TrafficProfileManager::scaleRates(const double s) {
+    for (uint64_t id = 0; id < profiles.size(); ++id) {
+        if (role(id) == TrafficProfileDescriptor::MASTER &&
+            profiles[id] != nullptr) {
+            static_cast<TrafficProfileMaster*>(profiles[id])->scaleFifoRate(s);
+        }
+    }
+    rateScale *= s;
+    LOG("TrafficProfileManager::scaleRates scaled by", s, "at time", time);
+}
+
 uint64_t TrafficProfileManager::toFrequency(const Configuration::TimeUnit t) {
     uint64_t ret = 1;
     switch (t) {
@@ -396,6 +600,12 @@ void TrafficProfileManager::createProfile(
         "profile descriptor ID",id,"not found");
     }
 
+    // postpone instantiation until the profile first activation
+    if (lazyProfiles && isDeferrable(from)) {
+        deferProfile(id, from, clone_num, master_id);
+        return;
+    }
+
     bool slave = false;
     // a packet descriptor means this is a master profile
     if (from.has_pattern()) {
@@ -409,7 +619,8 @@ void TrafficProfileManager::createProfile(
     } else if (from.has_delay()) {
         temp = new TrafficProfileDelay(this, id, &from, clone_num);
     } else if (from.check_size() > 0) {
-        temp = new TrafficProfileChecker(this, id, &from, clone_num);
+        auto* checker = new TrafficProfileChecker(this, id, &from, clone_num);
+        temp = checker;
         //register this profile as a checker
         checkers.insert(id);
 
@@ -419,7 +630,13 @@ void TrafficProfileManager::createProfile(
             if (clone_num)
                 toCheck.append(TrafficProfileDescriptor::Name::CloneSuffix)
                        .append(to_string(clone_num - 1));
-            checkedByMap.emplace(make_pair(getOrGeneratePid(toCheck), temp));
+            const uint64_t checked { getOrGeneratePid(toCheck) };
+            checkedByMap.emplace(make_pair(checked, temp));
+            // subscribe the checker to the checked profile observations
+            if (checked >= observers.size()) {
+                observers.resize(checked + 1);
+            }
+            observers[checked].push_back(checker);
 
             LOG("TrafficProfileManager::createProfile registered profile",
                     temp->getName(), "as checker for profile", toCheck);
@@ -430,26 +647,151 @@ void TrafficProfileManager::createProfile(
     }
 
     if (!slave) {
-        const string &mName {
-            profilesAsMasters ? temp->getName() :
-            isValid(master_id) ? masterName(master_id) :
-            from.master_id()
-        };
-        // register masterId (string)
-        const uint64_t mId = getOrGenerateMid(mName);
-        masterProfiles[mId].insert(id);
+        const uint64_t mId = registerToMaster(id, temp->getName(),
+                                              from, master_id);
         // add the Traffic Profile to the master
-        temp->addToMaster(mId, mName);
-        // update active profiles count
-        nonTerminatedProfiles[mId]++;
+        temp->addToMaster(mId, masterName(mId));
     } else {
         slaves.insert(id);
     }
     // finally push the newly created profile
     profiles[id] = temp;
+    setRole(id, temp->getRole());
+}
+
+void TrafficProfileManager::setRole(const uint64_t pId,
+        const TrafficProfileDescriptor::Role r) {
+    if (pId >= roles.size()) {
+        roles.resize(pId + 1, TrafficProfileDescriptor::NONE);
+    }
+    roles[pId] = r;
+}
+
+bool TrafficProfileManager::profileSend(TrafficProfileDescriptor* p,
+        bool& locked, Packet*& pkt, uint64_t& next) {
+    // concrete profile types are final: these calls are not virtual
+    switch (p->getRole()) {
+    case TrafficProfileDescriptor::MASTER:
+        return static_cast<TrafficProfileMaster*>(p)->send(locked, pkt, next);
+    case TrafficProfileDescriptor::SLAVE:
+        return static_cast<TrafficProfileSlave*>(p)->send(locked, pkt, next);
+    case TrafficProfileDescriptor::DELAY:
+        return static_cast<TrafficProfileDelay*>(p)->send(locked, pkt, next);
+    case TrafficProfileDescriptor::CHECKER:
+        return static_cast<TrafficProfileChecker*>(p)->send(locked, pkt, next);
+    default:
+        return p->send(locked, pkt, next);
+    }
+}
+
+bool TrafficProfileManager::profileReceive(TrafficProfileDescriptor* p,
+        uint64_t& next, const Packet* pkt, const double delay) {
+    switch (p->getRole()) {
+    case TrafficProfileDescriptor::MASTER:
+        return static_cast<TrafficProfileMaster*>(p)->receive(next, pkt, delay);
+    case TrafficProfileDescriptor::SLAVE:
+        return static_cast<TrafficProfileSlave*>(p)->receive(next, pkt, delay);
+    case TrafficProfileDescriptor::DELAY:
+        return static_cast<TrafficProfileDelay*>(p)->receive(next, pkt, delay);
+    case TrafficProfileDescriptor::CHECKER:
+        return static_cast<TrafficProfileChecker*>(p)->receive(next, pkt, delay);
+    default:
+        return p->receive(next, pkt, delay);
+    }
+}
+
+uint64_t TrafficProfileManager::registerToMaster(const uint64_t id,
+        const string& name, const Profile& from, const uint64_t master_id) {
+    const string mName {
+        profilesAsMasters ? name :
+        isValid(master_id) ? masterName(master_id) :
+        from.master_id()
+    };
+    // register masterId (string)
+    const uint64_t mId = getOrGenerateMid(mName);
+    masterProfiles[mId].insert(id);
+    // update active profiles count
+    nonTerminatedProfiles[mId]++;
+    return mId;
+}
+
+bool TrafficProfileManager::isDeferrable(const Profile& from) const {
+    // only masters and delays waiting for other profiles are deferred,
+    // slaves and checkers have to be known upfront for routing
+    if ((!from.has_pattern() && !from.has_delay()) || from.has_slave()
+            || from.check_size() > 0 || from.wait_for_size() == 0) {
+        return false;
+    }
+    for (int i = 0; i < from.wait_for_size(); ++i) {
+        Event::Type evType = Event::NONE;
+        string profile;
+        if (!Event::parse(evType, profile, from.wait_for(i))
+                || evType != Event::TERMINATION) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void TrafficProfileManager::deferProfile(const uint64_t id,
+        const Profile& from, const uint64_t clone_num,
+        const uint64_t master_id) {
+    // subscribe the waited for events on behalf of the profile,
+    // this mirrors the TrafficProfileDescriptor constructor
+    for (int i = 0; i < from.wait_for_size(); ++i) {
+        Event::Type evType = Event::NONE;
+        string profile;
+        Event::parse(evType, profile, from.wait_for(i));
+        if (clone_num)
+            profile.append(TrafficProfileDescriptor::Name::CloneSuffix)
+                   .append(to_string(clone_num - 1));
+        subscribe(id, Event(evType, Event::AWAITED,
+                            getOrGeneratePid(profile), time));
+    }
+
+    string name { from.name() };
+    if (clone_num)
+        name.append(TrafficProfileDescriptor::Name::CloneSuffix)
+            .append(to_string(clone_num - 1));
+
+    const uint64_t mId = registerToMaster(id, name, from, master_id);
+    setRole(id, from.has_pattern() ? TrafficProfileDescriptor::MASTER :
+                                     TrafficProfileDescriptor::DELAY);
+    deferredProfiles.emplace(id, DeferredProfile { &from, clone_num, mId,
+                                                   InvalidId<uint64_t>() });
+    LOG("TrafficProfileManager::deferProfile profile", name,
+        "instantiation deferred to its first activation");
+}
+
+TrafficProfileDescriptor* TrafficProfileManager::instantiate(const uint64_t id) {
+    auto it = deferredProfiles.find(id);
+    if (it != deferredProfiles.end()) {
+        const DeferredProfile d { it->second };
+        deferredProfiles.erase(it);
+
+        TrafficProfileDescriptor* temp = nullptr;
+        if (d.config->has_pattern()) {
+            temp = new TrafficProfileMaster(this, id, d.config, d.cloneNum);
+        } else {
+            temp = new TrafficProfileDelay(this, id, d.config, d.cloneNum);
+        }
+        temp->addToMaster(d.masterId, masterName(d.masterId));
+        if (isValid(d.streamId)) {
+            temp->addToStream(d.streamId);
+        }
+        // register checkers to the instantiated profile
+        auto range = checkedByMap.equal_range(id);
+        for (auto c = range.first; c != range.second; ++c) {
+            temp->registerChecker(c->second->getId());
+        }
+        profiles[id] = temp;
+        LOG("TrafficProfileManager::instantiate profile", temp->getName(),
+            "instantiated at time", time);
+    }
+    return profiles.at(id);
 }
 
-void TrafficProfileManager::configureProfile(const Profile& from,
+uint64_t TrafficProfileManager::configureProfile(const Profile& from,
         const pair<uint64_t, uint64_t> ts,
         bool overwrite, const uint64_t clone_num, const uint64_t master_id) {
 
@@ -476,7 +818,8 @@ void TrafficProfileManager::configureProfile(const Profile& from,
     } else {
         id = it->second;
 
-        if (profiles.at(id) == nullptr) {
+        if (profiles.at(id) == nullptr &&
+                deferredProfiles.find(id) == deferredProfiles.end()) {
             // this profile name was forward-declared earlier,
             // complete the creation process
             LOG("TrafficProfileManager::configureProfile completed creation of "
@@ -490,6 +833,8 @@ void TrafficProfileManager::configureProfile(const Profile& from,
                 profName);
             // deallocate previously allocated profile
             delete profiles[id];
+            profiles[id] = nullptr;
+            deferredProfiles.erase(id);
         }
     }
     // insert the time scale factor into the map
@@ -501,6 +846,8 @@ void TrafficProfileManager::configureProfile(const Profile& from,
 
     // enable TPM
     initialized = true;
+
+    return id;
 }
 
 void TrafficProfileManager::loadConfiguration(const Configuration& toLoad) {
@@ -532,12 +879,14 @@ void TrafficProfileManager::loadConfiguration(const Configuration& toLoad) {
         if (!from.has_name())
             c.mutable_profile(i)->set_name(
                     TrafficProfileDescriptor::Name::Default + to_string(
-                    TrafficProfileDescriptor::Name::AnonymousCount++));
+                    anonymousProfiles++));
         configureProfile(from, ts);
     }
 
-    // register checkers to checked profiles
+    // register checkers to checked profiles - deferred profiles
+    // register their checkers when instantiated
     for (auto c = begin(checkedByMap); c != end(checkedByMap); ++c) {
+        if (profiles.at(c->first) == nullptr) continue;
         profiles.at(c->first)->registerChecker(c->second->getId());
 
         LOG("TrafficProfileManager::loadConfiguration registered checker",
@@ -556,6 +905,8 @@ void TrafficProfileManager::flush() {
     LOG("TrafficProfileManager::flush requested", stats.dump());
     // clear the configuration
     config.clear();
+    // profile IDs are no longer valid
+    profiler.reset();
     // reset the TPM
     reset();
 }
@@ -573,24 +924,34 @@ void TrafficProfileManager::reset() {
     profileMap.clear();
     checkers.clear();
     checkedByMap.clear();
+    observations.clear();
+    observers.clear();
+    roles.clear();
     masters.clear();
     masterMap.clear();
     masterProfiles.clear();
     masterSlaveMap.clear();
-    streamCache.clear();
-    streamLeavesCache.clear();
+    streamTopology.clear();
     clonedStreams.clear();
     streamCloneToOrigin.clear();
     streamCacheValid = false;
+    deferredProfiles.clear();
     nonTerminatedProfiles.clear();
     activeList.clear();
     waitedResponseUidMap.clear();
     // reset all waited for requests
     waitedRequestUidMap.clear();
     // reset all waited for events
-    waitEventMap.clear();
+    dispatchTable.clear();
+    subscriptions.clear();
     // clear next transmission times
     nextTimes = NextTimesPq();
+    suspended = false;
+    // drop all scheduled events
+    kronos.reset();
+    // drop any detected regime and sampled windows
+    fastForward.reset();
+    sampler.reset();
     // backup current configuration
     auto temp = config;
     // clear current configuration
@@ -622,47 +983,65 @@ bool TrafficProfileManager::print(string& output) {
 void TrafficProfileManager::updateCheckers(const uint64_t profile,
         Packet* packet, const double delay) {
 
-    LOG("TrafficProfileManager::updateCheckers master", packet->master_id(),
+    // skip profiles with no checkers
+    if (profile >= observers.size() || observers[profile].empty()) {
+        return;
+    }
+
+    LOG("TrafficProfileManager::updateCheckers master",
+            packetMasterName(packet),
             "address", Utilities::toHex(packet->addr()));
 
-    // Initialise request flags
-    bool checkerLocked = false;
-    uint64_t nextCheckerTime = 0;
-
-    // select checkers for this profile
-    auto range = checkedByMap.equal_range(profile);
-    for (auto it = range.first, et = range.second; it != et; ++it) {
-
-        bool ok = false;
-
-        LOG("TrafficProfileManager::updateCheckers", "registering",
-                Command_Name(packet->cmd()), "to checker",
-                it->second->getName());
-
-        // select action based on packet command
-        switch (packet->cmd()) {
-        case Command::READ_REQ: //intentional fallthrough
-        case Command::WRITE_REQ:
-            // update checkers if available
-            ok = it->second->send(checkerLocked, packet, nextCheckerTime);
-            break;
-        case Command::READ_RESP: //intentional fallthrough
-        case Command::WRITE_RESP:
-            // update checker
-            ok = it->second->receive(nextCheckerTime, packet,
-                    delay);
-            break;
-        default:
-            ERROR("TrafficProfileManager::updateCheckers unexpected"
-                    "packet command");
+    bool request = false;
+    // select observation type based on packet command
+    switch (packet->cmd()) {
+    case Command::READ_REQ: //intentional fallthrough
+    case Command::WRITE_REQ:
+        request = true;
+        break;
+    case Command::READ_RESP: //intentional fallthrough
+    case Command::WRITE_RESP:
+        request = false;
+        break;
+    default:
+        ERROR("TrafficProfileManager::updateCheckers unexpected"
+                "packet command");
+    }
+
+    // publish once, checkers consume it when the bus is drained
+    observations.push_back(TrafficProfileChecker::Observation {
+        profile, time, packet->size(), delay, request });
+}
+
+void TrafficProfileManager::drainObservations() {
+    if (observations.empty()) {
+        return;
+    }
+    // detach the pending observations: checkers may emit events
+    // whilst consuming them
+    vector<TrafficProfileChecker::Observation> batch;
+    batch.swap(observations);
+
+    // each checker consumes the whole batch in one call
+    for (auto c : checkers) {
+        auto* checker = static_cast<TrafficProfileChecker*>(profiles.at(c));
+        if (checker == nullptr) {
+            continue;
         }
+        LOG("TrafficProfileManager::drainObservations registering",
+                batch.size(), "observations to checker",
+                checker->getName());
 
-        if (!ok) {
-            ERROR("TrafficProfileManager::updateCheckers time", time,
-                    "checker", it->second->getName(), "rejected",
-                    Command_Name(packet->cmd()));
+        if (!checker->observe(batch)) {
+            ERROR("TrafficProfileManager::drainObservations time", time,
+                    "checker", checker->getName(), "rejected requests");
         }
+    }
 
+    // hand the storage back unless new observations were published
+    batch.clear();
+    if (observations.empty()) {
+        observations.swap(batch);
     }
 }
 
@@ -678,8 +1057,10 @@ TrafficProfileManager::send(Packet*& pkt, bool& locked,
         // skip checkers - they do not send packets
         if (!isChecker(pId)) {
             // attempts to send all available packets from a traffic profile
-            auto& p = profiles.at(pId);
-            if (p->send(locked, pkt, next)) {
+            auto* p = profiles[pId];
+            if (profiler.measure(EngineProfiler::SEND, pId, [&] {
+                        return profileSend(p, locked, pkt, next);
+                    }, EngineProfiler::PACKETS_SENT)) {
                 LOG("TrafficProfileManager::send time", time,
                         "got  packet from profile", p->getName(),
                         "timestamp", pkt->time());
@@ -744,6 +1125,8 @@ multimap<string, Packet*> TrafficProfileManager::send(bool& locked,
 
             LOG("TrafficProfileManager::send request received at time",
                     packetTime);
+            profiler.count(EngineProfiler::WAKEUPS, InvalidId<uint64_t>());
+            const uint64_t sentBefore = stats.sent;
             // update current time
             time = packetTime;
             Packet * pkt = nullptr;
@@ -756,17 +1139,21 @@ multimap<string, Packet*> TrafficProfileManager::send(bool& locked,
             if (kronos.isInitialized()) {
                 list<Event> events;
                 // get all Kronos events
-                kronos.get(events);
+                profiler.measure(EngineProfiler::KRONOS_GET,
+                                 InvalidId<uint64_t>(),
+                                 [&] { kronos.get(events); });
                 // parsing events will free ATP slaves response slots
                 for (auto&e : events) {
-                    handle(e);
+                    profiler.measure(EngineProfiler::HANDLE,
+                                     InvalidId<uint64_t>(),
+                                     [&] { return handle(e); });
                 }
             }
 
             // cycle through the active list
             for (auto it = begin(activeList); it != end(activeList); ++it) {
-                auto& p = profiles.at(*it);
-                const uint64_t& pId = p->getId();
+                auto* p = profiles[*it];
+                const uint64_t pId = *it;
                 bool profileLocked = false, sent = false;
                 // attempts to send all available packets from a traffic profile
                 do {
@@ -803,6 +1190,10 @@ multimap<string, Packet*> TrafficProfileManager::send(bool& locked,
                               }
                             }
                         } else {
+                            // resolve the master name of outgoing packets
+                            if (!pkt->has_master_id()) {
+                                pkt->set_master_id(p->getMasterName());
+                            }
                             ret.emplace(make_pair(p->getMasterName(), pkt));
                         }
                     }
@@ -814,6 +1205,8 @@ multimap<string, Packet*> TrafficProfileManager::send(bool& locked,
                 overruns += p->getStats().overruns;
 
             }
+            // checkers consume this tick observations
+            drainObservations();
             // refresh total overruns/underruns
             stats.underruns = underruns;
             stats.overruns = overruns;
@@ -821,6 +1214,8 @@ multimap<string, Packet*> TrafficProfileManager::send(bool& locked,
             if (!nextTimes.empty()) {
                 nextTransmission = nextTimes.top();
             }
+            timeline.record(TimelineRecorder::WAKEUP, 0, packetTime, 0,
+                            stats.sent - sentBefore);
             LOG("TrafficProfileManager::send time", packetTime, "sending",
                     ret.size(), "packets. Underruns", underruns, "Overruns",
                     overruns,"next transmission time", nextTransmission);
@@ -863,13 +1258,17 @@ bool TrafficProfileManager::receive(const uint64_t packetTime, Packet* packet) {
         if (packetTime >= time) {
             double requestTime = time;
             uint64_t pid = 0, next = 0;
+            // checkers consume the previous receive tick observations
+            if (packetTime > time) {
+                drainObservations();
+            }
             // advance clock
             time = packetTime;
             waitedFor = getDestinationProfile(requestTime, pid, packet);
 
             if (!waitedFor) {
                 WARN("TrafficProfileManager::receive unexpected packet "
-                        "for master", packet->master_id(),
+                        "for master", packetMasterName(packet),
                         "UID", packet->uid(),
                         "address", packet->addr());
             } else {
@@ -909,8 +1308,10 @@ bool TrafficProfileManager::receive(const uint64_t packetTime, Packet* packet) {
                     // packet was expected - trace it
                     tracer.trace(packet);
 
-                    if (profiles[pid]->receive(next, packet,
-                                               delay)) {
+                    if (profiler.measure(EngineProfiler::RECEIVE, pid, [&] {
+                                return profileReceive(profiles[pid], next,
+                                                      packet, delay);
+                            }, EngineProfiler::PACKETS_RECEIVED)) {
                       // update received packets counter and time
                       stats.receive(packetTime, packet->size(), delay);
                       received = true;
@@ -919,7 +1320,7 @@ bool TrafficProfileManager::receive(const uint64_t packetTime, Packet* packet) {
                       // delete response packet here
                       delete packet;
                     } else if (kronosEnabled &&
-                          isInternalMaster(packet->master_id())) {
+                          isInternalMaster(packet)) {
                         // Kronos init check
                         if (!kronos.isInitialized()) {
                           initKronos();
@@ -961,6 +1362,15 @@ bool TrafficProfileManager::receive(const uint64_t packetTime, Packet* packet) {
     return received;
 }
 
+TrafficProfileManager::Subscribers&
+TrafficProfileManager::subscribers(const uint64_t id) {
+    if (id >= dispatchTable.size()) {
+        dispatchTable.resize(id + 1);
+        subscriptions.resize(id + 1, 0);
+    }
+    return dispatchTable[id];
+}
+
 void TrafficProfileManager::subscribe(const uint64_t profile, const Event& ev) {
     if (ev.action == Event::TRIGGERED) {
         ERROR(
@@ -973,9 +1383,14 @@ void TrafficProfileManager::subscribe(const uint64_t profile, const Event& ev) {
         activeList.push_back(profile);
     }
 
-    // add the profile id to the set of profiles waiting for event <ev>
+    // add the profile id to the profiles waiting for event <ev>
     LOG("TrafficProfileManager::subscribe event", ev, "profile", profile);
-    waitEventMap[ev.id][ev].insert(profile);
+    auto& subs = subscribers(ev.id)[ev.type];
+    auto it = lower_bound(subs.begin(), subs.end(), profile);
+    if (it == subs.end() || *it != profile) {
+        subs.insert(it, profile);
+        subscriptions[ev.id]++;
+    }
 }
 
 void TrafficProfileManager::event(const Event& ev) {
@@ -983,6 +1398,8 @@ void TrafficProfileManager::event(const Event& ev) {
         ERROR("TrafficProfileManager::event "
                 "attempted trigger of a subscription event", ev);
     }
+    profiler.count(EngineProfiler::EVENTS, ev.id);
+    timeline.record(TimelineRecorder::EVENT, ev.id, ev.time, ev.type);
 
     // // special handling in case of ACTIVATION events
     if (ev.type==Event::ACTIVATION) {
@@ -993,7 +1410,7 @@ void TrafficProfileManager::event(const Event& ev) {
 
     // special handling in case of TERMINATION events
     if (ev.type == Event::TERMINATION) {
-        const string mName = profiles.at(ev.id)->getMasterName();
+        const string mName = instantiate(ev.id)->getMasterName();
         const uint64_t mId = profiles.at(ev.id)->getMasterId();
 
         if (0 == nonTerminatedProfiles[mId]--) {
@@ -1006,40 +1423,69 @@ void TrafficProfileManager::event(const Event& ev) {
                 "event", ev, nonTerminatedProfiles[mId],
                 "profiles active for master", mName);
 
-        // alert all other profiles waiting for events related to the terminated profile
-        for (auto&w : waitEventMap[ev.id]) {
-            for (auto&p : w.second) {
-                LOG("TrafficProfileManager::event profile",
-                        profiles.at(p)->getName(), "receives TERMINATION of",
-                        ev.id, "due to waited event", w.first);
-                profiles.at(p)->receiveEvent(ev);
+        // update the termination counters of the streams
+        streamTopology.leafTerminated(ev.id);
+
+        if (ev.id < dispatchTable.size() && subscriptions[ev.id] > 0) {
+            ++dispatched;
+            // checkers must consume pending observations
+            // before being alerted of a termination
+            drainObservations();
+            // detach the subscribers, their storage is handed back below
+            Subscribers waiting;
+            waiting.swap(dispatchTable[ev.id]);
+
+            // instantiate deferred profiles before alerting them
+            if (!deferredProfiles.empty()) {
+                for (auto& w : waiting) {
+                    for (auto p : w) {
+                        if (deferredProfiles.count(p) > 0) {
+                            instantiate(p);
+                        }
+                    }
+                }
+            }
+
+            // alert all other profiles waiting for events related to the terminated profile
+            for (uint64_t t = 0; t < Event::N_EVENTS; ++t) {
+                for (auto p : waiting[t]) {
+                    LOG("TrafficProfileManager::event profile",
+                            profiles.at(p)->getName(), "receives TERMINATION of",
+                            ev.id, "due to waited event",
+                            Event::text[t]);
+                    profiles.at(p)->receiveEvent(ev);
+                }
+                waiting[t].clear();
             }
+            // remove all events related to the terminated profile
+            dispatchTable[ev.id].swap(waiting);
+            subscriptions[ev.id] = 0;
         }
-        // remove all events related to the terminated profile
-        waitEventMap.erase(ev.id);
-    } else if (waitEventMap.find(ev.id) != waitEventMap.end()
-            && waitEventMap.at(ev.id).find(ev)
-            != waitEventMap.at(ev.id).end()) {
+    } else if (ev.id < dispatchTable.size()
+            && !dispatchTable[ev.id][ev.type].empty()) {
         LOG("TrafficProfileManager::event broadcasting event", ev);
+        ++dispatched;
 
-        // propagates the event to all profiles listening for it
-        list<pair<uint64_t, Event>> broadcastList;
-
-        for (auto& profile : waitEventMap[ev.id][ev]) {
-            broadcastList.push_back(make_pair(profile,ev));
-        }
-        // delete event from event map
-        waitEventMap.at(ev.id).erase(ev);
-        // delete id if last event served
-        if (waitEventMap.at(ev.id).empty()) {
-            waitEventMap.erase(ev.id);
-        }
+        // propagates the event to all profiles listening for it,
+        // removing it from the dispatch table
+        vector<uint64_t> broadcast;
+        broadcast.swap(dispatchTable[ev.id][ev.type]);
+        subscriptions[ev.id] -= broadcast.size();
 
         // notify profiles in the broadcast list
-        for (auto&l : broadcastList) {
-            profiles.at(l.first)->receiveEvent(l.second);
+        for (auto p : broadcast) {
+            if (role(p) == TrafficProfileDescriptor::CHECKER) {
+                drainObservations();
+            }
+            instantiate(p)->receiveEvent(ev);
         }
 
+        // hand the storage back unless re-subscribed whilst notifying
+        broadcast.clear();
+        auto& subs = dispatchTable[ev.id][ev.type];
+        if (subs.empty()) {
+            subs.swap(broadcast);
+        }
     } else {
         LOG("TrafficProfileManager::event no profile subscribed to event", ev);
     }
@@ -1169,8 +1615,6 @@ bool TrafficProfileManager::toInternalSlave(uint64_t& dest, const Packet* pkt) c
     if (packetType(pkt->cmd())==REQUEST) {
         // store packet address
         const auto& address = pkt->addr();
-        // store packet master
-        const auto& master = pkt->master_id();
         //1) test the packet address against registered ranges -> get a slave id
         const auto lb = slaveAddressRanges.lower_bound(address);
         // low end of range found which could match the address
@@ -1182,9 +1626,9 @@ bool TrafficProfileManager::toInternalSlave(uint64_t& dest, const Packet* pkt) c
         }
 
         if (!match) {
-            try {
-                // lookup internal numeric masterId
-                const auto masterId = masterMap.at(master);
+            // lookup internal numeric masterId
+            const auto masterId = packetMaster(pkt);
+            if (isValid(masterId)) {
                 //2) test the packet master against master to slave mapping -> get a slave id
                 // look for master/slave association
                 const auto ms = masterSlaveMap.find(masterId);
@@ -1193,16 +1637,16 @@ bool TrafficProfileManager::toInternalSlave(uint64_t& dest, const Packet* pkt) c
                     match = true;
                     dest = ms->second;
                 }
-            } catch (out_of_range& oor) {
+            } else {
                 LOG("TrafficProfileManager::toInternalSlave no internal master "
-                        "matches", master);
+                        "matches", pkt->master_id());
             }
         }
 
         //no match on both 1 or 2 -> not associated to an internal slave
         if (match) {
             LOG("TrafficProfileManager::toInternalSlave resolved",
-                    "packet from master", master,"address",
+                    "packet from master", packetMasterName(pkt),"address",
                     Utilities::toHex(address),
                     "to internal slave",profiles.at(dest)->getName());
         }
@@ -1227,10 +1671,6 @@ TrafficProfileManager::getMasterSlaves() const {
     return ret;
 }
 
-bool TrafficProfileManager::isInternalMaster(const string m) const {
-    return (masterMap.count(m)>0);
-}
-
 void TrafficProfileManager::autoKronosConfiguration() {
     /*
      * Max data in-flight per slave is
@@ -1330,7 +1770,9 @@ bool TrafficProfileManager::handle(const Event& ev) {
                     double requestTime = .0;
                     uint64_t dst = 0;
                     tie(dst, requestTime) = waitedRequestUidMap.at(ev.id);
-                    route(buffer.at(ev.id), nullptr, &dst);
+                    // route erases the buffer entry on success
+                    Packet* pkt = buffer.at(ev.id);
+                    route(pkt, nullptr, &dst);
                 } catch (out_of_range& oor) {
                     ERROR("TrafficProfileManager::handle unable to find "
                             "route for packet UID", oor.what());
@@ -1352,6 +1794,13 @@ bool TrafficProfileManager::handle(const Event& ev) {
 }
 
 bool TrafficProfileManager::route(Packet*& pkt, const uint64_t* src, const uint64_t* dst) {
+    return profiler.measure(EngineProfiler::ROUTE,
+                            (src != nullptr ? *src : InvalidId<uint64_t>()),
+                            [&] { return routePacket(pkt, src, dst); });
+}
+
+bool TrafficProfileManager::routePacket(Packet*& pkt, const uint64_t* src,
+                                        const uint64_t* dst) {
 
     // Initialise returned values
     bool routed = false;
@@ -1440,19 +1889,37 @@ void TrafficProfileManager::tick() {
 }
 
 void TrafficProfileManager::loop() {
+    loopUntil(numeric_limits<uint64_t>::max());
+}
+
+bool TrafficProfileManager::loopUntil(const uint64_t until) {
     if (kronosEnabled) {
         // check if Kronos needs to be initialized
         if (!kronos.isInitialized()){
             initKronos();
         }
 
-        uint64_t nextTick = 0;
+        // a suspended loop resumes from the next event
+        uint64_t nextTick = (suspended ? kronos.next() : 0);
+        suspended = false;
         do {
+            if (nextTick > until) {
+                LOG("TrafficProfileManager::loopUntil suspended at time",
+                        time, "next", nextTick);
+                suspended = true;
+                break;
+            }
             // set ATP time to Kronos next event
             setTime(nextTick);
             LOG("TrafficProfileManager::loop time",time);
             // advance time
             tick();
+            // skip sampled intervals, or advance periodic regimes in bulk
+            if (sampler.isEnabled()) {
+                sampler.step();
+            } else {
+                fastForward.step();
+            }
             // get next tick time from Kronos
             nextTick = kronos.next();
             LOG("TrafficProfileManager::loop end of loop time",time,"next",nextTick);
@@ -1460,13 +1927,220 @@ void TrafficProfileManager::loop() {
     } else {
         WARN("TrafficProfileManager::loop - Kronos not enabled, exiting main event loop");
     }
+    return suspended;
+}
+
+void TrafficProfileManager::walk(StateWalker& w) {
+    if (tracer.isEnabled() || timeline.isEnabled() ||
+        profiler.isEnabled() || !checkers.empty() ||
+        !observations.empty() || !kronos.isInitialized()) {
+        w.reject();
+        return;
+    }
+    // time first: later walks may depend on the advanced time
+    w(time, StateWalker::TIME);
+    stats.walk(w);
+    w(forwardDeclaredProfiles);
+    for (auto* p : profiles) {
+        bool deferred = (p == nullptr);
+        w(deferred);
+        if (!deferred) {
+            p->walk(w);
+        }
+    }
+    w.size(deferredProfiles);
+    w.size(nonTerminatedProfiles);
+    for (auto& n : nonTerminatedProfiles) {
+        w(n.second);
+    }
+    w.size(activeList);
+    for (auto& a : activeList) {
+        w(a);
+    }
+    tagger.walk(w);
+    w.size(dispatchTable);
+    for (auto& d : dispatchTable) {
+        for (auto& s : d) {
+            w.size(s);
+            for (auto& pId : s) {
+                w(pId);
+            }
+        }
+    }
+    w.size(subscriptions);
+    for (auto& s : subscriptions) {
+        w(s);
+    }
+    w(streamCacheValid);
+    for (auto* waited : { &waitedResponseUidMap, &waitedRequestUidMap }) {
+        w.uidMap(*waited, [&w](pair<uint64_t, uint64_t>& e) {
+            w(e.first);
+            w(e.second, StateWalker::TIME);
+        });
+    }
+    w.uidMap(buffer, [&w](Packet*& p) { w(*p); });
+    kronos.walk(w);
+}
+
+void TrafficProfileManager::serialize(Snapshot& s) {
+    if (!s.isValid()) {
+        return;
+    }
+    // the snapshot profiles and masters must match the loaded ones
+    vector<string> names(profiles.size());
+    for (auto& p : profileMap) {
+        if (p.second < names.size()) {
+            names[p.second] = p.first;
+        }
+    }
+    vector<string> snapshotNames(names), snapshotMasters(masters);
+    s(snapshotNames);
+    s(snapshotMasters);
+    if (snapshotNames != names || snapshotMasters != masters) {
+        WARN("TrafficProfileManager::serialize snapshot profiles or masters "
+             "don't match the loaded configuration");
+        s.invalidate();
+        return;
+    }
+    // deferred profiles instantiated before the snapshot
+    vector<uint8_t> instantiated(profiles.size());
+    for (uint64_t i = 0; i < profiles.size(); ++i) {
+        instantiated[i] = (profiles[i] != nullptr);
+    }
+    s(instantiated);
+    if (s.restoring()) {
+        for (uint64_t i = 0; i < profiles.size() && s.isValid(); ++i) {
+            if (instantiated[i] && profiles[i] == nullptr) {
+                instantiate(i);
+            } else if (!instantiated[i] && profiles[i] != nullptr) {
+                WARN("TrafficProfileManager::serialize profile", names[i],
+                     "was not instantiated in the snapshot");
+                s.invalidate();
+            }
+        }
+    }
+
+    s(time);
+    stats.serialize(s);
+    s(forwardDeclaredProfiles);
+    for (auto* p : profiles) {
+        if (p != nullptr && s.isValid()) {
+            p->serialize(s);
+        }
+    }
+    s(nonTerminatedProfiles);
+    s(activeList);
+    tagger.serialize(s);
+    s(dispatchTable);
+    s(subscriptions);
+    const uint64_t n = s.size(observations.size());
+    if (s.restoring()) {
+        observations.resize(n);
+    }
+    for (auto& o : observations) {
+        s(o.profile);
+        s(o.time);
+        s(o.size);
+        s(o.delay);
+        s(o.request);
+    }
+    s(waitedResponseUidMap);
+    s(waitedRequestUidMap);
+    if (s.restoring()) {
+        for (auto& b : buffer) {
+            delete b.second;
+        }
+        buffer.clear();
+    }
+    s(buffer);
+    vector<uint64_t> next;
+    for (auto q = nextTimes; !q.empty(); q.pop()) {
+        next.push_back(q.top());
+    }
+    s(next);
+    if (s.restoring()) {
+        nextTimes = NextTimesPq(next.begin(), next.end());
+    }
+    s(suspended);
+    bool kronosInitialized = kronos.isInitialized();
+    s(kronosInitialized);
+    if (s.restoring()) {
+        if (!kronosInitialized) {
+            kronos.reset();
+        } else if (!kronos.isInitialized()) {
+            initKronos();
+        }
+    }
+    kronos.serialize(s);
+    // the streams termination counters follow the restored profiles
+    if (s.restoring() && s.isValid()) {
+        vector<bool> terminated(profiles.size(), false);
+        for (uint64_t i = 0; i < profiles.size(); ++i) {
+            terminated[i] = (profiles[i] != nullptr &&
+                             profiles[i]->isTerminated());
+        }
+        streamTopology.recount(terminated);
+    }
+}
+
+string TrafficProfileManager::saveSnapshot() {
+    Snapshot s;
+    serialize(s);
+    LOG("TrafficProfileManager::saveSnapshot saved", s.getData().size(),
+        "bytes at time", time);
+    return s.getData();
+}
+
+bool TrafficProfileManager::restoreSnapshot(const string& data) {
+    // the state is restored in place: back it up, deferred profiles
+    // included, to roll back a failed restore
+    Snapshot backup;
+    serialize(backup);
+    const auto deferred = deferredProfiles;
+    Snapshot s(data);
+    serialize(s);
+    if (!s.isValid() || !s.atEnd()) {
+        WARN("TrafficProfileManager::restoreSnapshot unable to restore the "
+             "snapshot, rolling back");
+        // defer again the profiles instantiated by the failed restore
+        for (auto& d : deferred) {
+            delete profiles.at(d.first);
+            profiles.at(d.first) = nullptr;
+        }
+        deferredProfiles = deferred;
+        Snapshot rollback(backup.getData());
+        serialize(rollback);
+        if (!rollback.isValid() || !rollback.atEnd()) {
+            ERROR("TrafficProfileManager::restoreSnapshot unable to roll "
+                  "back the engine state");
+        }
+        return false;
+    }
+    // derived state is rebuilt on demand
+    streamCacheValid = false;
+    fastForward.reset();
+    sampler.reset();
+    LOG("TrafficProfileManager::restoreSnapshot restored", data.size(),
+        "bytes at time", time);
+    return true;
 }
 
 uint64_t TrafficProfileManager::getOt(const uint64_t pId) const {
-    return profiles.at(pId)->getOt();
+    const auto* p = profiles.at(pId);
+    return (p != nullptr ? p->getOt() : 0);
 }
 
-const list<pair<uint64_t, bool>>&
+void TrafficProfileManager::joinStream(const uint64_t node,
+                                       const uint64_t root) {
+    auto deferred = deferredProfiles.find(node);
+    if (deferred != deferredProfiles.end()) {
+        deferred->second.streamId = root;
+    } else {
+        profiles.at(node)->addToStream(root);
+    }
+}
+
+StreamTopology::Stream
 TrafficProfileManager::getStream(const uint64_t root) {
     // validate profile id
     if (root >= profiles.size()) {
@@ -1474,9 +2148,9 @@ TrafficProfileManager::getStream(const uint64_t root) {
                 "unknown root profile ID", root);
     }
 
-    if (streamCache.find(root) == streamCache.end()) {
+    if (!streamTopology.has(root)) {
         LOG("TrafficProfileManager::getStream root building stream",
-                    profiles.at(root)->getName());
+                    profileName(root));
 
         // track visited nodes across the recursion
         set<uint64_t> visited;
@@ -1484,8 +2158,11 @@ TrafficProfileManager::getStream(const uint64_t root) {
         queue<uint64_t> recursion;
         recursion.push(root);
         visited.insert(root);
-        // stream to be returned (square brackets create the entry)
-        auto& stream = streamCache[root];
+        // stream nodes and leaf flags to be compiled
+        vector<uint64_t> nodes;
+        vector<bool> leafFlags;
+        // leaves which terminated before the stream was compiled
+        uint64_t terminated = 0;
 
         // recursion stack - avoids stack overflow for large profile streams
         while (!recursion.empty()) {
@@ -1493,55 +2170,53 @@ TrafficProfileManager::getStream(const uint64_t root) {
             // remove current element
             recursion.pop();
             // parse leaves
-            auto events = waitEventMap.find(node);
             bool isLeaf = true;
 
-            if (events!= waitEventMap.end()) {
-                // access the waitEventMap from the root
-                for (auto& leaves: events->second) {
-                    // follow TERMINATION event chains
-                    if (leaves.first.type == Event::TERMINATION) {
-                        /* this is a set of profile IDs waiting on
-                         * the root TERMINATION
-                         */
-                        // not a leaf node
-                        isLeaf = false;
-
-                        for (auto& leaf: leaves.second) {
-                            // if not visited, start recursion
-                            if (visited.count(leaf)==0) {
-                                LOG("TrafficProfileManager::getStream "
-                                    "recursion root",
-                                        profiles.at(node)->getName(),
-                                        "leaf",profiles.at(leaf)->getName());
-                                // recursion on this leaf
-                                recursion.push(leaf);
-                                // add leaf to visited nodes
-                                visited.insert(leaf);
-                            } else {
-                                LOG("TrafficProfileManager::getStream "
-                                    "recursion root",
-                                        profiles.at(node)->getName(),
-                                        "skipping visited leaf",
-                                        profiles.at(leaf)->getName());
-                            }
-                        }
+            // follow TERMINATION event chains
+            if (node < dispatchTable.size() &&
+                    !dispatchTable[node][Event::TERMINATION].empty()) {
+                /* these are the profile IDs waiting on
+                 * the node TERMINATION
+                 */
+                // not a leaf node
+                isLeaf = false;
+
+                for (auto leaf: dispatchTable[node][Event::TERMINATION]) {
+                    // if not visited, start recursion
+                    if (visited.count(leaf)==0) {
+                        LOG("TrafficProfileManager::getStream "
+                            "recursion root",
+                                profileName(node),
+                                "leaf",profileName(leaf));
+                        // recursion on this leaf
+                        recursion.push(leaf);
+                        // add leaf to visited nodes
+                        visited.insert(leaf);
+                    } else {
+                        LOG("TrafficProfileManager::getStream "
+                            "recursion root",
+                                profileName(node),
+                                "skipping visited leaf",
+                                profileName(leaf));
                     }
                 }
             }
             // add the Traffic Profile to the stream
-            profiles.at(node)->addToStream(root);
-            // add current node to nodes to be returned
-            stream.push_back(make_pair(node, isLeaf));
-            if (isLeaf) {
-                streamLeavesCache[root].push_back(node);
+            joinStream(node, root);
+            // add current node to nodes to be compiled
+            nodes.push_back(node);
+            leafFlags.push_back(isLeaf);
+            if (isLeaf && profiles.at(node) != nullptr &&
+                    profiles.at(node)->isTerminated()) {
+                terminated++;
             }
         }
+        streamTopology.add(nodes, leafFlags, terminated);
     } else {
         LOG("TrafficProfileManager::getStream cache hit for root",
-                profiles.at(root)->getName());
+                profileName(root));
     }
-    return streamCache.at(root);
+    return streamTopology.stream(root);
 }
 
 uint64_t TrafficProfileManager::cloneStream(const uint64_t root,
@@ -1560,43 +2235,52 @@ uint64_t TrafficProfileManager::cloneStream(const uint64_t root,
             "Unknown Master ID",master_id);
   }
   LOG("TrafficProfileManager::cloneStream cloning",
-      profiles.at(root)->getName());
+      profileName(root));
 
   // gets/sets the number of streams cloned from this root (0 if none)
   clonedStreams[root].first++;
 
   const uint64_t cloneNum { clonedStreams.at(root).first };
-  for (auto& p : getStream(root)) {
-    // profile pointer
-    auto* from = getProfile(p.first);
-    const auto &ts = timeScaleFactor.at(p.first);
-    // build profile from source config
-    configureProfile(*from->getConfig(), ts, false, cloneNum, master_id);
-    // store clone root
-    if (p.first == root) {
-      string profName { from->getName() };
-      profName.append(TrafficProfileDescriptor::Name::CloneSuffix)
-              .append(to_string(cloneNum - 1));
-      cloneRoot = profileId(profName);
-      clonedStreams[root].second.push_back(cloneRoot);
-      streamCloneToOrigin.emplace(cloneRoot, root);
-    }
+  const auto stream = getStream(root);
+  // clone profile IDs, in the same order as the origin stream nodes
+  vector<uint64_t> cloneIds;
+  cloneIds.reserve(stream.size());
+  for (auto node : stream) {
+    /* clones share the origin (immutable) profile configuration,
+     * only their mutable state is allocated - deferred profiles
+     * are cloned deferred and allocate nothing until activated
+     */
+    const Profile* from = profileConfig(node);
+    const auto &ts = timeScaleFactor.at(node);
+    cloneIds.push_back(configureProfile(*from, ts, false,
+                                        cloneNum, master_id));
   }
 
-  // register checkers for cloned profiles
-  for (const auto &check : checkedByMap)
-    getProfile(check.first)->registerChecker(check.second->getId());
-
   if (forwardDeclaredProfiles > 0) {
     // check if clones have been left pending by the clonesStream process
     // if that happened, it means wait_for paths have not been followed
     // (can happen if the requested stream to be cloned is multi-rooted)
-    cloneRoot = InvalidId<uint64_t>();
     forwardDeclaredProfiles = 0;
     ERROR("TrafficProfileManager::",__func__,"Multi-Root clones unsupported");
-  } else {
-    // build the new Stream
-    getStream(cloneRoot);
+    return cloneRoot;
+  }
+
+  // the origin root is always the first stream node
+  cloneRoot = cloneIds.front();
+  clonedStreams[root].second.push_back(cloneRoot);
+  streamCloneToOrigin.emplace(cloneRoot, root);
+
+  // the clone shares the origin topology: remap it rather than rebuild it
+  streamTopology.clone(root, cloneIds);
+  for (auto node : cloneIds) {
+    joinStream(node, cloneRoot);
+    // register checkers for this cloned profile only
+    if (profiles.at(node) != nullptr) {
+      auto range = checkedByMap.equal_range(node);
+      for (auto c = range.first; c != range.second; ++c) {
+        profiles.at(node)->registerChecker(c->second->getId());
+      }
+    }
   }
 
   return cloneRoot;
@@ -1613,7 +2297,7 @@ uint64_t TrafficProfileManager::uniqueStream(const uint64_t root,
       ERROR("TrafficProfileManager::",__func__,
             "Unknown Master ID",master_id);
   } else {
-    const string &master { getProfile(root)->getConfig()->master_id() };
+    const string &master { profileConfig(root)->master_id() };
     if (clonedStreams.find(root) == clonedStreams.end() &&
         (!isValid(master_id) || master_id == masterId(master))) {
       // first use of this stream
@@ -1632,15 +2316,16 @@ uint64_t TrafficProfileManager::addressStreamReconfigure (
         const Profile::Type type) {
 
     // acquire stream nodes
-    const auto& stream = getStream(root);
+    const auto stream = getStream(root);
     // accumulates range reconfiguration result
     uint64_t currentRange = 0;
     // keeps track of the current address base
     uint64_t currentBase = base;
     // process the stream
-    for (auto& node : stream) {
+    for (auto node : stream) {
 
-        auto& profile = profiles.at(node.first);
+        // reconfiguration needs the profile descriptor
+        auto* profile = instantiate(node);
 
         LOG("TrafficProfileManager::addressStreamReconfigure node",
                 profile->getName(), "base", Utilities::toHex(currentBase),
@@ -1683,12 +2368,14 @@ uint64_t TrafficProfileManager::addressStreamReconfigure (
 }
 
 void TrafficProfileManager::streamReset(const uint64_t root) {
-    LOG("TrafficProfileManager::streamReset root",profiles.at(root)->getName());
+    LOG("TrafficProfileManager::streamReset root",profileName(root));
     // stream nodes
-    const auto& stream = getStream(root);
+    const auto stream = getStream(root);
     // process the stream
-    for (auto& node : stream) {
-        auto& profile = profiles.at(node.first);
+    for (auto node : stream) {
+        auto& profile = profiles.at(node);
+        // deferred profiles are still in their initial status
+        if (profile == nullptr) continue;
         LOG("TrafficProfileManager::streamReset resetting node",
                 profile->getName());
         profile->reset();
@@ -1697,24 +2384,13 @@ void TrafficProfileManager::streamReset(const uint64_t root) {
 
 bool
 TrafficProfileManager::streamTerminated(const uint64_t root) {
-    LOG("TrafficProfileManager::streamTerminated root",
-            profiles.at(root)->getName());
-
-    bool terminated = true;
     // acquire/generate stream nodes
     getStream(root);
-    const auto& streamLeaves = streamLeavesCache.at(root);
-    // test if all the leaves of the stream have terminated
-    for (auto& l: streamLeaves) {
+    const bool terminated = streamTopology.terminated(root);
 
-        terminated &= profiles.at(l)->isTerminated();
-
-        LOG("TrafficProfileManager::streamTerminated tested leaf",
-                        profiles.at(l)->getName(),
-                        profiles.at(l)->isTerminated()?
-                                "terminated":"not terminated");
+    LOG("TrafficProfileManager::streamTerminated root",
+            profileName(root), terminated? "terminated":"not terminated");
 
-    }
     return terminated;
 }
 
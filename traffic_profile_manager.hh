@@ -12,6 +12,7 @@
 #define __AMBA_TRAFFIC_PROFILE_MANAGER_HH__
 
 // Traffic Profile includes
+#include <array>
 #include <iostream>
 #include <fstream>
 #include <deque>
@@ -32,12 +33,20 @@
 #include "stats.hh"
 #include "types.hh"
 #include "kronos.hh"
+#include "engine_profiler.hh"
+#include "timeline_recorder.hh"
+#include "fast_forward.hh"
+#include "sampler.hh"
+#include "analytical_model.hh"
+#include "snapshot.hh"
+#include "stream_topology.hh"
+#include "traffic_profile_desc.hh"
+#include "traffic_profile_checker.hh"
+#include "rate_controller.hh"
 
 using namespace std;
 //!\brief All ATP code is enclosed in this namespace
 namespace TrafficProfiles {
-// forward declaration
-class TrafficProfileDescriptor;
 
 /*!
  *\brief AMBA Traffic Profile Manager
@@ -60,6 +69,8 @@ protected:
 
     // declare test class as friend
     friend class TestAtp;
+    // declare benchmark class as friend
+    friend class Bench;
 
     //! default time resolution used
     static const Configuration::TimeUnit defaultTimeResolution;
@@ -91,6 +102,9 @@ protected:
      */
     bool trackerLatency;
 
+    //! enables the response latency histograms of the ATP Masters
+    bool latencyHistogram;
+
     //! Kronos enable flag
     bool kronosEnabled;
 
@@ -139,6 +153,47 @@ protected:
     //! Traffic Profiles descriptor pointers - keep track of the Traffic Profiles evolution
     vector <TrafficProfileDescriptor*> profiles;
 
+    /*!
+     *\brief Deferred Traffic Profile
+     *
+     * Holds what is needed to instantiate a Traffic Profile
+     * descriptor upon its first activation
+     */
+    struct DeferredProfile {
+        //! profile configuration object (owned by the caller)
+        const Profile* config;
+        //! stream clone number (0=original)
+        uint64_t cloneNum;
+        //! ID of the master the profile has been registered to
+        uint64_t masterId;
+        //! ID of the stream the profile has been added to
+        uint64_t streamId;
+    };
+
+    /*!
+     * Lazy profiles mode: profiles which only wait for other
+     * profiles termination are instantiated on first activation
+     */
+    bool lazyProfiles;
+
+    /*!
+     * Offered load scale factor, applied to the
+     * configured FIFO rate of ATP Masters
+     */
+    double rateScale;
+
+    //! Number of profiles configured without a name, to name them
+    uint64_t anonymousProfiles;
+
+    /*!
+     *\brief Deferred profiles map
+     *
+     * Profile ID -> data needed to instantiate it. The slot in
+     * the profiles vector of a deferred profile is nullptr, whilst
+     * its waited for events are already recorded in the dispatchTable
+     */
+    unordered_map<uint64_t, DeferredProfile> deferredProfiles;
+
     /*!\brief Traffic Profiles checkers map
      *
      * Keeps track of which Traffic Profile are monitored by checkers
@@ -151,6 +206,17 @@ protected:
      */
     set<uint64_t> checkers;
 
+    /*!\brief Checkers observation bus
+     *
+     * Packets sent and received by checked profiles are published
+     * here once, regardless of how many checkers observe them, and
+     * are consumed in batches by the checkers in publication order
+     */
+    vector<TrafficProfileChecker::Observation> observations;
+
+    //! checked profile ID -> checkers observing it
+    vector<vector<TrafficProfileChecker*>> observers;
+
     /*! Map of configured Master names to Master IDs
      */
     unordered_map<string, uint64_t> masterMap;
@@ -197,11 +263,8 @@ protected:
     //! hash map profile name -> profile id
     unordered_map<string, uint64_t> profileMap;
 
-    //! stream cache - map of profile root id -> profiles linked by
-    // TERMINATION event, flag which indicates leaves
-    map<uint64_t, list<pair<uint64_t, bool>>> streamCache;
-    //! stream leaves cache - map of profile root id -> leaves of cache
-    map<uint64_t, list<uint64_t>> streamLeavesCache;
+    //! compiled streams - profiles linked by TERMINATION events, per root
+    StreamTopology streamTopology;
 
     //! maps stream root id to number of cloned instances of streams,
     // list of clone roots
@@ -218,12 +281,39 @@ protected:
     //! hash map to record requests waited for by profiles when UID routing is used: UID -> (profile, time)
     map<uint64_t, pair<uint64_t,uint64_t>> waitedRequestUidMap;
 
-    //! hash map event waited for Event id -> Event -> profiles waiting for it
-    map<uint64_t, unordered_map<Event, set <uint64_t>>> waitEventMap;
+    //! per event type profiles subscribed to an event source, in ascending order
+    typedef array<vector<uint64_t>, Event::N_EVENTS> Subscribers;
+
+    /*!
+     *\brief Compiled event dispatch table
+     *
+     * Event source ID -> event type -> profiles subscribed to it.
+     * Event sources are profiles, hence the table is dense and
+     * indexed by profile ID
+     */
+    vector<Subscribers> dispatchTable;
+
+    //! Event source ID -> number of subscriptions to its events
+    vector<uint64_t> subscriptions;
+
+    //! number of events delivered to subscribed profiles
+    uint64_t dispatched;
 
     //! Kronos
     Kronos kronos;
 
+    //! Engine self-profiler
+    EngineProfiler profiler;
+
+    //! Engine activity timeline recorder
+    TimelineRecorder timeline;
+
+    //! Engine time fast-forward
+    FastForward fastForward;
+
+    //! Engine statistical sampling
+    Sampler sampler;
+
     /*!
      *\brief Packets buffer
      * Stores packets rescheduled for transmission,
@@ -235,6 +325,14 @@ protected:
     //! Slaves set - lists all slaves profile IDs
     set<uint64_t> slaves;
 
+    /*!
+     *\brief Profile ID -> profile role
+     *
+     * Dense array the engine loops use to dispatch
+     * statically to the profile concrete type
+     */
+    vector<TrafficProfileDescriptor::Role> roles;
+
     /*!
      *\brief Master to slave map
      * Associates one master ID to one or more slave IDs
@@ -257,6 +355,9 @@ protected:
     //! next profile transmission times priority queue, sorted in ascending order
     NextTimesPq nextTimes;
 
+    //! true if the event loop has been suspended before completion
+    bool suspended;
+
     /*! Creates TrafficProfileDescriptors from a configuration object
      *\param toLoad the protocol buffer configuration object
      */
@@ -288,8 +389,9 @@ protected:
      *\param overwrite if set, and a profile with the same name is found, replaces it
      *\param clone_num (Optional) Stream Clone number (0=original)
      *\param master_id (Optional) Associated Master ID
+     *\return the configured profile ID
      */
-    void configureProfile(const Profile&,
+    uint64_t configureProfile(const Profile&,
                           const pair<uint64_t, uint64_t> = { 1, 1 },
                           bool overwrite=false, const uint64_t=0,
                           const uint64_t=InvalidId<uint64_t>());
@@ -306,11 +408,80 @@ protected:
     void createProfile(const uint64_t, const Profile&,
                        const uint64_t=0, const uint64_t=InvalidId<uint64_t>());
 
+    /*!
+     * Registers a non-slave profile to its master
+     *\param id traffic profile id
+     *\param name traffic profile name
+     *\param from the Profile configuration object
+     *\param master_id (Optional) Associated Master ID
+     *\return the ID of the master the profile was registered to
+     */
+    uint64_t registerToMaster(const uint64_t, const string&,
+                              const Profile&, const uint64_t);
+
+    /*!
+     * Checks whether a profile instantiation can be deferred
+     * to its first activation, that is if it is a master or delay
+     * profile and it only waits for other profiles termination
+     *\param from the Profile configuration object
+     *\return true if the profile instantiation can be deferred
+     */
+    bool isDeferrable(const Profile&) const;
+
+    /*!
+     * Registers a profile for deferred instantiation: its
+     * waited for TERMINATION events are subscribed in its place
+     *\param id traffic profile id
+     *\param from the Profile configuration object
+     *\param clone_num (Optional) Stream Clone number (0=original)
+     *\param master_id (Optional) Associated Master ID
+     */
+    void deferProfile(const uint64_t, const Profile&,
+                      const uint64_t=0, const uint64_t=InvalidId<uint64_t>());
+
+    /*!
+     * Returns a profile descriptor, instantiating it
+     * first if its creation was deferred
+     *\param id traffic profile id
+     *\return a pointer to the traffic profile descriptor
+     */
+    TrafficProfileDescriptor* instantiate(const uint64_t);
+
+    /*!
+     * Saves or restores the whole engine runtime state. When restoring,
+     * the snapshot profiles and masters must match the loaded ones
+     *\param s the snapshot
+     */
+    void serialize(Snapshot&);
+
+    /*!
+     * Adds a profile to a stream, deferred profiles
+     * join it when instantiated
+     *\param node traffic profile id
+     *\param root stream root profile id
+     */
+    void joinStream(const uint64_t, const uint64_t);
+
+    /*!
+     * Returns the configuration object of a profile, instantiated or not
+     *\param id traffic profile id
+     *\return a pointer to the profile configuration object
+     */
+    const Profile* profileConfig(const uint64_t) const;
+
+    /*!
+     * Returns the statistics of a profile, or empty statistics
+     * if the profile has not been instantiated yet
+     *\param id traffic profile id
+     *\return the profile statistics
+     */
+    Stats profileStats(const uint64_t) const;
+
     /*!
      *\brief Update checkers
      *
-     * Updates ATP checkers assigned to an ATP Profile
-     * by passing them a packet request or response
+     * Publishes a packet request or response of an ATP Profile
+     * on the observation bus, if the profile has checkers
      *
      *\param profile the ATP profile ID
      *\param packet a pointer to the ATP Packet sent/received
@@ -318,13 +489,23 @@ protected:
      */
     void updateCheckers(const uint64_t, Packet*, const double=0);
 
+    /*!
+     *\brief Drains the observation bus
+     *
+     * Delivers all pending observations to the checkers, each
+     * consuming the batch in one call. Called once per send tick,
+     * once per receive tick as time advances, and before a checker
+     * receives an event, so that checkers state is never observed stale
+     */
+    void drainObservations();
+
     /*!
      * Method to check if a TrafficProfileDescriptor role is a checker
      *\param pId traffic profile id to check
      *\return true is the profile is a checker
      */
     inline bool isChecker(const uint64_t pId) const {
-        return (checkers.count(pId)>0);
+        return (role(pId) == TrafficProfileDescriptor::CHECKER);
     }
 
     /*!
@@ -333,17 +514,57 @@ protected:
      *\return true is the profile is a slave
      */
     inline bool isSlave(const uint64_t pId) const {
-        return (slaves.count(pId)>0);
+        return (role(pId) == TrafficProfileDescriptor::SLAVE);
     }
 
     /*!
-     * Method to check if a Master is internal to ATP
-     * NOTE: this operation involves string hashing,
-     * it is expensive
-     *\param m master name to check
-     *\return true if the master is an internal master
+     * Returns the role of a profile
+     *\param pId traffic profile id
+     *\return the profile role, NONE if not created yet
+     */
+    inline TrafficProfileDescriptor::Role role(const uint64_t pId) const {
+        return (pId < roles.size() ? roles[pId] :
+                TrafficProfileDescriptor::NONE);
+    }
+
+    /*!
+     * Records the role of a profile
+     *\param pId traffic profile id
+     *\param r the profile role
+     */
+    void setRole(const uint64_t, const TrafficProfileDescriptor::Role);
+
+    /*!
+     * Requests a packet to a profile, calling
+     * its concrete type send method
+     *\param p the profile descriptor
+     *\param locked returns true if the profile is locked on waits
+     *\param pkt returns the packet to send
+     *\param next returns the next time a packet will be available
+     *\return true if a packet has been produced by the profile
      */
-    bool isInternalMaster(const string) const;
+    bool profileSend(TrafficProfileDescriptor*, bool&, Packet*&, uint64_t&);
+
+    /*!
+     * Delivers a packet to a profile, calling
+     * its concrete type receive method
+     *\param p the profile descriptor
+     *\param next returns the next time a packet can be received
+     *\param pkt the received packet
+     *\param delay measured request to response delay
+     *\return true if the packet was accepted by the profile
+     */
+    bool profileReceive(TrafficProfileDescriptor*, uint64_t&,
+                        const Packet*, const double);
+
+    /*!
+     * Method to check if a packet was issued by a Master internal to ATP
+     *\param pkt the packet to check
+     *\return true if the packet master is an internal master
+     */
+    inline bool isInternalMaster(const Packet* pkt) const {
+        return isValid(packetMaster(pkt));
+    }
 
     /*!
      * Handles TPM Events
@@ -369,6 +590,16 @@ protected:
      */
     bool route(Packet*&, const uint64_t*, const uint64_t*);
 
+    /*!
+     * Implements the route operation, see route
+     *\param pkt - optionally pass the packet to be routed, the routed packet
+     *          is also returned by reference
+     *\param src source profile ID or nullptr if unknown
+     *\param dst destination profile ID or nullptr if unknown
+     *\return true if the route operation has succeeded
+     */
+    bool routePacket(Packet*&, const uint64_t*, const uint64_t*);
+
     /*!
      * Returns a packets generated by the specified traffic profile
      *\param pkt returned by reference
@@ -402,14 +633,14 @@ protected:
     /*!
      *\brief Profile stream lookup function
      *
-     * Builds a list of profiles navigating a
-     * profile stream, linked by termination
-     * events.
+     * Compiles the profiles of a stream, linked by
+     * termination events, into the stream topology
+     * the first time the stream is looked up.
      * Starts from the provided profile root
      *\param root root profile id
-     *\return stream list reference
+     *\return a view on the compiled stream
      */
-    const list<pair<uint64_t, bool>>& getStream (const uint64_t);
+    StreamTopology::Stream getStream (const uint64_t);
 
     /*!
      * Causes an update of the stream cache
@@ -420,6 +651,9 @@ protected:
     /*!
      *\brief Clones a profile stream and returns a copy of it
      *
+     * Clones share the origin profiles configuration and stream
+     * topology, only their mutable state is allocated: the cost
+     * of a clone is proportional to the stream size only
      *\param root root profile id
      *\param master_id (Optional) Associated Master ID
      *\return the cloned root profile id
@@ -452,11 +686,27 @@ public:
     pair<uint64_t, uint64_t> getTimeScaleFactors(const uint64_t id) const;
 
     /*!
-     * Returns a pointer to given traffic profile index
+     * Returns a pointer to given traffic profile index,
+     * the profile gets instantiated if its creation was deferred
      *\param index the traffic profile index
      *\return a pointer to the corresponding traffic profile
      */
-    TrafficProfileDescriptor* getProfile(const uint64_t) const;
+    TrafficProfileDescriptor* getProfile(const uint64_t);
+
+    /*!
+     * Returns a profile name given its id, without
+     * instantiating deferred profiles
+     *\param pId profile ID
+     *\return the profile name
+     */
+    const string profileName(const uint64_t) const;
+
+    /*!
+     * Returns the number of profiles whose instantiation
+     * is still deferred
+     *\return number of deferred profiles
+     */
+    inline size_t getDeferredProfiles() const { return deferredProfiles.size(); }
 
     /*!
      * Returns a constant reference to the traffic profiles map
@@ -465,10 +715,10 @@ public:
     inline const unordered_map<string, uint64_t>& getProfileMap() const { return profileMap; }
 
     /*!
-     * Returns a constant reference to the Stream Cache map
-     *\return a constant reference to the Stream Cache map
+     * Returns a constant reference to the compiled Stream Topology
+     *\return a constant reference to the Stream Topology
      */
-    inline const map<uint64_t, list<pair<uint64_t,bool>>>& getStreamCache() const { return streamCache; }
+    inline const StreamTopology& getStreamTopology() const { return streamTopology; }
 
     /* Returns whether a master has terminated executing all its configured
      * Traffic Profiles
@@ -485,6 +735,14 @@ public:
      */
     bool load(const string&);
 
+    /*!
+     * Parses a configuration file, e.g. to load it into several TPMs
+     *\param fileName the configuration file name
+     *\param c the parsed configuration
+     *\return true if the file was parsed, false otherwise
+     */
+    static bool parse(const string&, Configuration&);
+
     /*!
      * Looks up a profile id from name
      * if the profile does not exist,
@@ -524,6 +782,23 @@ public:
      */
     const string& masterName(const uint64_t) const;
 
+    /*!
+     * Returns the ID of the master which issued a packet: the interned
+     * ID carried by packets of internal masters, otherwise the ID
+     * registered for the packet master name.
+     * NOTE: only packets entering the engine involve string hashing
+     *\param pkt the packet
+     *\return the master ID, or an invalid ID for external masters
+     */
+    uint64_t packetMaster(const Packet*) const;
+
+    /*!
+     * Returns the name of the master which issued a packet
+     *\param pkt the packet
+     *\return the master name
+     */
+    const string& packetMasterName(const Packet*) const;
+
     /*!
      * Signals the TPM that a Profile is waiting for an UID
      *\param profile the profile ID
@@ -543,6 +818,14 @@ public:
     void signal(const uint64_t, const uint64_t,
             const PacketType);
 
+    /*!
+     * Returns the subscribers of an event source,
+     * growing the dispatch table if needed
+     *\param id the event source ID
+     *\return a reference to the event source subscribers
+     */
+    Subscribers& subscribers(const uint64_t);
+
     /*!
      * Allows a Traffic Profile to subscribe to a specific event
      *\param profile the profile ID
@@ -648,6 +931,22 @@ public:
      */
     const Stats getMasterStats(const string&);
 
+    /*!
+     * getter method to access the combined statistics of all ATP
+     * masters profiles, excluding checkers and slaves
+     *\return a constant stats data structure
+     */
+    const Stats getMastersStats() const;
+
+    /*!
+     * Estimates the bandwidth and latency each ATP master achieves
+     * with the loaded configuration, through an analytical model of
+     * the masters FIFOs, their slaves and the profiles dependencies,
+     * without simulating any packet
+     *\return master name -> estimated performance
+     */
+    map<string, AnalyticalModel::Estimate> estimate() const;
+
     /*!
      * getter method to access an ATP profile statistics
      *\param p the profile name
@@ -655,6 +954,27 @@ public:
      */
     const Stats getProfileStats(const string&);
 
+    /*!
+     * getter method to access the ATP checkers QoS envelopes
+     *\return checker name -> QoS envelope, for checkers
+     *        with a QoS configuration
+     */
+    const map<string, const QosEnvelope*> getQosEnvelopes() const;
+
+    /*!
+     * getter method to access the ATP masters rate controllers
+     *\return master profile name -> rate controller, for masters
+     *        with a rate control configuration
+     */
+    const map<string, const RateController*> getRateControllers() const;
+
+    /*!
+     * Computes the load offered by the ATP Masters, as the sum of
+     * their current FIFO rates (unlimited rates are not accounted)
+     *\return the offered load in bytes per second
+     */
+    double getOfferedLoad() const;
+
     /*!
      * method to query whether the TPM is waiting for responses
      *\return true if the TPM is waiting for responses, false otherwise
@@ -685,6 +1005,174 @@ public:
      */
     inline void enableTrackerLatency() {trackerLatency=true;}
 
+    /*!
+     * API to enable lazy profiles instantiation: profiles waiting
+     * for other profiles termination get instantiated on first activation
+     * (takes effect on profiles loaded from now on)
+     */
+    inline void enableLazyProfiles() {lazyProfiles=true;}
+
+    /*!
+     * API to disable lazy profiles instantiation
+     * (takes effect on profiles loaded from now on)
+     */
+    inline void disableLazyProfiles() {lazyProfiles=false;}
+
+    /*!
+     * method to check lazy profiles instantiation status
+     *\return value of lazyProfiles enable flag
+     */
+    inline const bool& isLazyProfiles() const { return lazyProfiles;}
+
+    /*!
+     * API to scale the offered load: multiplies the configured
+     * FIFO rate of all ATP Masters by a factor
+     * (takes effect on profiles loaded from now on,
+     * including the ones reloaded by reset)
+     *\param s the scale factor
+     */
+    inline void setRateScale(const double s) { rateScale=s;}
+
+    /*!
+     * method to access the offered load scale factor
+     *\return the ATP Masters FIFO rate scale factor
+     */
+    inline double getRateScale() const { return rateScale;}
+
+    /*!
+     * API to scale the offered load at runtime: multiplies the current
+     * FIFO rate of all instantiated ATP Masters by a factor, and the
+     * rate scale of the ones instantiated from now on
+     *\param s the scale factor
+     */
+    void scaleRates(const double);
+
+    /*!
+     * API to enable the global and the ATP Masters response latency
+     * histograms, which provide latency percentiles in their stats
+     */
+    void enableLatencyHistogram();
+
+    /*!
+     * API to enable the engine self-profiler, which measures
+     * the time the engine spends in its hot paths
+     */
+    inline void enableEngineProfile() { profiler.enable();}
+
+    /*!
+     * API to disable the engine self-profiler
+     * (recorded measurements are retained)
+     */
+    inline void disableEngineProfile() { profiler.disable();}
+
+    /*!
+     * method to access the engine self-profiler
+     *\return the engine self-profiler
+     */
+    inline EngineProfiler& getEngineProfiler() { return profiler;}
+
+    /*!
+     * Returns the engine self-profiler measurements,
+     * aggregated per profile role and per profile
+     *\return the engine profile report
+     */
+    EngineProfiler::Report getEngineProfile() const;
+
+    /*!
+     * API to start recording the engine activity timeline
+     *\param file the binary timeline file name
+     */
+    inline void enableTimeline(const string& file) { timeline.open(file);}
+
+    /*!
+     * API to stop recording the engine activity timeline,
+     * closing the binary timeline file
+     */
+    inline void disableTimeline() { timeline.close();}
+
+    /*!
+     * method to access the engine activity timeline recorder
+     *\return the timeline recorder
+     */
+    inline const TimelineRecorder& getTimeline() const { return timeline;}
+
+    /*!
+     * API to enable the engine time fast-forward, which advances
+     * periodic deterministic regimes in bulk with identical results
+     */
+    inline void enableFastForward() { fastForward.enable();}
+
+    /*!
+     * API to disable the engine time fast-forward
+     */
+    inline void disableFastForward() { fastForward.disable();}
+
+    /*!
+     * method to access the engine time fast-forward
+     *\return the engine time fast-forward
+     */
+    inline const FastForward& getFastForward() const { return fastForward;}
+
+    /*!
+     * API to enable statistical sampling, which alternates detailed
+     * measurement windows with extrapolated intervals, and takes
+     * precedence over fast-forward
+     *\param window measurement window length, in ATP time units
+     *\param interval skipped interval length, in ATP time units
+     *\param warming detailed warming length before each window
+     *\param confidence confidence level of the reported bounds
+     */
+    inline void enableSampling(const uint64_t window, const uint64_t interval,
+            const uint64_t warming = 0,
+            const double confidence = Sampler::defaultConfidence) {
+        sampler.enable(window, interval, warming, confidence);
+    }
+
+    /*!
+     * API to disable statistical sampling
+     */
+    inline void disableSampling() { sampler.disable();}
+
+    /*!
+     * method to access the engine statistical sampling
+     *\return the engine sampler
+     */
+    inline const Sampler& getSampler() const { return sampler;}
+
+    /*!
+     * Returns the number of events delivered to subscribed profiles
+     * so far, which change their event state
+     *\return the number of dispatched events
+     */
+    inline uint64_t getDispatchedEvents() const { return dispatched;}
+
+    /*!
+     * Walks the whole engine state for fast-forward. Packet
+     * tracing, timeline recording, engine self-profiling and
+     * checkers need every event and are not eligible
+     *\param w the state walker
+     */
+    void walk(StateWalker&);
+
+    /*!
+     * Saves the whole engine runtime state (time, profiles FIFOs,
+     * address generators, random generators, outstanding transactions,
+     * in-flight packets, Kronos calendar, slaves responses and stats)
+     * to a compact binary snapshot
+     *\return the binary snapshot
+     */
+    string saveSnapshot();
+
+    /*!
+     * Restores the engine runtime state from a binary snapshot. The
+     * engine must be loaded with the configuration the snapshot was
+     * saved from. A failed restore rolls the engine back to its state
+     * before the call
+     *\param data the binary snapshot
+     *\return true if restored, false if malformed or not matching
+     */
+    bool restoreSnapshot(const string&);
+
     /*!
      * method to check UID routing status
      *\return value of the UID routing enable flag
@@ -701,6 +1189,12 @@ public:
      */
     inline const bool& isProfilesAsMasters() const { return profilesAsMasters;}
 
+    /*!
+     * Getter for the ATP Masters latency histogram enable flag
+     *\return value of the latencyHistogram enable flag
+     */
+    inline bool isLatencyHistogramEnabled() const { return latencyHistogram;}
+
     /*!
      * method to check ATP tracker latency status
      *\return value of trackerLatency enable flag
@@ -802,6 +1296,15 @@ public:
      */
     void loop();
 
+    /*!
+     * Runs the main event loop up to a given time, suspending it
+     * before the first event past that time: loop and loopUntil
+     * resume a suspended loop exactly where it stopped
+     *\param t the ATP time to suspend the loop after
+     *\return true if the loop was suspended, false if it completed
+     */
+    bool loopUntil(const uint64_t);
+
     /*!
      *\brief Profile stream reconfiguration
      *
@@ -833,9 +1336,9 @@ public:
     /*!
      *\brief Checks if a profiles stream is terminated
      *
-     * Traverses a profiles stream hierarchy and returns
-     * true only if all profiles of the stream have
-     * terminated
+     * Returns true only if all leaf profiles of the
+     * stream have terminated, as tracked by the
+     * stream topology termination counters
      *\param root stream root profile id
      *\return true if the stream has terminated,
      *  false otherwise
@@ -12,6 +12,8 @@
 #include "traffic_profile_checker.hh"
 #include "types.hh"
 #include "utilities.hh"
+#include "fast_forward.hh"
+#include "snapshot.hh"
 
 namespace TrafficProfiles {
 
@@ -21,7 +23,7 @@ TrafficProfileMaster::TrafficProfileMaster(TrafficProfileManager* manager,
         toSend(0), toStop(0), maxOt(1),
         sent(0), pending(nullptr),
         checkersFifoStarted(false),
-        halted (false) {
+        halted (false), maxBurst(0), burstResidual(0) {
 
         // Configure the packet descriptor
         if (p->has_pattern()) {
@@ -67,10 +69,40 @@ TrafficProfileMaster::TrafficProfileMaster(TrafficProfileManager* manager,
             // Initialise the FIFO
             fifo.init(this, type, &p->fifo(),
                     manager->isTrackerLatencyEnabled());
+            // scale the FIFO rate to the offered load
+            scaleFifoRate(manager->getRateScale());
+            // Initialise the FIFO rate controller
+            if (p->fifo().has_rate_control()) {
+                rateController.init(this, &p->fifo(), fifo.getRate());
+            }
+            // Initialise the steady-state convergence monitor
+            if (p->fifo().has_convergence()) {
+                convergence.init(this, &p->fifo());
+                stats.convergence = Stats::MONITORED;
+            }
         } else {
             ERROR("TrafficProfileMaster [", this->name,
                     "] FIFO configuration not found");
         }
+
+        // enable burst coalescing of contiguous packets
+        if (p->fifo().max_burst() > 0) {
+            if (!packetDesc.isContiguous()) {
+                WARN("TrafficProfileMaster [", this->name,
+                        "] burst coalescing requires configured sizes and "
+                        "addresses incremented by the packet size, disabled");
+            } else if (p->fifo().max_burst() < packetDesc.getPacketSize()) {
+                WARN("TrafficProfileMaster [", this->name,
+                        "] max burst", p->fifo().max_burst(),
+                        "is smaller than the packet size, disabled");
+            } else {
+                maxBurst = p->fifo().max_burst();
+            }
+        }
+        // record latency percentiles if requested
+        if (manager->isLatencyHistogramEnabled()) {
+            stats.enableLatencyHistogram();
+        }
         // set role
         role = MASTER;
 
@@ -80,7 +112,8 @@ TrafficProfileMaster::TrafficProfileMaster(TrafficProfileManager* manager,
         }
         LOG("TrafficProfileMaster::TrafficProfileMaster [", this->name,
                     "] initialised profile type", Profile::Type_Name(type),
-                    "to send", toSend, "to stop", toStop, "max OT", maxOt);
+                    "to send", toSend, "to stop", toStop, "max OT", maxOt,
+                    "max burst", maxBurst);
 }
 
 TrafficProfileMaster::~TrafficProfileMaster() {
@@ -90,18 +123,41 @@ TrafficProfileMaster::~TrafficProfileMaster() {
     }
 }
 
+void TrafficProfileMaster::scaleFifoRate(const double scale) {
+    const auto r = fifo.getRate();
+    if (scale == 1 || r.first == 0 || r.second == 0) {
+        return;
+    }
+    if (rateController.isEnabled()) {
+        WARN("TrafficProfileMaster::scaleFifoRate [", this->name,
+             "] rate is controlled, not scaling it");
+        return;
+    }
+    // keep three decimal digits of the scale factor
+    fifo.setRate(Utilities::reduce<uint64_t>(
+            llround(r.first * scale * 1000), r.second * 1000));
+}
+
 void TrafficProfileMaster::reset() {
     TrafficProfileDescriptor::reset();
     LOG("TrafficProfileMaster::reset "
             "[", this->name, "] requested reset");
     // reset the FIFO
     fifo.reset();
+    // restore the FIFO initial rate
+    if (rateController.isEnabled()) {
+        rateController.reset();
+        fifo.setRate(rateController.getFifoRate());
+    }
+    convergence.reset();
     // reset the packet descriptor
     packetDesc.reset();
     // reset sent packets
     sent = 0;
+    burstResidual = 0;
     // delete any pending packet
-    if (pending!=nullptr) delete pending;
+    delete pending;
+    pending = nullptr;
     halted = false;
     // reset all assigned checkers
     checkersFifoStarted = false;
@@ -152,6 +208,23 @@ bool TrafficProfileMaster::receiveEvent(const Event& e) {
     return ok || fifoOk;
 }
 
+uint64_t TrafficProfileMaster::coalesce(bool& underrun, bool& overrun,
+                                        const uint64_t t) {
+    const uint64_t size = packetDesc.getPacketSize();
+    uint64_t n = maxBurst / size;
+    if (toSend > 0) {
+        n = min(n, toSend - sent);
+    }
+    // each packet in the burst holds an outstanding transaction
+    if (maxOt > 0 && packetDesc.waitingFor() != Command::NONE) {
+        n = min(n, maxOt - ot);
+    }
+    if (n > 1) {
+        n = min(n, fifo.room(underrun, overrun, t) / size);
+    }
+    return (n > 1 ? packetDesc.coalesce(pending, n) : 1);
+}
+
 bool TrafficProfileMaster::send(bool& locked, Packet*& p, uint64_t& next) {
     // get current time
     const uint64_t& t = tpm->getTime();
@@ -165,6 +238,8 @@ bool TrafficProfileMaster::send(bool& locked, Packet*& p, uint64_t& next) {
     if (active(locked)) {
         bool underrun = false, overrun = false;
         uint64_t request_time = 0;
+        // packets held by the transmitted request
+        uint64_t packets = 1;
 
         // check if there's a packet pending
         if (pending == nullptr) {
@@ -181,10 +256,14 @@ bool TrafficProfileMaster::send(bool& locked, Packet*& p, uint64_t& next) {
         }
         // if there's a pending packet, check if it can be send
         if (pending != nullptr) {
+            // merge it with the next contiguous packets
+            if (maxBurst > 0) {
+                packets = coalesce(underrun, overrun, t);
+            }
             // check FIFO space
             if (fifo.send(underrun, overrun, next, request_time, t, pending->size())) {
                 // tag packet with masterId, streamId and masterIommuId
-                pending->set_master_id(masterName);
+                pending->set_master_ref(masterId);
                 // request TPM to tag this packet
                 tpm->tag(pending);
                 // request Packet Tagger to tag this packet with profile metadata
@@ -194,7 +273,7 @@ bool TrafficProfileMaster::send(bool& locked, Packet*& p, uint64_t& next) {
 
                 // update number of outstanding transaction if needed
                 if (packetDesc.waitingFor() != Command::NONE) {
-                    ot++;
+                    ot += packets;
                     // wait for this address/command - pass time here.
                     wait(request_time,  pending->uid(),
                             pending->addr(), pending->size());
@@ -245,13 +324,23 @@ bool TrafficProfileMaster::send(bool& locked, Packet*& p, uint64_t& next) {
         // if a packet has been sent/recorded
         if (p!=nullptr) {
             // update number of transactions sent
-            sent++;
-            // update statistics
-            stats.send(t, p->size(), ot);
+            sent += packets;
             if ((sent > toSend) && (toSend > 0)) {
                 ERROR("TrafficProfileMaster::send [", this->name,
                     "] max send threshold",toSend," breached:",sent);
             }
+            // account bursts packet by packet
+            const uint64_t size = p->size() / packets;
+            const bool waits = (packetDesc.waitingFor() != Command::NONE);
+            for (uint64_t i = 1; i <= packets; ++i) {
+                const uint64_t packetOt = (waits ? ot - packets + i : ot);
+                // update statistics
+                stats.send(t, size, packetOt);
+                // adjust the FIFO rate if a control period ended
+                if (rateController.send(t, size, packetOt)) {
+                    fifo.setRate(rateController.getFifoRate());
+                }
+            }
         }
         else {
             // start statistics if needed
@@ -293,20 +382,47 @@ bool TrafficProfileMaster::receive(
     if (packetDesc.receive(t, packet)) {
         // update FIFO
         whole = fifo.receive(underrun, overrun, t, packet->size());
-        // update statistics
-        stats.receive(t, packet->size(), delay);
+        // bursts responses complete one transaction per packet
+        uint64_t completed = (whole ? 1 : 0);
+        uint64_t chunk = packet->size();
+        if (maxBurst > 0) {
+            chunk = packetDesc.getPacketSize();
+            burstResidual += packet->size();
+            completed = burstResidual / chunk;
+            burstResidual %= chunk;
+        }
         // reduce number of outstanding transactions
-        if (whole) {
-            if (0 == ot) {
+        if (completed > 0) {
+            if (completed > ot) {
             ERROR("TrafficProfileMaster::receive [", this->name,
                     "] address ", Utilities::toHex(packet->addr()),
                     "negative OT detected at time", t, "stats",
                     stats.dump());
             }
-            ot--;
+            ot -= completed;
+        }
+        if (whole) {
             // signal reception
             signal(packet->uid(), packet->addr(), packet->size());
         }
+        // account bursts packet by packet
+        uint64_t left = packet->size();
+        do {
+            const uint64_t size = min(left, chunk);
+            left -= size;
+            // update statistics
+            stats.receive(t, size, delay);
+            // adjust the FIFO rate if a control period ended
+            if (rateController.receive(t, delay)) {
+                fifo.setRate(rateController.getFifoRate());
+            }
+            // flag the statistics once in steady state
+            if (convergence.receive(t, size, delay)) {
+                stats.convergence = Stats::CONVERGED;
+                LOG("TrafficProfileMaster::receive [", this->name,
+                        "] converged at time", t);
+            }
+        } while (left > 0);
         LOG("TrafficProfileMaster::receive [", this->name, "] address",
                 Utilities::toHex(packet->addr()), "received packet at time", t,
                 "with latency",delay,"current ot", ot);
@@ -368,7 +484,9 @@ bool TrafficProfileMaster::active(bool& l) {
 
     // if a profile has sent all its data but it's waiting for responses is locked,
     // this condition prevents termination (toSend == 0 means infinite data to send)
-    const bool endOfData = (sent == toSend) && (toSend > 0);
+    // a converged profile stops sending, as if it had no more data to send
+    const bool endOfData = ((sent == toSend) && (toSend > 0)) ||
+            convergence.stop();
     const bool endOfTime = started && ((toStop > 0) && (tpm->getTime() >= startTime+toStop));
     const bool waitingForResponses = (endOfData || endOfTime) && (ot > 0);
     LOG("TrafficProfileMaster::active [", name, "] started:",started,
@@ -418,5 +536,45 @@ bool TrafficProfileMaster::active(bool& l) {
     return isActive;
 }
 
+void TrafficProfileMaster::walk(StateWalker& w) {
+    if (rateController.isEnabled() || convergence.isEnabled()) {
+        w.reject();
+        return;
+    }
+    TrafficProfileDescriptor::walk(w);
+    w(toSend);
+    w(toStop);
+    w(maxOt);
+    w(sent, StateWalker::LINEAR);
+    if (toSend > 0) {
+        w.bound(0, toSend);
+    }
+    w(burstResidual);
+    if (toStop > 0 && started) {
+        w.deadline(startTime + toStop);
+    }
+    fifo.walk(w);
+    bool hasPending = (pending != nullptr);
+    w(hasPending);
+    if (hasPending) {
+        w(*pending);
+    }
+    w(checkersFifoStarted);
+    w(halted);
+    packetDesc.walk(w);
+}
+
+void TrafficProfileMaster::serialize(Snapshot& s) {
+    TrafficProfileDescriptor::serialize(s);
+    s(sent);
+    s(burstResidual);
+    s(pending);
+    s(checkersFifoStarted);
+    s(halted);
+    rateController.serialize(s);
+    convergence.serialize(s);
+    fifo.serialize(s);
+    packetDesc.serialize(s);
+}
 
 } /* namespace TrafficProfiles */
@@ -12,6 +12,8 @@
 
 #include "traffic_profile_desc.hh"
 #include "fifo.hh"
+#include "rate_controller.hh"
+#include "convergence_monitor.hh"
 
 namespace TrafficProfiles {
 
@@ -21,7 +23,7 @@ namespace TrafficProfiles {
  * Master Profile Descriptor: tracks the status of an active Profile in terms
  * of FIFO fill level, outstanding transactions
  */
-class TrafficProfileMaster: public TrafficProfileDescriptor {
+class TrafficProfileMaster final : public TrafficProfileDescriptor {
 
 protected:
     //! Configured total number of transactions to send
@@ -42,6 +44,24 @@ protected:
     bool halted;
     //! AMBA TP Packet Descriptor
     PacketDesc packetDesc;
+    //! closed-loop FIFO rate controller
+    RateController rateController;
+    //! steady-state convergence monitor
+    ConvergenceMonitor convergence;
+    //! maximum burst size in bytes, 0 if coalescing is disabled
+    uint64_t maxBurst;
+    //! response bytes received for the oldest outstanding burst packet
+    uint64_t burstResidual;
+
+    /*!
+     * Coalesces the pending packet with the next contiguous ones,
+     * within the FIFO room, the OT limit and the data left to send
+     *\param underrun flag that signals a FIFO underrun occurred
+     *\param overrun flag that signals a FIFO overrun occurred
+     *\param t the current time
+     *\return the number of packets the pending burst holds
+     */
+    uint64_t coalesce(bool&, bool&, const uint64_t);
 
 public:
 
@@ -161,6 +181,44 @@ public:
     /*! Returns the FIFO level */
     uint64_t getFifoLevel() const { return fifo.getLevel(); }
 
+    /*! Returns the FIFO rate: bytes every period ATP time units */
+    pair<uint64_t,uint64_t> getFifoRate() const { return fifo.getRate(); }
+
+    /*!
+     * Scales the FIFO rate, keeping three decimal digits of the
+     * scale factor. Unlimited and controlled rates are not scaled
+     *\param scale the scale factor
+     */
+    void scaleFifoRate(const double);
+
+    //! returns this master closed-loop rate controller
+    inline const RateController& getRateController() const {
+        return rateController;
+    }
+
+    //! returns the maximum burst size in bytes, 0 if not coalescing
+    inline uint64_t getMaxBurst() const { return maxBurst; }
+
+    //! returns this master steady-state convergence monitor
+    inline const ConvergenceMonitor& getConvergenceMonitor() const {
+        return convergence;
+    }
+
+    /*!
+     * Walks the profile state for fast-forward,
+     * closed-loop rate control and convergence monitoring
+     * are not eligible
+     *\param w the state walker
+     */
+    virtual void walk(StateWalker&);
+
+    /*!
+     * Saves or restores the profile runtime state, including
+     * the pending packet and the controlled rate
+     *\param s the snapshot
+     */
+    virtual void serialize(Snapshot&);
+
     /*!
      * Resets this profile
      */
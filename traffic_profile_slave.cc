@@ -10,6 +10,8 @@
 #include "traffic_profile_manager.hh"
 #include "traffic_profile_slave.hh"
 #include "utilities.hh"
+#include "fast_forward.hh"
+#include "snapshot.hh"
 
 namespace TrafficProfiles {
 
@@ -20,6 +22,8 @@ TrafficProfileSlave::TrafficProfileSlave(TrafficProfileManager* manager,
                 maxOt(1),
                 width(64) {
     role = SLAVE;
+    // slaves are not assigned to a master, they tag packets with their name
+    masterName = name;
 
     // configure the slave latency response
     if (p->slave().has_latency()) {
@@ -226,5 +230,56 @@ TrafficProfileSlave::active(bool& l) {
     return !l;
 }
 
+double TrafficProfileSlave::getMeanLatency() const {
+    return (latencyType == CONFIGURED ? staticLatency :
+            random.latency.mean() * random.latencyUnit);
+}
+
+void TrafficProfileSlave::setBandwidth(const string& rate) {
+    bandwidth = parseRate(rate);
+    fifo.setRate(bandwidth);
+    LOG("TrafficProfileSlave::setBandwidth [", this->name, "] bandwidth",
+            rate, "at time", tpm->getTime());
+}
+
+void TrafficProfileSlave::setLatency(const string& latency) {
+    if (latencyType == RANDOM) {
+        WARN("TrafficProfileSlave::setLatency [", this->name,
+             "] has a random latency, not changing it");
+        return;
+    }
+    staticLatency = parseTime(latency);
+    LOG("TrafficProfileSlave::setLatency [", this->name, "] latency",
+            staticLatency, "at time", tpm->getTime());
+}
+
+void TrafficProfileSlave::walk(StateWalker& w) {
+    if (latencyType == RANDOM && w.isExact()) {
+        w.reject();
+        return;
+    }
+    TrafficProfileDescriptor::walk(w);
+    w(maxOt);
+    fifo.walk(w);
+    w.size(responses);
+    for (auto* r : responses) {
+        w(*r);
+    }
+}
+
+void TrafficProfileSlave::serialize(Snapshot& s) {
+    TrafficProfileDescriptor::serialize(s);
+    if (latencyType == RANDOM) {
+        random.latency.serialize(s);
+    }
+    fifo.serialize(s);
+    if (s.restoring()) {
+        for (auto* r : responses) {
+            delete r;
+        }
+        responses.clear();
+    }
+    s(responses);
+}
 
 } /* namespace TrafficProfiles */
@@ -25,7 +25,7 @@ namespace TrafficProfiles {
  * Profiles. When all masters are registered to at least
  * one ATP slave, ATP can be run in standalone mode.
  */
-class TrafficProfileSlave : public TrafficProfileDescriptor {
+class TrafficProfileSlave final : public TrafficProfileDescriptor {
 protected:
     //! type for response latency generation method
     enum Type {
@@ -33,7 +33,7 @@ protected:
     };
 
     //! Memory bandwidth pair multiplier and bytes per ATP time unit
-    const pair<uint64_t, uint64_t> bandwidth;
+    pair<uint64_t, uint64_t> bandwidth;
     //! Maximum outstanding transactions limit
     uint64_t maxOt;
     /*!\brief Width of the slave memory
@@ -157,6 +157,27 @@ public:
       */
      inline const uint64_t& getLatency() const {return staticLatency;}
 
+     /*!
+      * Gets the slave average latency, either the configured
+      * one or the mean of the random latencies
+      *\return the average latency in ATP time units
+      */
+     double getMeanLatency() const;
+
+     /*!
+      * Changes the slave bandwidth at runtime
+      *\param rate the new bandwidth, e.g. 32GB/s
+      */
+     void setBandwidth(const string&);
+
+     /*!
+      * Changes the slave constant latency at runtime: queued
+      * responses keep their response time. Slaves with
+      * random latencies are not changed
+      *\param latency the new latency, e.g. 80ns
+      */
+     void setLatency(const string&);
+
      /*!
       * Gets the slave configured width
       *\return constant reference to the slave configured width in bytes
@@ -175,10 +196,19 @@ public:
       */
      virtual inline uint64_t nextResponseTime() const {return responses.empty()?0:responses.front()->time();}
 
-     /*! getter method for this Traffic Profile master name
-      *\return the Slave traffic profile name
+     /*!
+      * Walks the profile state for fast-forward,
+      * random latencies are not eligible
+      *\param w the state walker
+      */
+     virtual void walk(StateWalker&);
+
+     /*!
+      * Saves or restores the profile runtime state, including
+      * the queued responses
+      *\param s the snapshot
       */
-     virtual inline const string& getMasterName() const {return name;}
+     virtual void serialize(Snapshot&);
 
      /*!
       * Resets this profile